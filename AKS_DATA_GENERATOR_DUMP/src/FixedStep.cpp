@@ -0,0 +1,43 @@
+#include "FixedStep.h"
+
+FixedStep::FixedStep(uint32_t periodUs, uint8_t maxCatchUp)
+    : period(periodUs ? periodUs : 1), maxCatchUp(maxCatchUp ? maxCatchUp : 1) {
+}
+
+void FixedStep::reset(uint32_t nowUs) {
+    lastUs = nowUs;
+    accumulatorUs = 0;
+    started = true;
+}
+
+void FixedStep::setPeriod(uint32_t periodUs) {
+    if (periodUs == 0) periodUs = 1;
+    if (periodUs == period) return;
+    period = periodUs;
+    // Keep the phase but never owe more than one new period
+    if (accumulatorUs > period) accumulatorUs = period;
+}
+
+uint8_t FixedStep::due(uint32_t nowUs) {
+    if (!started) {
+        reset(nowUs);
+        return 0;
+    }
+
+    // Unsigned difference survives the micros() wrap
+    accumulatorUs += nowUs - lastUs;
+    lastUs = nowUs;
+
+    uint32_t pending = accumulatorUs / period;
+    if (pending > maxCatchUp) {
+        overrunCount++;
+        droppedCount += pending - maxCatchUp;
+        accumulatorUs %= period;
+        pending = maxCatchUp;
+    } else {
+        accumulatorUs -= pending * period;
+    }
+
+    stepCount += pending;
+    return (uint8_t)pending;
+}
@@ -0,0 +1,40 @@
+/*
+ * AKS Data Generator - fixed-timestep clock
+ * Accumulates elapsed real time and hands out whole steps of a fixed
+ * period, so the work driven by it always advances by the same dt no
+ * matter how late the loop gets round to it. When the backlog grows past
+ * maxCatchUp steps the excess is dropped and counted as an overrun rather
+ * than run in a burst that would only make the next pass later still.
+ */
+
+#ifndef FIXED_STEP_H
+#define FIXED_STEP_H
+
+#include <Arduino.h>
+
+class FixedStep {
+public:
+    FixedStep(uint32_t periodUs, uint8_t maxCatchUp);
+
+    // Number of steps due at nowUs, at most maxCatchUp
+    uint8_t due(uint32_t nowUs);
+    void setPeriod(uint32_t periodUs);
+    void reset(uint32_t nowUs);
+
+    uint32_t periodUs() const { return period; }
+    uint32_t steps() const { return stepCount; }
+    uint32_t overruns() const { return overrunCount; }       // passes that hit the clamp
+    uint32_t droppedSteps() const { return droppedCount; }   // steps skipped by the clamp
+
+private:
+    uint32_t period;
+    uint8_t maxCatchUp;
+    uint32_t lastUs = 0;
+    uint32_t accumulatorUs = 0;
+    bool started = false;
+    uint32_t stepCount = 0;
+    uint32_t overrunCount = 0;
+    uint32_t droppedCount = 0;
+};
+
+#endif
@@ -0,0 +1,240 @@
+#include "I2cSlave.h"
+
+static I2cReadHandler readHandler = NULL;
+static I2cReadDoneHandler readDoneHandler = NULL;
+static I2cWriteHandler writeHandler = NULL;
+static volatile I2cSlaveStats slaveStats = {0, 0, 0};
+
+// DWT cycle counter, used to time interrupt code
+static void startCycleCounter() {
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+void i2cSlaveGetStats(I2cSlaveStats &stats) {
+    noInterrupts();
+    stats.transactions = slaveStats.transactions;
+    stats.isrCycles = slaveStats.isrCycles;
+    stats.errors = slaveStats.errors;
+    interrupts();
+}
+
+#if I2C_TRANSPORT == I2C_TRANSPORT_DMA
+
+static I2C_HandleTypeDef i2cHandle;
+static DMA_HandleTypeDef dmaTxHandle;
+static uint8_t rxBuffer[I2C_SLAVE_RX_MAX];
+static volatile size_t rxLength = 0;
+static volatile bool rxActive = false;
+static volatile bool txActive = false;
+
+const char *i2cSlaveTransportName() {
+    return "DMA";
+}
+
+bool i2cSlaveBegin(uint8_t address, I2cReadHandler onRead,
+                   I2cReadDoneHandler onReadDone, I2cWriteHandler onWrite) {
+    readHandler = onRead;
+    readDoneHandler = onReadDone;
+    writeHandler = onWrite;
+    startCycleCounter();
+
+    __HAL_RCC_GPIOB_CLK_ENABLE();
+    __HAL_RCC_I2C1_CLK_ENABLE();
+    __HAL_RCC_DMA1_CLK_ENABLE();
+
+    // PB6 = I2C1_SCL, PB7 = I2C1_SDA
+    GPIO_InitTypeDef gpio = {};
+    gpio.Pin = GPIO_PIN_6 | GPIO_PIN_7;
+    gpio.Mode = GPIO_MODE_AF_OD;
+    gpio.Pull = GPIO_PULLUP;
+    gpio.Speed = GPIO_SPEED_FREQ_VERY_HIGH;
+    gpio.Alternate = GPIO_AF4_I2C1;
+    HAL_GPIO_Init(GPIOB, &gpio);
+
+    // I2C1_TX request: DMA1 Stream 6, channel 1
+    dmaTxHandle.Instance = DMA1_Stream6;
+    dmaTxHandle.Init.Channel = DMA_CHANNEL_1;
+    dmaTxHandle.Init.Direction = DMA_MEMORY_TO_PERIPH;
+    dmaTxHandle.Init.PeriphInc = DMA_PINC_DISABLE;
+    dmaTxHandle.Init.MemInc = DMA_MINC_ENABLE;
+    dmaTxHandle.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+    dmaTxHandle.Init.MemDataAlignment = DMA_MDATAALIGN_BYTE;
+    dmaTxHandle.Init.Mode = DMA_NORMAL;
+    dmaTxHandle.Init.Priority = DMA_PRIORITY_HIGH;
+    dmaTxHandle.Init.FIFOMode = DMA_FIFOMODE_DISABLE;
+    if (HAL_DMA_Init(&dmaTxHandle) != HAL_OK) return false;
+    __HAL_LINKDMA(&i2cHandle, hdmatx, dmaTxHandle);
+
+    // ClockSpeed only sets the peripheral's timing; the master drives SCL.
+    // Above 400 kHz the peripheral is out of spec and relies on stretching.
+    i2cHandle.Instance = I2C1;
+    i2cHandle.Init.ClockSpeed = I2C_BUS_HZ > 400000 ? 400000 : I2C_BUS_HZ;
+    i2cHandle.Init.DutyCycle = I2C_DUTYCYCLE_16_9;
+    i2cHandle.Init.OwnAddress1 = address << 1;
+    i2cHandle.Init.AddressingMode = I2C_ADDRESSINGMODE_7BIT;
+    i2cHandle.Init.DualAddressMode = I2C_DUALADDRESS_DISABLE;
+    i2cHandle.Init.OwnAddress2 = 0;
+    i2cHandle.Init.GeneralCallMode = I2C_GENERALCALL_DISABLE;
+    i2cHandle.Init.NoStretchMode = I2C_NOSTRETCH_DISABLE;
+    if (HAL_I2C_Init(&i2cHandle) != HAL_OK) return false;
+
+    HAL_NVIC_SetPriority(I2C1_EV_IRQn, 1, 0);
+    HAL_NVIC_EnableIRQ(I2C1_EV_IRQn);
+    HAL_NVIC_SetPriority(I2C1_ER_IRQn, 1, 0);
+    HAL_NVIC_EnableIRQ(I2C1_ER_IRQn);
+    HAL_NVIC_SetPriority(DMA1_Stream6_IRQn, 2, 0);
+    HAL_NVIC_EnableIRQ(DMA1_Stream6_IRQn);
+
+    return HAL_I2C_EnableListen_IT(&i2cHandle) == HAL_OK;
+}
+
+// Hands a finished write to the application
+static void deliverWrite() {
+    if (rxActive && rxLength > 0 && writeHandler) {
+        writeHandler(rxBuffer, rxLength);
+    }
+    rxActive = false;
+    rxLength = 0;
+}
+
+// Ends the current transaction; safe to call more than once
+static void finishTransaction() {
+    bool completed = rxActive || txActive;
+    deliverWrite();
+    if (txActive) {
+        txActive = false;
+        if (readDoneHandler) readDoneHandler();
+    }
+    if (completed) slaveStats.transactions++;
+}
+
+static void relisten(I2C_HandleTypeDef *hi2c) {
+    if (HAL_I2C_GetState(hi2c) == HAL_I2C_STATE_READY) {
+        HAL_I2C_EnableListen_IT(hi2c);
+    }
+}
+
+extern "C" void HAL_I2C_AddrCallback(I2C_HandleTypeDef *hi2c, uint8_t TransferDirection, uint16_t AddrMatchCode) {
+    (void)AddrMatchCode;
+
+    if (TransferDirection == I2C_DIRECTION_TRANSMIT) {
+        // Master writes: collect bytes one at a time until STOP or restart
+        rxActive = true;
+        rxLength = 0;
+        HAL_I2C_Slave_Seq_Receive_IT(hi2c, rxBuffer, 1, I2C_NEXT_FRAME);
+        return;
+    }
+
+    // Master reads, usually after a register write and a repeated start
+    if (rxActive) {
+        deliverWrite();
+        slaveStats.transactions++;
+    }
+
+    const uint8_t *data = NULL;
+    size_t length = 0;
+    if (readHandler) readHandler(&data, &length);
+    if (!data || length == 0) {
+        static const uint8_t idle = 0xFF;
+        data = &idle;
+        length = 1;
+    }
+    txActive = true;
+    HAL_I2C_Slave_Seq_Transmit_DMA(hi2c, (uint8_t *)data, length, I2C_LAST_FRAME);
+}
+
+extern "C" void HAL_I2C_SlaveRxCpltCallback(I2C_HandleTypeDef *hi2c) {
+    rxLength++;
+    if (rxLength < I2C_SLAVE_RX_MAX) {
+        HAL_I2C_Slave_Seq_Receive_IT(hi2c, &rxBuffer[rxLength], 1, I2C_NEXT_FRAME);
+    }
+}
+
+extern "C" void HAL_I2C_SlaveTxCpltCallback(I2C_HandleTypeDef *hi2c) {
+    (void)hi2c;
+    // Every offered byte was clocked out; the STOP completes the transaction
+}
+
+extern "C" void HAL_I2C_ListenCpltCallback(I2C_HandleTypeDef *hi2c) {
+    finishTransaction();
+    relisten(hi2c);
+}
+
+extern "C" void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c) {
+    // A master reading fewer bytes than offered NACKs the last one it
+    // wants; that AF is the normal end of a read, anything else is an error
+    if (HAL_I2C_GetError(hi2c) & ~HAL_I2C_ERROR_AF) slaveStats.errors++;
+    finishTransaction();
+    relisten(hi2c);
+}
+
+extern "C" void I2C1_EV_IRQHandler(void) {
+    uint32_t start = DWT->CYCCNT;
+    HAL_I2C_EV_IRQHandler(&i2cHandle);
+    slaveStats.isrCycles += DWT->CYCCNT - start;
+}
+
+extern "C" void I2C1_ER_IRQHandler(void) {
+    uint32_t start = DWT->CYCCNT;
+    HAL_I2C_ER_IRQHandler(&i2cHandle);
+    slaveStats.isrCycles += DWT->CYCCNT - start;
+}
+
+extern "C" void DMA1_Stream6_IRQHandler(void) {
+    uint32_t start = DWT->CYCCNT;
+    HAL_DMA_IRQHandler(&dmaTxHandle);
+    slaveStats.isrCycles += DWT->CYCCNT - start;
+}
+
+#else // I2C_TRANSPORT_WIRE
+
+#include <Wire.h>
+
+const char *i2cSlaveTransportName() {
+    return "Wire";
+}
+
+// Wire hides its interrupt handler, so only the callbacks are timed
+static void onWireRequest() {
+    uint32_t start = DWT->CYCCNT;
+    const uint8_t *data = NULL;
+    size_t length = 0;
+    if (readHandler) readHandler(&data, &length);
+    if (data && length > 0) Wire.write(data, length);
+    // Wire copied the data into its own buffer
+    if (readDoneHandler) readDoneHandler();
+    slaveStats.transactions++;
+    slaveStats.isrCycles += DWT->CYCCNT - start;
+}
+
+static void onWireReceive(int numBytes) {
+    (void)numBytes;
+    uint32_t start = DWT->CYCCNT;
+    uint8_t buffer[I2C_SLAVE_RX_MAX];
+    size_t length = 0;
+    while (Wire.available()) {
+        uint8_t value = Wire.read();
+        if (length < sizeof(buffer)) buffer[length++] = value;
+    }
+    if (length > 0 && writeHandler) writeHandler(buffer, length);
+    slaveStats.transactions++;
+    slaveStats.isrCycles += DWT->CYCCNT - start;
+}
+
+bool i2cSlaveBegin(uint8_t address, I2cReadHandler onRead,
+                   I2cReadDoneHandler onReadDone, I2cWriteHandler onWrite) {
+    readHandler = onRead;
+    readDoneHandler = onReadDone;
+    writeHandler = onWrite;
+    startCycleCounter();
+
+    Wire.begin(address);
+    Wire.setClock(I2C_BUS_HZ);
+    Wire.onRequest(onWireRequest);
+    Wire.onReceive(onWireReceive);
+    return true;
+}
+
+#endif
@@ -0,0 +1,64 @@
+/*
+ * AKS Data Generator - I2C slave transport
+ * Two interchangeable transports behind one interface, selected at build
+ * time with I2C_TRANSPORT:
+ *
+ *   I2C_TRANSPORT_DMA   HAL listen mode on I2C1 with DMA1 Stream6 (ch 1)
+ *                       clocking read data straight out of the caller's
+ *                       buffer: one interrupt per transaction phase
+ *                       instead of one per byte. Register writes are a
+ *                       few bytes and stay interrupt driven.
+ *   I2C_TRANSPORT_WIRE  Arduino Wire slave (interrupt per byte), fallback.
+ *
+ * The F411's I2C peripheral is specified up to 400 kHz (no FMPI2C on this
+ * part). At 1 MHz it keeps up only through clock stretching, so that speed
+ * depends on the master honouring it.
+ *
+ * Handlers run in interrupt context.
+ */
+
+#ifndef I2C_SLAVE_H
+#define I2C_SLAVE_H
+
+#include <Arduino.h>
+
+#define I2C_TRANSPORT_WIRE 1
+#define I2C_TRANSPORT_DMA  2
+
+#ifndef I2C_TRANSPORT
+#define I2C_TRANSPORT I2C_TRANSPORT_DMA
+#endif
+
+#ifndef I2C_BUS_HZ
+#define I2C_BUS_HZ 400000
+#endif
+
+#define I2C_SLAVE_RX_MAX 16      // longest register write accepted
+
+// Longest read a handler may offer: Wire copies into its 32-byte TX
+// buffer, DMA sends from the handler's buffer directly
+#if I2C_TRANSPORT == I2C_TRANSPORT_WIRE
+#define I2C_SLAVE_MAX_READ 32
+#else
+#define I2C_SLAVE_MAX_READ 1024
+#endif
+
+// Master read: point *data at the bytes to send, set *length. The buffer
+// must stay untouched until the read-done handler runs.
+typedef void (*I2cReadHandler)(const uint8_t **data, size_t *length);
+typedef void (*I2cReadDoneHandler)();
+// Master write: the bytes written in one transaction
+typedef void (*I2cWriteHandler)(const uint8_t *data, size_t length);
+
+struct I2cSlaveStats {
+    uint32_t transactions;   // completed reads and writes
+    uint32_t isrCycles;      // CPU cycles spent in I2C interrupt code
+    uint32_t errors;         // bus errors other than the end-of-read NACK
+};
+
+bool i2cSlaveBegin(uint8_t address, I2cReadHandler onRead,
+                   I2cReadDoneHandler onReadDone, I2cWriteHandler onWrite);
+const char *i2cSlaveTransportName();
+void i2cSlaveGetStats(I2cSlaveStats &stats);
+
+#endif
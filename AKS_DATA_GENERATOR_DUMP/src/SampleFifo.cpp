@@ -0,0 +1,38 @@
+#include "SampleFifo.h"
+
+bool SampleFifo::push(const AksFifoSample &sample) {
+    uint8_t h = head;
+    if ((uint8_t)(h - tail) >= SAMPLE_FIFO_CAPACITY) {
+        droppedTotal = droppedTotal + 1;
+        return false;
+    }
+    entries[h & (SAMPLE_FIFO_CAPACITY - 1)] = sample;
+    __DMB(); // entry complete before the consumer can see it
+    head = h + 1;
+    return true;
+}
+
+uint8_t SampleFifo::pop(AksFifoSample *out, uint8_t max) {
+    uint8_t t = tail;
+    uint8_t available = (uint8_t)(head - t);
+    uint8_t n = min(available, max);
+    __DMB(); // read entries only after seeing the head that covers them
+    for (uint8_t i = 0; i < n; i++) {
+        out[i] = entries[(uint8_t)(t + i) & (SAMPLE_FIFO_CAPACITY - 1)];
+    }
+    __DMB(); // copies done before the producer may reuse the slots
+    tail = t + n;
+    return n;
+}
+
+uint16_t SampleFifo::dropped() const {
+    uint32_t n = droppedTotal - droppedReported;
+    return n > 0xFFFF ? 0xFFFF : (uint16_t)n;
+}
+
+uint16_t SampleFifo::takeDropped() {
+    uint32_t total = droppedTotal;
+    uint32_t n = total - droppedReported;
+    droppedReported = total;
+    return n > 0xFFFF ? 0xFFFF : (uint16_t)n;
+}
@@ -0,0 +1,48 @@
+/*
+ * AKS Data Generator - timestamped sample FIFO
+ * Single-producer / single-consumer ring of AksFifoSample: the main loop
+ * pushes one entry per published sample and the I2C handler pops bursts,
+ * so neither side needs to mask interrupts. Each index is written by one
+ * side only. When the ring is full new samples are dropped and counted;
+ * the consumer reports the count with the next burst.
+ */
+
+#ifndef SAMPLE_FIFO_H
+#define SAMPLE_FIFO_H
+
+#include <Arduino.h>
+#include <AksRegisters.h>
+
+#ifndef SAMPLE_FIFO_CAPACITY
+#define SAMPLE_FIFO_CAPACITY 64  // power of two, at most 128
+#endif
+
+class SampleFifo {
+public:
+    // Producer side. Returns false and counts a drop when full.
+    bool push(const AksFifoSample &sample);
+
+    // Consumer side. Copies up to max samples, oldest first.
+    uint8_t pop(AksFifoSample *out, uint8_t max);
+    // Drops since the previous takeDropped(), saturated to 16 bits
+    uint16_t dropped() const;
+    // Same, and starts a new count
+    uint16_t takeDropped();
+
+    uint8_t count() const { return (uint8_t)(head - tail); }
+    uint8_t capacity() const { return SAMPLE_FIFO_CAPACITY; }
+    // Drops not yet reported to a master
+    bool overflowed() const { return droppedTotal != droppedReported; }
+
+private:
+    static_assert((SAMPLE_FIFO_CAPACITY & (SAMPLE_FIFO_CAPACITY - 1)) == 0 &&
+                  SAMPLE_FIFO_CAPACITY <= 128, "FIFO capacity");
+
+    AksFifoSample entries[SAMPLE_FIFO_CAPACITY];
+    volatile uint8_t head = 0;               // producer only, free running
+    volatile uint8_t tail = 0;               // consumer only, free running
+    volatile uint32_t droppedTotal = 0;      // producer only
+    volatile uint32_t droppedReported = 0;   // consumer only
+};
+
+#endif
@@ -22,209 +22,536 @@
  */
 
 #include <Arduino.h>
-#include <Wire.h>
+#include <AksRegisters.h>
+#include <AksStream.h>
+#include "I2cSlave.h"
+#include "FixedStep.h"
+#include "SampleFifo.h"
+#include <VehicleSimulator.h>
 
 // No real sensor pins needed - all values are simulated
 // Only I2C pins are used for communication
 
 // I2C configuration
-#define I2C_SLAVE_ADDRESS 0x42    // AKS data generator I2C address
+#define I2C_SLAVE_ADDRESS AKS_I2C_ADDRESS  // AKS data generator I2C address
 #define I2C_SDA_PIN PB7          // I2C1_SDA 
 #define I2C_SCL_PIN PB6          // I2C1_SCL
+#define I2C_MAX_READ 32          // bytes offered per read request (Wire buffer size)
+// Largest FIFO burst the transport can send in one read
+#define FIFO_BURST_MAX min((size_t)AKS_FIFO_MAX_BURST, \
+    (I2C_SLAVE_MAX_READ - sizeof(AksFifoBurstHeader)) / sizeof(AksFifoSample))
 
-// AKS telemetry data structure
-struct AKS_TelemetryData {
-    uint32_t timestamp_ms;        // Time since vehicle start (ms)
-    float vehicle_speed_kmh;      // Vehicle speed (km/h)
-    float battery_temp_C;         // Battery temperature (°C)
-    float battery_voltage_V;      // Total battery voltage (V)
-    float remaining_energy_Wh;    // Remaining energy (Wh)
-    float motor_temp_C;           // Motor temperature (°C)
-    float brake_pressure_bar;     // Brake pressure (bar)
-    uint8_t system_status;        // System status flags
-    uint8_t fault_codes;          // Fault diagnostic codes
-} __attribute__((packed));
+// Scheduler rates. Physics runs on a fixed step, sped up by the time
+// scale; publishing follows sample_interval_ms in simulated time, so an
+// accelerated run also loads the I2C and downstream links harder.
+#ifndef PHYSICS_HZ
+#define PHYSICS_HZ 100
+#endif
+#ifndef PRINT_INTERVAL_MS
+#define PRINT_INTERVAL_MS 1000
+#endif
+#define PHYSICS_STEP_US (1000000UL / PHYSICS_HZ)
+#define PHYSICS_MAX_CATCHUP 50   // steps run in one pass before dropping time
+#ifndef SIM_TIME_SCALE
+#define SIM_TIME_SCALE 1         // simulated seconds per real second
+#endif
+#define SIM_TIME_SCALE_MAX 50
+#ifndef SIM_DEFAULT_MODE
+#define SIM_DEFAULT_MODE AKS_MODE_NORMAL
+#endif
+
+// Serial output: labelled text once a second, or framed binary
+// (common/AksProtocol/AksStream.h) with one AKS_TelemetryData per physics
+// step for tools/serial_tap. Binary frames are only queued when the UART
+// buffer has room, so streaming never stalls the loop; frames that do not
+// fit are counted and reported in the info frame.
+#define SERIAL_OUTPUT_TEXT   1
+#define SERIAL_OUTPUT_BINARY 2
+#ifndef SERIAL_OUTPUT
+#define SERIAL_OUTPUT SERIAL_OUTPUT_TEXT
+#endif
+#ifndef SERIAL_BAUD
+#if SERIAL_OUTPUT == SERIAL_OUTPUT_BINARY
+#define SERIAL_BAUD 921600
+#else
+#define SERIAL_BAUD 115200
+#endif
+#endif
+
+// Register map and AKS_TelemetryData layout: common/AksProtocol/AksRegisters.h
 
 // Function declarations
 void updateTelemetryData();
-void simulateVehicleDynamics();
-void onI2CRequest();
-void onI2CReceive(int numBytes);
+void simulateVehicleDynamics(q16_t dt);
+void onI2CRead(const uint8_t **data, size_t *length);
+void onI2CReadDone();
+void onI2CWrite(const uint8_t *data, size_t length);
+void updateBusStatistics();
 void printTelemetryData();
+uint32_t bootEntropy();
+void publishTelemetry();
+void buildRegisterMap(AksRegisterMap& map);
+void logFaults();
+void runCommand(uint8_t command);
+void applyPendingRequests();
+void writeConfigRegister(uint8_t reg, uint8_t value);
+void queueFifoSample();
+void prepareFifoBurst(uint8_t requested);
+void streamTelemetry();
+void streamInfo();
+bool streamFrame(uint8_t type, const void *payload, size_t length);
 
 // Global variables
-AKS_TelemetryData telemetryData;
-uint32_t lastDataUpdate = 0;
-uint32_t vehicleStartTime = 0;
+AKS_TelemetryData telemetryData;          // working copy, main loop only
+
+// Published register map images: the main loop fills the back image and
+// flips frontSnapshot, the I2C handler only ever reads the front one. A
+// master therefore never sees a sample that is half old and half new.
+AksRegisterMap registerImages[2];
+volatile uint8_t frontSnapshot = 0;
+volatile int8_t snapshotInUse = -1;       // image a transfer is still reading
+volatile uint32_t publishRetries = 0;     // publishes held back by a busy buffer
+bool publishPending = false;
+uint32_t publishedSamples = 0;
+
+// Register access state, owned by the I2C handlers
+volatile uint8_t registerPointer = AKS_REG_LEGACY;
+volatile uint32_t i2cRequests = 0;
+volatile uint32_t i2cWrites = 0;
+uint32_t i2cRate = 0;                     // transactions in the last second
+uint32_t i2cIsrCycles = 0;                // ISR cycles per transaction, last second
+uint16_t stagedInterval = 0;              // low byte of a sample_interval_ms write
+// Commands and mode changes touch the vehicle model, so the handlers only
+// post them and the main loop applies them between physics steps
+volatile uint8_t pendingCommand = 0;
+volatile uint8_t pendingMode = 0;
+
+// Sample FIFO for masters that poll slower than the publish rate. Queuing
+// starts with the first FIFO access so masters that never drain it do not
+// see a permanent overflow flag.
+struct FifoBurst {
+    AksFifoBurstHeader header;
+    AksFifoSample samples[AKS_FIFO_MAX_BURST];
+} __attribute__((packed));
+
+SampleFifo sampleFifo;
+volatile bool fifoEnabled = false;
+FifoBurst fifoBurst;                      // handler side only
+size_t fifoBurstLength = 0;
+bool fifoBurstReady = false;              // popped by a [0xD8][n] write, not yet read
+AksFifoStatus fifoStatus;                 // live copy served at AKS_REG_FIFO_STATUS
+
+// Published sample bookkeeping
+uint16_t sampleIntervalMs = 1000;
+uint8_t sampleSeq = 0;
+uint8_t lastFaultCodes = 0;
+AksFaultLog faultLog;
 bool dataRequested = false;
 
-// Vehicle simulation parameters
-float simulatedSpeed = 0.0;
-float batteryCapacity = 50000.0; // 50kWh in Wh
-float energyConsumption = 0.0;
-uint8_t simulationMode = 1; // 1=normal, 2=fault, 3=charging
+// Fixed-step clocks; simulated time only advances with physics steps.
+// publishClock is fed simulated microseconds, the others real ones.
+FixedStep physicsClock(PHYSICS_STEP_US, PHYSICS_MAX_CATCHUP);
+FixedStep publishClock(1000UL * 1000, 1);
+FixedStep printClock(1000UL * PRINT_INTERVAL_MS, 1);
+uint64_t simTimeUs = 0;
+uint32_t physicsStep = 0;   // within the current second, for q16StepDt()
+uint8_t timeScale = SIM_TIME_SCALE;
+
+// Binary stream state
+uint8_t streamSeq = 0;
+uint32_t streamDropped = 0;               // frames skipped for lack of UART space
+
+// Simulated vehicle (common/VehicleSim): model, driver, modes, scenario.
+// Its seed is printed at boot.
+VehicleSimulator sim;
 
 void setup() {
-    Serial.begin(115200);
+    Serial.begin(SERIAL_BAUD);
     delay(2000);
     
     Serial.println("AKS Data Generator - STM32F411RE");
     Serial.println("Vehicle Control System Telemetry");
     Serial.println("================================");
     
+    // Register images start zeroed so reserved bytes read as 0
+    memset(registerImages, 0, sizeof(registerImages));
+    memset(&faultLog, 0, sizeof(faultLog));
+    
     // Initialize I2C as slave
-    Wire.begin(I2C_SLAVE_ADDRESS);
-    Wire.onRequest(onI2CRequest);
-    Wire.onReceive(onI2CReceive);
+    if (!i2cSlaveBegin(I2C_SLAVE_ADDRESS, onI2CRead, onI2CReadDone, onI2CWrite)) {
+        Serial.println("I2C slave init failed");
+    }
+    
+    // Build with -D SIM_SEED=<printed seed> to replay a session
+    sim.begin(SIM_BOOT_SEED(bootEntropy()), SIM_DEFAULT_MODE);
     
-    // Record vehicle start time
-    vehicleStartTime = millis();
+    // Simulated time starts now
+    uint32_t now = micros();
+    physicsClock.reset(now);
+    publishClock.reset(0);
+    printClock.reset(now);
     
     Serial.println("System initialized successfully");
     Serial.println("I2C Slave Address: 0x42");
+    Serial.print("I2C transport: "); Serial.print(i2cSlaveTransportName());
+    Serial.print(" @ "); Serial.print(I2C_BUS_HZ / 1000); Serial.println(" kHz");
+    Serial.print("Physics: "); Serial.print(PHYSICS_HZ); Serial.print(" Hz fixed step, time x");
+    Serial.println(timeScale);
+    Serial.print("Simulation seed: 0x"); Serial.println(sim.seed(), HEX);
     Serial.println("Waiting for data requests...");
 }
 
 void loop() {
-    // Update telemetry data every 1 second
-    if (millis() - lastDataUpdate >= 1000) {
+    uint32_t now = micros();
+    
+    applyPendingRequests();
+    
+    // Physics first so a publish in the same pass sees the latest state
+    physicsClock.setPeriod(PHYSICS_STEP_US / timeScale);
+    uint8_t steps = physicsClock.due(now);
+    while (steps--) {
+        simulateVehicleDynamics(q16StepDt(physicsStep, PHYSICS_HZ));
+        physicsStep = (physicsStep + 1) % PHYSICS_HZ;
+        simTimeUs += PHYSICS_STEP_US;
+#if SERIAL_OUTPUT == SERIAL_OUTPUT_BINARY
+        streamTelemetry();
+#endif
+    }
+    
+    // Publish every sample interval of simulated time (1 second by default)
+    publishClock.setPeriod(1000UL * sampleIntervalMs);
+    if (publishClock.due((uint32_t)simTimeUs)) {
         updateTelemetryData();
-        lastDataUpdate = millis();
-        
-        // Print telemetry data to serial for debugging
-        printTelemetryData();
+        publishPending = true;
     }
     
-    // Simulate vehicle dynamics
-    simulateVehicleDynamics();
+    if (publishPending) {
+        publishTelemetry();
+    }
     
-    delay(100);
+    // Print telemetry data to serial for debugging
+    if (printClock.due(now)) {
+#if SERIAL_OUTPUT == SERIAL_OUTPUT_BINARY
+        streamInfo();
+#else
+        printTelemetryData();
+#endif
+    }
+    
+    updateBusStatistics();
 }
 
 void updateTelemetryData() {
-    telemetryData.timestamp_ms = millis() - vehicleStartTime;
+    sim.sample(telemetryData, (uint32_t)(simTimeUs / 1000));
+    if (sampleFifo.overflowed()) {
+        telemetryData.system_status |= AKS_STATUS_FIFO_OVERFLOW;
+    }
+    logFaults();
+    if (fifoEnabled) {
+        queueFifoSample();
+    }
+}
+
+void queueFifoSample() {
+    AksFifoSample sample;
+    sample.timestamp_ms = telemetryData.timestamp_ms;
+    sample.speed_centikmh = (uint16_t)(telemetryData.vehicle_speed_kmh * 100.0f + 0.5f);
+    sample.brake_decibar = (uint16_t)(telemetryData.brake_pressure_bar * 10.0f + 0.5f);
+    sample.battery_voltage_deciV = (uint16_t)lroundf(telemetryData.battery_voltage_V * 10.0f);
+    sample.battery_temp_deciC = (int16_t)lroundf(telemetryData.battery_temp_C * 10.0f);
+    sample.motor_temp_deciC = (int16_t)lroundf(telemetryData.motor_temp_C * 10.0f);
+    sample.system_status = telemetryData.system_status;
+    sample.fault_codes = telemetryData.fault_codes;
+    sampleFifo.push(sample);
+}
+
+// Records newly raised fault codes in the fault log ring
+void logFaults() {
+    uint8_t raised = telemetryData.fault_codes & ~lastFaultCodes;
+    lastFaultCodes = telemetryData.fault_codes;
+    if (!raised) return;
     
-    // Generate simulated battery temperature (20-50°C)
-    telemetryData.battery_temp_C = 25.0 + random(-50, 250) / 10.0;
+    AksFaultEntry& entry = faultLog.entries[faultLog.total % AKS_FAULT_LOG_ENTRIES];
+    entry.timestamp_ms = telemetryData.timestamp_ms;
+    entry.fault_codes = raised;
+    entry.system_status = telemetryData.system_status;
+    faultLog.total++;
+}
+
+// Copies the working sample into the back snapshot and makes it the front
+// one. If a transfer is still reading the back buffer the publish is
+// retried on the next pass instead of overwriting data on the wire.
+void publishTelemetry() {
+    uint8_t back = frontSnapshot ^ 1;
+    if (snapshotInUse == back) {
+        publishRetries++;
+        return;
+    }
     
-    // Simulate vehicle speed (0-120 km/h)
-    telemetryData.vehicle_speed_kmh = simulatedSpeed;
+    buildRegisterMap(registerImages[back]);
+    __DMB(); // image complete before it becomes visible to the handler
+    frontSnapshot = back;
+    publishPending = false;
+    publishedSamples++;
+}
+
+// Fills every block of a register map image from the current sample
+void buildRegisterMap(AksRegisterMap& map) {
+    sampleSeq++;
+    map.legacy = telemetryData;
+    
+    map.id.magic[0] = AKS_REG_MAGIC_0;
+    map.id.magic[1] = AKS_REG_MAGIC_1;
+    map.id.map_version = AKS_REG_MAP_VERSION;
+    map.id.flags = 0;
+    map.id.sample_interval_ms = sampleIntervalMs;
     
-    // Simulate battery voltage (300-420V for electric vehicle)
-    telemetryData.battery_voltage_V = 350.0 + (random(0, 4096) / 4095.0) * 70.0;
+    map.status.timestamp_ms = telemetryData.timestamp_ms;
+    map.status.system_status = telemetryData.system_status;
+    map.status.fault_codes = telemetryData.fault_codes;
+    map.status.simulation_mode = sim.mode();
+    map.status.sample_seq = sampleSeq;
     
-    // Calculate remaining energy based on consumption
-    telemetryData.remaining_energy_Wh = max(0.0f, batteryCapacity - energyConsumption);
+    map.fast.timestamp_ms = telemetryData.timestamp_ms;
+    map.fast.speed_centikmh = (uint16_t)(telemetryData.vehicle_speed_kmh * 100.0f + 0.5f);
+    map.fast.brake_decibar = (uint16_t)(telemetryData.brake_pressure_bar * 10.0f + 0.5f);
+    map.fast.system_status = telemetryData.system_status;
+    map.fast.fault_codes = telemetryData.fault_codes;
     
-    // Simulate motor temperature (40-120°C)
-    telemetryData.motor_temp_C = 40.0 + (random(0, 4096) / 4095.0) * 80.0;
+    map.slow.timestamp_ms = telemetryData.timestamp_ms;
+    map.slow.battery_temp_deciC = (int16_t)lroundf(telemetryData.battery_temp_C * 10.0f);
+    map.slow.battery_voltage_deciV = (uint16_t)lroundf(telemetryData.battery_voltage_V * 10.0f);
+    map.slow.remaining_energy_Wh = (uint32_t)telemetryData.remaining_energy_Wh;
+    map.slow.motor_temp_deciC = (int16_t)lroundf(telemetryData.motor_temp_C * 10.0f);
     
-    // Simulate brake pressure (0-200 bar)
-    telemetryData.brake_pressure_bar = (random(0, 4096) / 4095.0) * 200.0;
+    map.faultLog = faultLog;
     
-    // System status flags (bit-encoded)
-    // Bit 0: Motor ready
-    // Bit 1: Battery OK
-    // Bit 2: Brake system OK
-    // Bit 3: Charging active
-    // Bit 4: Regenerative braking active
-    telemetryData.system_status = 0x1F; // All systems OK by default
+    map.config.simulation_mode = sim.mode();
+    map.config.command = 0;
+    map.config.sample_interval_ms = sampleIntervalMs;
+    map.config.time_scale = timeScale;
+    map.config.scenario_lap = sim.mode() == AKS_MODE_SCENARIO ? sim.scenario().lap() : 0;
     
-    if (simulationMode == 3) { // Charging mode
-        telemetryData.system_status |= 0x08; // Set charging bit
+    map.diag.i2c_requests = i2cRequests;
+    map.diag.i2c_writes = i2cWrites;
+    map.diag.published_samples = publishedSamples;
+    map.diag.publish_retries = publishRetries;
+    map.diag.i2c_rate = i2cRate;
+    map.diag.i2c_isr_cycles = i2cIsrCycles;
+}
+
+// Sends the state after the physics step just taken
+void streamTelemetry() {
+    AKS_TelemetryData sample;
+    sim.sample(sample, (uint32_t)(simTimeUs / 1000));
+    streamFrame(AKS_STREAM_TELEMETRY, &sample, sizeof(sample));
+}
+
+// Lets the host label a capture and notice drops on the device side
+void streamInfo() {
+    AksStreamInfo info;
+    info.seed = sim.seed();
+    info.sample_interval_ms = PHYSICS_STEP_US / 1000;
+    info.simulation_mode = sim.mode();
+    info.time_scale = timeScale;
+    info.dropped_frames = streamDropped;
+    streamFrame(AKS_STREAM_INFO, &info, sizeof(info));
+}
+
+bool streamFrame(uint8_t type, const void *payload, size_t length) {
+    uint8_t frame[AKS_STREAM_MAX_FRAME];
+    // seq advances for skipped frames too, so host-side gaps cover both
+    size_t n = aksStreamEncode(type, streamSeq++, payload, length, frame);
+    if ((size_t)Serial.availableForWrite() < n) {
+        streamDropped++;
+        return false;
     }
+    Serial.write(frame, n);
+    return true;
+}
+
+// Turns the transport's running counters into per-second figures
+void updateBusStatistics() {
+    static uint32_t lastUpdate = 0;
+    static I2cSlaveStats last = {0, 0, 0};
     
-    // Fault codes simulation
-    telemetryData.fault_codes = 0x00; // No faults by default
+    uint32_t now = millis();
+    if (now - lastUpdate < 1000) return;
     
-    if (simulationMode == 2) { // Fault simulation
-        telemetryData.fault_codes = 0x04; // Motor overtemperature fault
-        telemetryData.system_status &= ~0x01; // Clear motor ready bit
+    I2cSlaveStats stats;
+    i2cSlaveGetStats(stats);
+    uint32_t transactions = stats.transactions - last.transactions;
+    uint32_t cycles = stats.isrCycles - last.isrCycles;
+    i2cRate = transactions * 1000UL / (now - lastUpdate);
+    i2cIsrCycles = transactions ? cycles / transactions : 0;
+    last = stats;
+    lastUpdate = now;
+}
+
+// Advances the simulation by one fixed step of dt seconds
+void simulateVehicleDynamics(q16_t dt) {
+    uint8_t events = sim.step(dt);
+    if (events & SIM_EVENT_MODE_CHANGED) {
+        Serial.print("Switching to simulation mode: ");
+        Serial.println(sim.mode());
+    }
+    if (events & SIM_EVENT_SCENARIO_RESTART) {
+        Serial.println("Scenario finished, restarting");
     }
+}
+
+// Seed material for a session: ADC noise from a floating input mixed
+// with the chip's unique ID, so boards and boots get different seeds
+uint32_t bootEntropy() {
+    uint32_t noise = 0;
+    for (int i = 0; i < 32; i++) {
+        noise = (noise << 1 | noise >> 31) ^ analogRead(A0);
+    }
+    return noise ^ HAL_GetUIDw0() ^ HAL_GetUIDw1() ^ HAL_GetUIDw2() ^ micros();
+}
+
+void onI2CRead(const uint8_t **data, size_t *length) {
+    uint8_t start = registerPointer;
+    i2cRequests++;
+    dataRequested = true;
+    // A read without a fresh address write gets the legacy block again
+    registerPointer = AKS_REG_LEGACY;
     
-    if (telemetryData.battery_temp_C > 60.0) {
-        telemetryData.fault_codes |= 0x02; // Battery overtemperature
-        telemetryData.system_status &= ~0x02; // Clear battery OK bit
+    // FIFO registers are live rather than part of the published image
+    if (start == AKS_REG_FIFO_STATUS) {
+        fifoEnabled = true;
+        fifoStatus.count = sampleFifo.count();
+        fifoStatus.capacity = sampleFifo.capacity();
+        fifoStatus.sample_size = sizeof(AksFifoSample);
+        fifoStatus.max_burst = FIFO_BURST_MAX;
+        fifoStatus.dropped = sampleFifo.dropped();
+        fifoStatus.reserved = 0;
+        *data = (const uint8_t*)&fifoStatus;
+        *length = sizeof(fifoStatus);
+        return;
     }
+    if (start == AKS_REG_FIFO_DATA) {
+        if (!fifoBurstReady) prepareFifoBurst(0);
+        fifoBurstReady = false;
+        *data = (const uint8_t*)&fifoBurst;
+        *length = fifoBurstLength;
+        return;
+    }
+    
+    // Serve the published image from the register pointer onward. With the
+    // DMA transport the bytes leave straight from the image, so it stays
+    // marked in use until onI2CReadDone().
+    uint8_t front = frontSnapshot;
+    snapshotInUse = front;
+    *data = (const uint8_t*)&registerImages[front] + start;
+    *length = min((size_t)I2C_MAX_READ, (size_t)(AKS_REG_MAP_SIZE - start));
 }
 
-void simulateVehicleDynamics() {
-    static uint32_t lastUpdate = 0;
-    static float acceleration = 0.0;
+// Pops up to requested samples (0 = as many as fit) into the burst buffer
+// for the next read. Slots past the popped count are zeroed so a master
+// that asked for more than was queued reads empty entries.
+void prepareFifoBurst(uint8_t requested) {
+    fifoEnabled = true;
+    uint8_t slots = FIFO_BURST_MAX;
+    if (requested > 0 && requested < slots) slots = requested;
     
-    if (millis() - lastUpdate < 100) return;
-    lastUpdate = millis();
+    uint8_t n = sampleFifo.pop(fifoBurst.samples, slots);
+    memset(&fifoBurst.samples[n], 0, (slots - n) * sizeof(AksFifoSample));
+    fifoBurst.header.count = n;
+    fifoBurst.header.remaining = sampleFifo.count();
+    fifoBurst.header.dropped = sampleFifo.takeDropped();
+    fifoBurstLength = sizeof(AksFifoBurstHeader) + slots * sizeof(AksFifoSample);
+    fifoBurstReady = true;
+}
+
+void onI2CReadDone() {
+    snapshotInUse = -1;
+}
+
+void onI2CWrite(const uint8_t *data, size_t length) {
+    if (length < 1) return;
+    i2cWrites++;
     
-    // Simple vehicle dynamics simulation
-    switch (simulationMode) {
-        case 1: // Normal driving
-            acceleration = (random(-20, 30) / 10.0); // -2 to +3 m/s²
-            break;
-        case 2: // Fault mode - reduced performance
-            acceleration = (random(-10, 10) / 10.0); // -1 to +1 m/s²
-            break;
-        case 3: // Charging mode
-            simulatedSpeed = 0.0;
-            acceleration = 0.0;
-            // Simulate energy recovery during charging
-            if (telemetryData.remaining_energy_Wh < batteryCapacity) {
-                energyConsumption -= 50.0; // Add 50Wh per second while charging
-            }
-            break;
+    uint8_t first = data[0];
+    if (length == 1) {
+        // Legacy single-byte command, otherwise the address for the next read
+        if (first >= AKS_CMD_RESET_ENERGY && first <= AKS_CMD_MODE_CHARGING) {
+            pendingCommand = first;
+        } else {
+            registerPointer = first;
+        }
+        return;
     }
     
-    // Update speed (convert acceleration from m/s² to km/h change)
-    simulatedSpeed += acceleration * 3.6 * 0.1; // 0.1s update interval
-    simulatedSpeed = constrain(simulatedSpeed, 0.0, 120.0);
-    
-    // Energy consumption calculation (simplified)
-    if (simulatedSpeed > 0 && simulationMode != 3) {
-        // Energy consumption in Wh (speed-dependent)
-        float powerConsumption = 150.0 + (simulatedSpeed * 2.0); // Base 150W + speed factor
-        energyConsumption += (powerConsumption * 0.1) / 3600.0; // Convert to Wh per 0.1s
+    // Burst size for a FIFO drain; the read follows with a repeated start.
+    // A burst popped by an earlier write and never read is served as it
+    // is, whatever size this one asks for: popping again would lose its
+    // samples without counting them as dropped.
+    if (first == AKS_REG_FIFO_DATA) {
+        if (!fifoBurstReady) prepareFifoBurst(data[1]);
+        registerPointer = AKS_REG_FIFO_DATA;
+        return;
     }
     
-    // Cycle through simulation modes periodically
-    static uint32_t modeChangeTime = 0;
-    if (millis() - modeChangeTime > 30000) { // Change mode every 30 seconds
-        simulationMode++;
-        if (simulationMode > 3) simulationMode = 1;
-        modeChangeTime = millis();
-        
-        Serial.print("Switching to simulation mode: ");
-        Serial.println(simulationMode);
+    // Address followed by data, written with auto-increment
+    uint8_t reg = first;
+    for (size_t i = 1; i < length; i++) {
+        writeConfigRegister(reg++, data[i]);
     }
 }
 
-void onI2CRequest() {
-    // Send telemetry data when requested by master (ESP32)
-    Wire.write((uint8_t*)&telemetryData, sizeof(telemetryData));
-    dataRequested = true;
+void applyPendingRequests() {
+    if (pendingMode) {
+        sim.setMode(pendingMode);
+        pendingMode = 0;
+    }
+    if (pendingCommand) {
+        runCommand(pendingCommand);
+        pendingCommand = 0;
+    }
 }
 
-void onI2CReceive(int numBytes) {
-    // Handle commands from master if needed
-    while (Wire.available()) {
-        uint8_t command = Wire.read();
-        
-        switch (command) {
-            case 0x01: // Reset energy consumption
-                energyConsumption = 0.0;
-                Serial.println("Energy consumption reset");
-                break;
-            case 0x02: // Set normal mode
-                simulationMode = 1;
-                Serial.println("Set to normal mode");
-                break;
-            case 0x03: // Set fault mode
-                simulationMode = 2;
-                Serial.println("Set to fault mode");
-                break;
-            case 0x04: // Set charging mode
-                simulationMode = 3;
-                Serial.println("Set to charging mode");
-                break;
-        }
+void runCommand(uint8_t command) {
+    switch (command) {
+        case AKS_CMD_RESET_ENERGY: // Reset energy consumption
+            sim.resetEnergy();
+            Serial.println("Energy consumption reset");
+            break;
+        case AKS_CMD_MODE_NORMAL: // Set normal mode
+            sim.setMode(AKS_MODE_NORMAL);
+            Serial.println("Set to normal mode");
+            break;
+        case AKS_CMD_MODE_FAULT: // Set fault mode
+            sim.setMode(AKS_MODE_FAULT);
+            Serial.println("Set to fault mode");
+            break;
+        case AKS_CMD_MODE_CHARGING: // Set charging mode
+            sim.setMode(AKS_MODE_CHARGING);
+            Serial.println("Set to charging mode");
+            break;
+    }
+}
+
+// Only the config block is writable; writes elsewhere are ignored
+void writeConfigRegister(uint8_t reg, uint8_t value) {
+    switch (reg - AKS_REG_CONFIG) {
+        case offsetof(AksConfigBlock, simulation_mode):
+            pendingMode = value;
+            break;
+        case offsetof(AksConfigBlock, command):
+            pendingCommand = value;
+            break;
+        case offsetof(AksConfigBlock, sample_interval_ms):
+            stagedInterval = value;
+            break;
+        case offsetof(AksConfigBlock, sample_interval_ms) + 1:
+            // Applied once both bytes are in, clamped to 10 ms .. 10 s
+            stagedInterval |= (uint16_t)value << 8;
+            sampleIntervalMs = constrain(stagedInterval, (uint16_t)10, (uint16_t)10000);
+            break;
+        case offsetof(AksConfigBlock, time_scale):
+            timeScale = constrain(value, (uint8_t)1, (uint8_t)SIM_TIME_SCALE_MAX);
+            break;
     }
 }
 
@@ -239,7 +566,24 @@ void printTelemetryData() {
     Serial.print("Brake Pressure: "); Serial.print(telemetryData.brake_pressure_bar, 1); Serial.println(" bar");
     Serial.print("System Status: 0x"); Serial.println(telemetryData.system_status, HEX);
     Serial.print("Fault Codes: 0x"); Serial.println(telemetryData.fault_codes, HEX);
-    Serial.print("Simulation Mode: "); Serial.println(simulationMode);
+    Serial.print("Simulation Mode: "); Serial.print(sim.mode());
+    if (sim.mode() == AKS_MODE_SCENARIO) {
+        Serial.print(" ("); Serial.print(sim.scenario().name());
+        Serial.print(" lap "); Serial.print(sim.scenario().lap()); Serial.print(")");
+    }
+    Serial.print(" | time x"); Serial.println(timeScale);
+    Serial.print("Published: "); Serial.print(publishedSamples);
+    Serial.print(" | Publish retries: "); Serial.println(publishRetries);
+    Serial.print("I2C: "); Serial.print(i2cRate); Serial.print(" transactions/s | ");
+    Serial.print(i2cIsrCycles); Serial.println(" ISR cycles/transaction");
+    Serial.print("Scheduler overruns: physics "); Serial.print(physicsClock.overruns());
+    Serial.print(" ("); Serial.print(physicsClock.droppedSteps()); Serial.print(" steps dropped)");
+    Serial.print(" | publish "); Serial.println(publishClock.overruns());
+    if (fifoEnabled) {
+        Serial.print("FIFO: "); Serial.print(sampleFifo.count());
+        Serial.print("/"); Serial.print(sampleFifo.capacity());
+        Serial.println(sampleFifo.overflowed() ? " (overflow)" : "");
+    }
     
     if (dataRequested) {
         Serial.println("*** Data sent to AKS_SCREEN ***");
@@ -0,0 +1,153 @@
+#include "AnimGovernor.h"
+
+#if AKS_SCREEN_UI
+
+#include <ui.h>
+#include <src/misc/lv_gc.h>
+
+const AnimLoop ANIM_DASHBOARD[] = {
+    { "wave1",     &ui_Wave1,           Wave1_Animation },
+    { "wave2",     &ui_Wave2,           Wave2_Animation },
+    { "particle1", &ui_Image_Particle1, Particle1_Animation },
+    { "particle2", &ui_Image_Particle2, Particle2_Animation },
+    { "particle3", &ui_Image_Particle3, Particle3_Animation },
+    { "gps knob",  &ui_Gps_Knob_Bg,     Knob_Animation },
+    { "map",       &ui_Map_Bg,          Map_Animation },
+};
+const uint8_t ANIM_DASHBOARD_COUNT = sizeof(ANIM_DASHBOARD) / sizeof(ANIM_DASHBOARD[0]);
+
+// SquareLine animations have no var of their own (it is the animation
+// itself) and keep their target in a ui_anim_user_data_t, which their
+// deleted_cb frees. Collects the running ones on target.
+static uint8_t findAnims(lv_obj_t *target, lv_anim_t **out, uint8_t max)
+{
+    uint8_t n = 0;
+    lv_ll_t *list = &LV_GC_ROOT(_lv_anim_ll);
+    for (lv_anim_t *a = (lv_anim_t *)_lv_ll_get_head(list); a && n < max;
+         a = (lv_anim_t *)_lv_ll_get_next(list, a)) {
+        if (a->deleted_cb != _ui_anim_callback_free_user_data || !a->user_data) continue;
+        if (((ui_anim_user_data_t *)a->user_data)->target == target) out[n++] = a;
+    }
+    return n;
+}
+
+// Not hidden itself or through a parent, and on the active screen
+static bool shown(lv_obj_t *obj)
+{
+    if (lv_obj_get_screen(obj) != lv_scr_act()) return false;
+    for (; obj; obj = lv_obj_get_parent(obj)) {
+        if (lv_obj_has_flag(obj, LV_OBJ_FLAG_HIDDEN)) return false;
+    }
+    return true;
+}
+
+bool AnimGovernor::begin(Display &disp, const AnimLoop *loops, uint8_t count)
+{
+    if (count > MAX_LOOPS) return false;
+    display = &disp;
+    table = loops;
+    tableSize = count;
+
+    lv_anim_t *found[4];
+    for (uint8_t i = 0; i < count; i++) {
+        startedOn[i] = *loops[i].target;
+        active[i] = startedOn[i] && findAnims(startedOn[i], found, 4) > 0;
+    }
+    windowStart = lv_tick_get();
+    windowBase = display->peekStats();
+    setQuality(ceiling);
+    return lv_timer_create(timerCb, ANIM_GOV_POLL_MS, this) != NULL;
+}
+
+void AnimGovernor::timerCb(lv_timer_t *timer)
+{
+    ((AnimGovernor *)timer->user_data)->poll();
+}
+
+void AnimGovernor::stop(uint8_t index)
+{
+    lv_anim_t *found[4];
+    uint8_t n = findAnims(startedOn[index], found, 4);
+    // var is the animation itself, so this deletes exactly that one
+    for (uint8_t k = 0; k < n; k++) lv_anim_del(found[k], NULL);
+    active[index] = false;
+}
+
+void AnimGovernor::poll()
+{
+    uint32_t now = lv_tick_get();
+    if (now - windowStart >= ANIM_GOV_WINDOW_MS) {
+        windowStart = now;
+        adjustQuality();
+    }
+
+    for (uint8_t i = 0; i < tableSize; i++) {
+        lv_obj_t *target = *table[i].target;
+        // A destroyed screen took the old target with it
+        if (active[i] && target != startedOn[i]) stop(i);
+        bool wanted = level > ANIM_QUALITY_OFF && target && shown(target);
+        if (wanted && !active[i]) {
+            table[i].start(target, 0);
+            startedOn[i] = target;
+            active[i] = true;
+        } else if (!wanted && active[i]) {
+            stop(i);
+        }
+    }
+}
+
+void AnimGovernor::adjustQuality()
+{
+    const FrameStats &now = display->peekStats();
+    if (now.frames < windowBase.frames) windowBase = {};    // taken by someone else
+    uint32_t frames = now.frames - windowBase.frames;
+    uint32_t refreshMs = now.refreshMs - windowBase.refreshMs;
+    windowBase = now;
+
+    if (frames && refreshMs > frames * ANIM_FRAME_BUDGET_MS) {
+        quietWindows = 0;
+        if (level > ANIM_QUALITY_OFF) setQuality(level - 1);
+    } else if (!frames || refreshMs * 2 < frames * ANIM_FRAME_BUDGET_MS) {
+        if (++quietWindows >= ANIM_GOV_UP_WINDOWS && level < ceiling) {
+            quietWindows = 0;
+            setQuality(level + 1);
+        }
+    } else {
+        quietWindows = 0;
+    }
+}
+
+void AnimGovernor::setQuality(uint8_t newLevel)
+{
+    level = newLevel;
+    // One timer steps every animation, the tab transitions included: they
+    // keep their duration but get fewer steps
+    static const uint8_t divider[] = { 4, 4, 2, 1 };
+    lv_timer_set_period(lv_anim_get_timer(), LV_DISP_DEF_REFR_PERIOD * divider[level]);
+}
+
+void AnimGovernor::setMaxQuality(uint8_t newCeiling)
+{
+    ceiling = newCeiling > ANIM_QUALITY_FULL ? ANIM_QUALITY_FULL : newCeiling;
+    quietWindows = 0;
+    setQuality(ceiling);
+}
+
+uint8_t AnimGovernor::running() const
+{
+    uint8_t n = 0;
+    for (uint8_t i = 0; i < tableSize; i++) n += active[i];
+    return n;
+}
+
+#endif
+
+const char *AnimGovernor::qualityName(uint8_t level)
+{
+    switch (level) {
+        case ANIM_QUALITY_OFF: return "off";
+        case ANIM_QUALITY_LOW: return "low";
+        case ANIM_QUALITY_REDUCED: return "reduced";
+        default: return "full";
+    }
+}
@@ -0,0 +1,84 @@
+/*
+ * AKS Screen - governor for the dashboard's looping animations
+ * The SquareLine UI starts its looping animations (particles, waves, map
+ * scroll, GPS knob) once at boot, and they run whether or not they can be
+ * seen. The governor keeps a table of them and:
+ *
+ *   - deletes the animations of a target that is hidden (another tab or
+ *     screen) and starts them again when it is shown
+ *   - sets the update period of all animations from the quality level,
+ *     so under load they step at a half or a quarter of the refresh rate
+ *     and leave the frames to the telemetry widgets
+ *   - lowers the quality when the average frame takes longer than the
+ *     budget, and raises it again after a few quiet windows
+ *
+ * setMaxQuality() caps the level; the governor never goes above it. A
+ * restarted animation begins from its first frame.
+ */
+
+#ifndef ANIM_GOVERNOR_H
+#define ANIM_GOVERNOR_H
+
+#include <Arduino.h>
+#include <lvgl.h>
+#include "Display.h"
+
+#define ANIM_QUALITY_OFF      0    // looping animations stopped
+#define ANIM_QUALITY_LOW      1    // every 4th refresh
+#define ANIM_QUALITY_REDUCED  2    // every 2nd refresh
+#define ANIM_QUALITY_FULL     3    // every refresh
+
+#ifndef ANIM_FRAME_BUDGET_MS
+#define ANIM_FRAME_BUDGET_MS LV_DISP_DEF_REFR_PERIOD
+#endif
+#define ANIM_GOV_POLL_MS      100  // visibility checks
+#define ANIM_GOV_WINDOW_MS    1000 // frame time averaged over this
+#define ANIM_GOV_UP_WINDOWS   3    // windows under half the budget before raising
+
+// A looping animation started by ui.c, and how to start it again
+struct AnimLoop {
+    const char *name;
+    lv_obj_t **target;             // a SquareLine global
+    lv_anim_t *(*start)(lv_obj_t *target, int delay);
+};
+
+class AnimGovernor {
+public:
+    // Takes over the loops ui.c started; call after ui_init()
+    bool begin(Display &display, const AnimLoop *loops, uint8_t count);
+
+    void setMaxQuality(uint8_t level);
+    uint8_t maxQuality() const { return ceiling; }
+    uint8_t quality() const { return level; }
+    uint8_t running() const;
+    uint8_t loopCount() const { return tableSize; }
+    static const char *qualityName(uint8_t level);
+
+private:
+    static const uint8_t MAX_LOOPS = 16;
+
+    static void timerCb(lv_timer_t *timer);
+    void poll();
+    void adjustQuality();
+    void setQuality(uint8_t newLevel);
+    void stop(uint8_t index);
+
+    Display *display = nullptr;
+    const AnimLoop *table = nullptr;
+    uint8_t tableSize = 0;
+    bool active[MAX_LOOPS] = {};
+    lv_obj_t *startedOn[MAX_LOOPS] = {};
+    uint8_t level = ANIM_QUALITY_FULL;
+    uint8_t ceiling = ANIM_QUALITY_FULL;
+    uint8_t quietWindows = 0;
+    uint32_t windowStart = 0;
+    FrameStats windowBase = {};
+};
+
+#if AKS_SCREEN_UI
+// The loops ui.c starts in its initial actions
+extern const AnimLoop ANIM_DASHBOARD[];
+extern const uint8_t ANIM_DASHBOARD_COUNT;
+#endif
+
+#endif
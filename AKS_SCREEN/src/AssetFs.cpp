@@ -0,0 +1,58 @@
+#include "AssetFs.h"
+
+#if AKS_ASSET_FS
+
+#include <LittleFS.h>
+
+static void *openCb(lv_fs_drv_t *, const char *path, lv_fs_mode_t mode)
+{
+    if (mode != LV_FS_MODE_RD) return NULL;
+    File file = LittleFS.open(path, "r");
+    if (!file) return NULL;
+    return new File(file);
+}
+
+static lv_fs_res_t closeCb(lv_fs_drv_t *, void *file)
+{
+    File *f = (File *)file;
+    f->close();
+    delete f;
+    return LV_FS_RES_OK;
+}
+
+static lv_fs_res_t readCb(lv_fs_drv_t *, void *file, void *buf, uint32_t btr, uint32_t *br)
+{
+    *br = ((File *)file)->read((uint8_t *)buf, btr);
+    return LV_FS_RES_OK;
+}
+
+static lv_fs_res_t seekCb(lv_fs_drv_t *, void *file, uint32_t pos, lv_fs_whence_t whence)
+{
+    SeekMode mode = whence == LV_FS_SEEK_CUR ? SeekCur : whence == LV_FS_SEEK_END ? SeekEnd : SeekSet;
+    return ((File *)file)->seek(pos, mode) ? LV_FS_RES_OK : LV_FS_RES_UNKNOWN;
+}
+
+static lv_fs_res_t tellCb(lv_fs_drv_t *, void *file, uint32_t *pos)
+{
+    *pos = ((File *)file)->position();
+    return LV_FS_RES_OK;
+}
+
+bool assetFsBegin(char letter)
+{
+    if (!LittleFS.begin(false)) return false;
+
+    static lv_fs_drv_t drv;
+    lv_fs_drv_init(&drv);
+    drv.letter = letter;
+    drv.cache_size = 0;        // ImagePack reads whole files at once
+    drv.open_cb = openCb;
+    drv.close_cb = closeCb;
+    drv.read_cb = readCb;
+    drv.seek_cb = seekCb;
+    drv.tell_cb = tellCb;
+    lv_fs_drv_register(&drv);
+    return true;
+}
+
+#endif
@@ -0,0 +1,22 @@
+/*
+ * AKS Screen - LVGL file system driver for the LittleFS partition
+ * Lets LVGL (and ImagePack.cpp) open files in LittleFS with paths like
+ * "L:/img/ebike_bg_png.akp". The partition is filled from AKS_SCREEN/data
+ * with: pio run -e esp32s3dev_ui_fs -t uploadfs
+ *
+ * Read only: the assets are written by uploadfs, never by the firmware.
+ * Built with -D AKS_ASSET_FS=1.
+ */
+
+#ifndef ASSET_FS_H
+#define ASSET_FS_H
+
+#include <lvgl.h>
+
+#define ASSET_FS_LETTER 'L'    // matches img_pack.py --fs-letter
+
+// Mounts LittleFS (without formatting it) and registers the driver;
+// false if the partition does not mount
+bool assetFsBegin(char letter = ASSET_FS_LETTER);
+
+#endif
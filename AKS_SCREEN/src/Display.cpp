@@ -0,0 +1,183 @@
+#include "Display.h"
+
+// Internal DMA-capable memory for stripes a queued flush reads, otherwise
+// PSRAM first and internal RAM as a fallback
+static lv_color_t *allocBuffer(size_t bytes, bool dma, bool &psram)
+{
+    void *p = nullptr;
+    psram = false;
+    if (dma) {
+        p = heap_caps_malloc(bytes, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+    } else {
+        p = heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        psram = p != nullptr;
+        if (!p) p = heap_caps_malloc(bytes, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    }
+    return (lv_color_t *)p;
+}
+
+bool Display::begin(DisplayBackend &backend, const DisplayConfig &config)
+{
+    panel = &backend;
+    hor = panel->width();
+    ver = panel->height();
+
+    bool fits = configure(config);
+
+    lv_disp_drv_init(&drv);
+    drv.hor_res = hor;
+    drv.ver_res = ver;
+    drv.flush_cb = flushCb;
+    drv.wait_cb = waitCb;
+    drv.monitor_cb = monitorCb;
+    drv.draw_buf = &drawBuf;
+    drv.direct_mode = current.strategy == DISP_BUF_DIRECT || current.strategy == DISP_BUF_PANEL;
+    drv.user_data = this;
+    lvDisp = lv_disp_drv_register(&drv);
+    return fits && lvDisp != nullptr;
+}
+
+bool Display::configure(const DisplayConfig &config)
+{
+    bool partial = config.strategy == DISP_BUF_PARTIAL;
+    uint32_t pixels = partial ? (uint32_t)hor * config.lines : (uint32_t)hor * ver;
+    size_t bytes = pixels * sizeof(lv_color_t);
+    bool dma = partial && config.dma;
+
+    // Drop the old buffers first: full frames may not fit twice
+    finishFlush();
+    freeBuffers();
+
+    bool psram;
+    lv_color_t *b1 = nullptr;
+    lv_color_t *b2 = nullptr;
+    if (config.strategy == DISP_BUF_PANEL) {
+        b1 = panel->frameBuffer(psram);
+    } else {
+        b1 = allocBuffer(bytes, partial, psram);
+        b2 = dma && b1 ? allocBuffer(bytes, true, psram) : nullptr;
+        if (!b1 || (dma && !b2)) {
+            heap_caps_free(b1);
+            b1 = nullptr;
+        }
+    }
+    if (!b1) {
+        heap_caps_free(b2);
+        // Fall back to a single 10-line stripe, which always fits
+        const DisplayConfig fallback = { DISP_BUF_PARTIAL, 10, false };
+        if (!(partial && config.lines <= fallback.lines && !dma)) configure(fallback);
+        return false;
+    }
+
+    buf1 = b1;
+    buf2 = b2;
+    bufBytes = bytes * (b2 ? 2 : 1);
+    inPsram = psram;
+    ownBuffers = config.strategy != DISP_BUF_PANEL;
+    current = config;
+    lv_disp_draw_buf_init(&drawBuf, buf1, buf2, pixels);
+    // A backend that cannot queue blocks in flush(), and the second stripe
+    // gains nothing
+    queued = dma && panel->canQueue();
+    panel->setQueued(queued);
+
+    if (lvDisp) {
+        drv.direct_mode = config.strategy == DISP_BUF_DIRECT || config.strategy == DISP_BUF_PANEL;
+        lv_disp_drv_update(lvDisp, &drv);
+        lv_obj_invalidate(lv_disp_get_scr_act(lvDisp));
+    }
+    return true;
+}
+
+void Display::freeBuffers()
+{
+    queued = false;
+    panel->setQueued(false);
+    if (ownBuffers) {
+        heap_caps_free(buf1);
+        heap_caps_free(buf2);
+    }
+    buf1 = buf2 = nullptr;
+    bufBytes = 0;
+}
+
+void Display::flushCb(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *color_p)
+{
+    ((Display *)drv->user_data)->flush(area, color_p);
+}
+
+void Display::flush(const lv_area_t *area, lv_color_t *color_p)
+{
+    uint32_t start = micros();
+    uint32_t w = area->x2 - area->x1 + 1;
+    uint32_t h = area->y2 - area->y1 + 1;
+
+    if (drv.direct_mode) {
+        // color_p is the whole frame: send the dirty rectangle out of it
+        panel->flush(area->x1, area->y1, w, h, &color_p[(uint32_t)area->y1 * hor + area->x1], hor);
+        lv_disp_flush_ready(&drv);
+    } else {
+        panel->flush(area->x1, area->y1, w, h, color_p, w);
+        // A queued buffer is handed back in poll() once it is sent
+        if (queued) flushing = true;
+        else lv_disp_flush_ready(&drv);
+    }
+    stats.flushUs += micros() - start;
+}
+
+// Called by LVGL while it waits for a buffer to come back
+void Display::waitCb(lv_disp_drv_t *drv)
+{
+    Display *self = (Display *)drv->user_data;
+    if (!self->waiting) {
+        self->waiting = true;
+        self->waitStart = micros();
+    }
+    self->poll();
+}
+
+void Display::poll()
+{
+    if (!flushing || panel->busy()) return;
+    flushing = false;
+    if (waiting) {
+        stats.waitUs += micros() - waitStart;
+        waiting = false;
+    }
+    lv_disp_flush_ready(&drv);
+}
+
+void Display::finishFlush()
+{
+    if (!flushing) return;
+    uint32_t start = micros();
+    panel->wait();
+    stats.waitUs += micros() - start;
+    poll();
+}
+
+void Display::monitorCb(lv_disp_drv_t *drv, uint32_t time, uint32_t px)
+{
+    FrameStats &s = ((Display *)drv->user_data)->stats;
+    s.frames++;
+    s.refreshMs += time;
+    if (time > s.maxRefreshMs) s.maxRefreshMs = time;
+    s.pixels += px;
+}
+
+void Display::takeStats(FrameStats &out)
+{
+    out = stats;
+    memset(&stats, 0, sizeof(stats));
+}
+
+const char *Display::strategyName(uint8_t strategy)
+{
+    switch (strategy) {
+        case DISP_BUF_PARTIAL: return "partial";
+        case DISP_BUF_FULL: return "full-frame";
+        case DISP_BUF_DIRECT: return "direct";
+        case DISP_BUF_PANEL: return "panel frame";
+        default: return "?";
+    }
+}
@@ -0,0 +1,104 @@
+/*
+ * AKS Screen - LVGL display driver
+ * Owns the draw buffers and the flush path; the pixels go to the panel
+ * through a DisplayBackend. The buffer strategy can be switched at runtime
+ * so the render benchmark can compare them:
+ *
+ *   DISP_BUF_PARTIAL  N-line stripes in internal DMA-capable RAM. With DMA
+ *                     there are two, and LVGL renders one while the other
+ *                     is on the bus; without, one stripe and a blocking push.
+ *   DISP_BUF_FULL     one full-frame buffer in PSRAM, each dirty area
+ *                     rendered into it and pushed by the CPU.
+ *   DISP_BUF_DIRECT   LVGL direct mode on a full frame in PSRAM; the
+ *                     frame is kept up to date in place and only the dirty
+ *                     areas are pushed, row by row.
+ *   DISP_BUF_PANEL    direct mode on the frame the panel scans out
+ *                     (RGB panels): nothing is pushed, there is no second
+ *                     copy of the frame. Only for backends that have one.
+ *
+ * DMA here means a queued flush (DisplayBackend::canQueue); TFT_eSPI's SPI
+ * DMA needs internal memory, so the full-frame strategies push with the
+ * CPU. Without PSRAM they fall back to internal RAM if it fits.
+ */
+
+#ifndef DISPLAY_H
+#define DISPLAY_H
+
+#include <Arduino.h>
+#include <lvgl.h>
+#include "DisplayBackend.h"
+
+#define DISP_BUF_PARTIAL 1
+#define DISP_BUF_FULL    2
+#define DISP_BUF_DIRECT  3
+#define DISP_BUF_PANEL   4
+
+struct DisplayConfig {
+    uint8_t strategy;         // DISP_BUF_*
+    uint16_t lines;           // stripe height, DISP_BUF_PARTIAL only
+    bool dma;                 // DISP_BUF_PARTIAL only, if the backend can queue
+};
+
+// Accumulated since the last takeStats(). flushUs is CPU time inside the
+// flush callback (the whole transfer when blocking, setup only with DMA);
+// waitUs is time LVGL spent waiting for a DMA transfer to free a buffer.
+struct FrameStats {
+    uint32_t frames;
+    uint32_t refreshMs;
+    uint32_t maxRefreshMs;
+    uint32_t pixels;
+    uint32_t flushUs;
+    uint32_t waitUs;
+};
+
+class Display {
+public:
+    // The backend is begun already
+    bool begin(DisplayBackend &panel, const DisplayConfig &config);
+    // Replaces the draw buffers; false if they do not fit, in which case a
+    // single 10-line stripe is used instead
+    bool configure(const DisplayConfig &config);
+
+    // Completes a finished DMA flush; call before lv_timer_handler()
+    void poll();
+    // Blocks until no transfer is in flight
+    void finishFlush();
+
+    void takeStats(FrameStats &out);
+    // Running totals since the last takeStats(), left as they are
+    const FrameStats &peekStats() const { return stats; }
+    const DisplayConfig &config() const { return current; }
+    lv_disp_t *disp() const { return lvDisp; }
+    DisplayBackend &backend() const { return *panel; }
+    size_t bufferBytes() const { return bufBytes; }
+    bool buffersInPsram() const { return inPsram; }
+    static const char *strategyName(uint8_t strategy);
+
+private:
+    static void flushCb(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *color_p);
+    static void waitCb(lv_disp_drv_t *drv);
+    static void monitorCb(lv_disp_drv_t *drv, uint32_t time, uint32_t px);
+
+    void flush(const lv_area_t *area, lv_color_t *color_p);
+    void freeBuffers();
+
+    DisplayBackend *panel = nullptr;
+    uint16_t hor = 0;
+    uint16_t ver = 0;
+    DisplayConfig current = {};
+    lv_disp_draw_buf_t drawBuf;
+    lv_disp_drv_t drv;
+    lv_disp_t *lvDisp = nullptr;
+    lv_color_t *buf1 = nullptr;
+    lv_color_t *buf2 = nullptr;
+    size_t bufBytes = 0;
+    bool inPsram = false;
+    bool ownBuffers = false;          // not the panel's frame
+    bool queued = false;              // flushes go through the backend's DMA
+    bool flushing = false;            // DMA transfer in flight
+    bool waiting = false;             // LVGL is blocked in waitCb
+    uint32_t waitStart = 0;
+    FrameStats stats = {};
+};
+
+#endif
@@ -0,0 +1,49 @@
+/*
+ * AKS Screen - display backend interface
+ * What Display needs from a panel: its size and a way to get a rectangle
+ * of RGB565 pixels onto it. Display owns the LVGL driver and the draw
+ * buffers and is the same for every panel; the backends are
+ *
+ *   TftBackend       SPI panels through TFT_eSPI (the ILI9341)
+ *   RgbPanelBackend  parallel RGB panels on the ESP32-S3 LCD peripheral
+ *                    (the CrowPanel 7.0"), frame buffer in PSRAM
+ *   MemoryBackend    a frame in RAM, for the host benchmark
+ *
+ * The panel is picked at build time, see PanelProfile.h. This header
+ * needs only LVGL, so the memory backend builds on the host too.
+ */
+
+#ifndef DISPLAY_BACKEND_H
+#define DISPLAY_BACKEND_H
+
+#include <stdint.h>
+#include <lvgl.h>
+
+class DisplayBackend {
+public:
+    virtual ~DisplayBackend() {}
+
+    // Brings the panel up; before Display::begin()
+    virtual bool begin() = 0;
+    virtual const char *name() const = 0;
+    virtual uint16_t width() const = 0;
+    virtual uint16_t height() const = 0;
+
+    // Sends a w x h rectangle at x,y; rows are stride pixels apart. The
+    // pixels may be changed in place (byte swapping).
+    virtual void flush(int32_t x, int32_t y, uint32_t w, uint32_t h, lv_color_t *pixels, uint32_t stride) = 0;
+
+    // Queued flushes: flush() only starts the transfer and busy() is true
+    // until the pixels may be reused. Needs buffers in internal DMA memory
+    // and stride == w.
+    virtual bool canQueue() const { return false; }
+    virtual void setQueued(bool queued) { (void)queued; }
+    virtual bool busy() { return false; }
+    virtual void wait() {}
+
+    // The frame the panel shows, for panels that scan out of memory; LVGL
+    // can render straight into it (DISP_BUF_PANEL). NULL if there is none.
+    virtual lv_color_t *frameBuffer(bool &psram) { psram = false; return nullptr; }
+};
+
+#endif
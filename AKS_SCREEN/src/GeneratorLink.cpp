@@ -0,0 +1,54 @@
+#include "GeneratorLink.h"
+
+bool GeneratorLink::begin(TwoWire &wire, uint8_t address)
+{
+    bus = &wire;
+    deviceAddress = address;
+
+    AksIdBlock id;
+    online = readBlock(AKS_REG_ID, &id, sizeof(id)) &&
+             id.magic[0] == AKS_REG_MAGIC_0 && id.magic[1] == AKS_REG_MAGIC_1 &&
+             id.map_version == AKS_REG_MAP_VERSION;
+    return online;
+}
+
+void GeneratorLink::poll(uint32_t nowMs)
+{
+    if (!bus) return;
+
+    if (nowMs - lastFastPoll >= GENERATOR_FAST_POLL_MS) {
+        lastFastPoll = nowMs;
+        online = readBlock(AKS_REG_FAST, &fastBlock, sizeof(fastBlock));
+    }
+
+    if (nowMs - lastSlowPoll >= GENERATOR_SLOW_POLL_MS) {
+        lastSlowPoll = nowMs;
+        readBlock(AKS_REG_STATUS, &statusBlock, sizeof(statusBlock));
+        readBlock(AKS_REG_SLOW, &slowBlock, sizeof(slowBlock));
+        readBlock(AKS_REG_FAULT_LOG, &faultLogBlock, sizeof(faultLogBlock));
+    }
+}
+
+// Address write, repeated start, then a read of exactly the block
+bool GeneratorLink::readBlock(uint8_t reg, void *out, size_t length)
+{
+    transactions++;
+    bus->beginTransmission(deviceAddress);
+    bus->write(reg);
+    if (bus->endTransmission(false) != 0) {
+        errors++;
+        return false;
+    }
+
+    size_t received = bus->requestFrom(deviceAddress, (uint8_t)length, (uint8_t)true);
+    busBytes += 3 + received;  // two address bytes, register byte, data
+    if (received != length) {
+        while (bus->available()) bus->read();
+        errors++;
+        return false;
+    }
+
+    uint8_t *bytes = (uint8_t *)out;
+    for (size_t i = 0; i < length; i++) bytes[i] = bus->read();
+    return true;
+}
@@ -0,0 +1,54 @@
+/*
+ * AKS Screen - I2C link to the AKS data generator
+ * Polls the generator's register map (common/AksProtocol/AksRegisters.h)
+ * block by block: the fast block (speed, brake, status) at a high rate,
+ * the slow block (temperatures, voltage, energy) and the fault log
+ * rarely. Each poll is one address write plus one short read, so the bus
+ * carries a fraction of what full 30-byte struct reads would.
+ */
+
+#ifndef GENERATOR_LINK_H
+#define GENERATOR_LINK_H
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <AksRegisters.h>
+
+#define GENERATOR_FAST_POLL_MS  50     // 20 Hz
+#define GENERATOR_SLOW_POLL_MS  1000   // 1 Hz
+
+class GeneratorLink {
+public:
+    // Reads the ID block; false if no compatible generator answers
+    bool begin(TwoWire &wire, uint8_t address = AKS_I2C_ADDRESS);
+
+    // Runs whichever polls are due; call from loop()
+    void poll(uint32_t nowMs);
+
+    bool connected() const { return online; }
+    const AksFastBlock &fast() const { return fastBlock; }
+    const AksSlowBlock &slow() const { return slowBlock; }
+    const AksStatusBlock &status() const { return statusBlock; }
+    const AksFaultLog &faultLog() const { return faultLogBlock; }
+
+    // Bus usage since begin()
+    uint32_t transactions = 0;
+    uint32_t busBytes = 0;
+    uint32_t errors = 0;
+
+private:
+    bool readBlock(uint8_t reg, void *out, size_t length);
+
+    TwoWire *bus = nullptr;
+    uint8_t deviceAddress = AKS_I2C_ADDRESS;
+    bool online = false;
+    uint32_t lastFastPoll = 0;
+    uint32_t lastSlowPoll = 0;
+
+    AksFastBlock fastBlock = {};
+    AksSlowBlock slowBlock = {};
+    AksStatusBlock statusBlock = {};
+    AksFaultLog faultLogBlock = {};
+};
+
+#endif
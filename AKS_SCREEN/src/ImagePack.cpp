@@ -0,0 +1,408 @@
+#include "ImagePack.h"
+
+#if AKS_IMG_PACK
+
+#include <string.h>
+#include <stdlib.h>
+
+#ifdef ARDUINO
+#include <Arduino.h>
+static uint32_t nowUs() { return micros(); }
+#else
+#include <chrono>
+static uint32_t nowUs()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+#endif
+
+#define IMG_PACK_CACHE_ENTRIES 32        // the dashboard has 29 images
+#define IMG_PACK_PREFETCH_QUEUE IMG_PACK_CACHE_ENTRIES
+
+struct CacheEntry {
+    const lv_img_dsc_t *img;          // NULL = free slot
+    uint8_t *pixels;
+    size_t bytes;
+    uint32_t lastUse;
+    uint16_t refs;                    // open decoder descriptors using it
+};
+
+// Per open descriptor: a cache entry, or a row buffer for row-by-row drawing
+// (with the file contents, for an image in LittleFS)
+struct OpenImage {
+    CacheEntry *entry;
+    const img_pack_header_t *header;
+    uint8_t *file;
+    uint8_t *row;
+    int32_t rowY;
+};
+
+static CacheEntry cache[IMG_PACK_CACHE_ENTRIES];
+static size_t cacheBudget;
+static size_t cacheUsed;
+static size_t cachePeak;
+static uint32_t useClock;
+static ImagePackStats *stats;
+
+static const lv_img_dsc_t *prefetchQueue[IMG_PACK_PREFETCH_QUEUE];
+static uint16_t prefetchHead;
+static uint16_t prefetchCount;
+
+// Decoded images go to PSRAM when there is any
+static void *allocPixels(size_t bytes)
+{
+#ifdef ARDUINO
+    void *p = heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (p) return p;
+#endif
+    return malloc(bytes);
+}
+
+static void freePixels(void *p)
+{
+#ifdef ARDUINO
+    heap_caps_free(p);
+#else
+    free(p);
+#endif
+}
+
+static const img_pack_header_t *packedHeader(const lv_img_dsc_t *img)
+{
+    if (img->header.cf != LV_IMG_CF_RAW && img->header.cf != LV_IMG_CF_RAW_ALPHA) return NULL;
+    if (img->data_size < sizeof(img_pack_header_t) || memcmp(img->data, "AKP1", 4) != 0) return NULL;
+    return (const img_pack_header_t *)img->data;
+}
+
+static const img_pack_file_ref_t *fileRef(const lv_img_dsc_t *img)
+{
+    if (img->header.cf != LV_IMG_CF_RAW && img->header.cf != LV_IMG_CF_RAW_ALPHA) return NULL;
+    if (img->data_size <= sizeof(img_pack_file_ref_t) || memcmp(img->data, "AKF1", 4) != 0) return NULL;
+    return (const img_pack_file_ref_t *)img->data;
+}
+
+bool imgPackIsPacked(const lv_img_dsc_t *img)
+{
+    return packedHeader(img) != NULL || fileRef(img) != NULL;
+}
+
+bool imgPackIsFile(const lv_img_dsc_t *img)
+{
+    return fileRef(img) != NULL;
+}
+
+static ImagePackStats &statsOf(const lv_img_dsc_t *img)
+{
+    const img_pack_header_t *h = packedHeader(img);
+    uint16_t id = h ? h->id : fileRef(img)->id;
+    return stats[id < img_pack_asset_count ? id : 0];
+}
+
+static size_t decodedBytes(const lv_img_dsc_t *img)
+{
+    return (size_t)img->header.w * img->header.h * (img->header.cf == LV_IMG_CF_RAW_ALPHA ? 3 : 2);
+}
+
+// Reads an image from LittleFS into a new buffer; NULL if the file is
+// missing, short or not the image the descriptor expects
+static uint8_t *loadFile(const lv_img_dsc_t *img, const img_pack_file_ref_t *ref, ImagePackStats &s)
+{
+    uint8_t *file = (uint8_t *)allocPixels(ref->file_size);
+    if (!file) return NULL;
+
+    uint32_t start = nowUs();
+    lv_fs_file_t f;
+    uint32_t read = 0;
+    bool ok = lv_fs_open(&f, (const char *)(ref + 1), LV_FS_MODE_RD) == LV_FS_RES_OK;
+    if (ok) {
+        ok = lv_fs_read(&f, file, ref->file_size, &read) == LV_FS_RES_OK && read == ref->file_size;
+        lv_fs_close(&f);
+    }
+    const img_pack_header_t *h = (const img_pack_header_t *)file;
+    if (!ok || read < sizeof(img_pack_header_t) || memcmp(h->magic, "AKP1", 4) != 0 ||
+        h->w != img->header.w || h->h != img->header.h) {
+        freePixels(file);
+        return NULL;
+    }
+    s.loads++;
+    s.loadUs += nowUs() - start;
+    return file;
+}
+
+// The packed image: in flash, or read from LittleFS into *file (to be freed)
+static const img_pack_header_t *imageHeader(const lv_img_dsc_t *img, ImagePackStats &s, uint8_t **file)
+{
+    *file = NULL;
+    const img_pack_header_t *h = packedHeader(img);
+    if (h) return h;
+    const img_pack_file_ref_t *ref = fileRef(img);
+    if (!ref || (*file = loadFile(img, ref, s)) == NULL) return NULL;
+    return (const img_pack_header_t *)*file;
+}
+
+// Decodes row y into out (w * pixel_size bytes)
+static void decodeRow(const img_pack_header_t *h, uint32_t y, uint8_t *out)
+{
+    const uint8_t *palette = (const uint8_t *)(h + 1);
+    const uint8_t *offsets = palette + (size_t)h->palette_size * h->pixel_size;
+    const uint8_t *rows = offsets + (size_t)h->h * 4;
+    uint32_t offset;
+    memcpy(&offset, offsets + y * 4, 4);    // may be unaligned
+    const uint8_t *src = rows + offset;
+
+    const uint8_t px = h->pixel_size;
+    const bool indexed = h->encoding == IMG_PACK_PALETTE;
+    const uint8_t unit = indexed ? 1 : px;
+    uint8_t *end = out + (size_t)h->w * px;
+    while (out < end) {
+        uint8_t c = *src++;
+        uint32_t n = (c & 0x7F) + 1;
+        if (c & 0x80) {
+            const uint8_t *value = indexed ? palette + (size_t)*src * px : src;
+            src += unit;
+            if (px == 2) {
+                for (uint32_t i = 0; i < n; i++, out += 2) memcpy(out, value, 2);
+            } else {
+                for (uint32_t i = 0; i < n; i++, out += 3) memcpy(out, value, 3);
+            }
+        } else if (indexed) {
+            for (uint32_t i = 0; i < n; i++, out += px) memcpy(out, palette + (size_t)*src++ * px, px);
+        } else {
+            memcpy(out, src, n * px);
+            src += n * px;
+            out += n * px;
+        }
+    }
+}
+
+static CacheEntry *cacheFind(const lv_img_dsc_t *img)
+{
+    for (CacheEntry &e : cache) {
+        if (e.img == img) return &e;
+    }
+    return NULL;
+}
+
+// Frees least recently used entries that are not in use until bytes fit
+// (only with evict); returns a free slot or NULL
+static CacheEntry *cacheMakeRoom(size_t bytes, bool evict)
+{
+    if (bytes > cacheBudget) return NULL;
+    for (;;) {
+        CacheEntry *freeSlot = NULL;
+        CacheEntry *oldest = NULL;
+        for (CacheEntry &e : cache) {
+            if (!e.img) {
+                if (!freeSlot) freeSlot = &e;
+            } else if (e.refs == 0 && (!oldest || e.lastUse < oldest->lastUse)) {
+                oldest = &e;
+            }
+        }
+        if (freeSlot && cacheUsed + bytes <= cacheBudget) return freeSlot;
+        if (!oldest || !evict) return NULL;
+        freePixels(oldest->pixels);
+        cacheUsed -= oldest->bytes;
+        memset(oldest, 0, sizeof(*oldest));
+    }
+}
+
+// Decodes the whole image into the cache; NULL if it does not fit
+static CacheEntry *cacheDecode(const lv_img_dsc_t *img, const img_pack_header_t *h, ImagePackStats &s,
+                               bool evict)
+{
+    size_t bytes = (size_t)h->w * h->h * h->pixel_size;
+    CacheEntry *entry = cacheMakeRoom(bytes, evict);
+    uint8_t *pixels = entry ? (uint8_t *)allocPixels(bytes) : NULL;
+    if (!pixels) return NULL;
+
+    uint32_t start = nowUs();
+    for (uint32_t y = 0; y < h->h; y++) decodeRow(h, y, pixels + (size_t)y * h->w * h->pixel_size);
+    s.decodeUs += nowUs() - start;
+    entry->img = img;
+    entry->pixels = pixels;
+    entry->bytes = bytes;
+    entry->lastUse = ++useClock;
+    cacheUsed += bytes;
+    if (cacheUsed > cachePeak) cachePeak = cacheUsed;
+    return entry;
+}
+
+static lv_res_t infoCb(lv_img_decoder_t *, const void *src, lv_img_header_t *header)
+{
+    if (lv_img_src_get_type(src) != LV_IMG_SRC_VARIABLE) return LV_RES_INV;
+    const lv_img_dsc_t *img = (const lv_img_dsc_t *)src;
+    if (!imgPackIsPacked(img)) return LV_RES_INV;
+    *header = img->header;
+    return LV_RES_OK;
+}
+
+static lv_res_t openCb(lv_img_decoder_t *, lv_img_decoder_dsc_t *dsc)
+{
+    if (dsc->src_type != LV_IMG_SRC_VARIABLE) return LV_RES_INV;
+    const lv_img_dsc_t *img = (const lv_img_dsc_t *)dsc->src;
+    if (!imgPackIsPacked(img)) return LV_RES_INV;
+    ImagePackStats &s = statsOf(img);
+
+    OpenImage *open = (OpenImage *)calloc(1, sizeof(OpenImage));
+    if (!open) return LV_RES_INV;
+    open->rowY = -1;
+
+    CacheEntry *entry = cacheFind(img);
+    if (entry) {
+        s.hits++;
+    } else {
+        s.misses++;
+        uint32_t start = nowUs();
+        uint8_t *file;
+        const img_pack_header_t *h = imageHeader(img, s, &file);
+        if (!h) {
+            free(open);
+            return LV_RES_INV;
+        }
+        entry = cacheDecode(img, h, s, true);
+        if (entry) {
+            freePixels(file);
+            dsc->time_to_open = (nowUs() - start) / 1000;
+        } else {
+            // Too big for the budget, or out of memory: draw row by row
+            open->header = h;
+            open->file = file;
+            open->row = (uint8_t *)malloc((size_t)h->w * h->pixel_size);
+            if (!open->row) {
+                freePixels(file);
+                free(open);
+                return LV_RES_INV;
+            }
+        }
+    }
+
+    if (entry) {
+        entry->refs++;
+        entry->lastUse = ++useClock;
+        dsc->img_data = entry->pixels;
+    } else {
+        dsc->img_data = NULL;
+    }
+    open->entry = entry;
+    dsc->user_data = open;
+    return LV_RES_OK;
+}
+
+static lv_res_t readLineCb(lv_img_decoder_t *, lv_img_decoder_dsc_t *dsc, lv_coord_t x, lv_coord_t y,
+                           lv_coord_t len, uint8_t *buf)
+{
+    OpenImage *open = (OpenImage *)dsc->user_data;
+    if (!open || !open->row) return LV_RES_INV;
+    const img_pack_header_t *h = open->header;
+    // LVGL asks for a row in several pieces; decode it once
+    if (open->rowY != y) {
+        decodeRow(h, y, open->row);
+        open->rowY = y;
+        stats[h->id < img_pack_asset_count ? h->id : 0].rowDecodes++;
+    }
+    memcpy(buf, open->row + (size_t)x * h->pixel_size, (size_t)len * h->pixel_size);
+    return LV_RES_OK;
+}
+
+static void closeCb(lv_img_decoder_t *, lv_img_decoder_dsc_t *dsc)
+{
+    OpenImage *open = (OpenImage *)dsc->user_data;
+    if (!open) return;
+    if (open->entry) open->entry->refs--;
+    if (open->file) freePixels(open->file);
+    free(open->row);
+    free(open);
+    dsc->user_data = NULL;
+}
+
+static void prefetchScreen(const img_pack_screen_t &screen)
+{
+    for (uint16_t i = 0; i < screen.image_count && prefetchCount < IMG_PACK_PREFETCH_QUEUE; i++) {
+        if (!cacheFind(screen.images[i])) prefetchQueue[prefetchCount++] = screen.images[i];
+    }
+}
+
+// Load start: the screen's own images, for the frames of the transition;
+// loaded: the screens that can come next
+static void screenEventCb(lv_event_t *e)
+{
+    const img_pack_screen_t *shown = (const img_pack_screen_t *)lv_event_get_user_data(e);
+    prefetchHead = prefetchCount = 0;
+    if (lv_event_get_code(e) == LV_EVENT_SCREEN_LOAD_START) {
+        prefetchScreen(*shown);
+        return;
+    }
+    for (uint16_t i = 0; i < img_pack_screen_count; i++) {
+        if (&img_pack_screens[i] != shown) prefetchScreen(img_pack_screens[i]);
+    }
+}
+
+void imgPackWatchScreens(void)
+{
+    lv_obj_t *active = lv_scr_act();
+    for (uint16_t i = 0; i < img_pack_screen_count; i++) {
+        const img_pack_screen_t &screen = img_pack_screens[i];
+        if (!*screen.screen) continue;
+        lv_obj_add_event_cb(*screen.screen, screenEventCb, LV_EVENT_SCREEN_LOAD_START, (void *)&screen);
+        lv_obj_add_event_cb(*screen.screen, screenEventCb, LV_EVENT_SCREEN_LOADED, (void *)&screen);
+    }
+    // ui_init() already loaded the first screen
+    for (uint16_t i = 0; i < img_pack_screen_count; i++) {
+        if (*img_pack_screens[i].screen != active) prefetchScreen(img_pack_screens[i]);
+    }
+}
+
+bool imgPackPrefetchPoll(void)
+{
+    while (prefetchHead < prefetchCount) {
+        const lv_img_dsc_t *img = prefetchQueue[prefetchHead++];
+        if (!imgPackIsPacked(img) || cacheFind(img)) continue;
+        // Prefetching never pushes out what is on screen; skip what does not fit
+        if (!cacheMakeRoom(decodedBytes(img), false)) continue;
+
+        ImagePackStats &s = statsOf(img);
+        uint8_t *file;
+        const img_pack_header_t *h = imageHeader(img, s, &file);
+        if (!h) continue;
+        if (cacheDecode(img, h, s, false)) s.prefetches++;
+        freePixels(file);
+        return true;
+    }
+    return false;
+}
+
+void imgPackInit(size_t cacheBytes)
+{
+    cacheBudget = cacheBytes;
+    stats = (ImagePackStats *)calloc(img_pack_asset_count ? img_pack_asset_count : 1, sizeof(ImagePackStats));
+
+    lv_img_decoder_t *decoder = lv_img_decoder_create();
+    lv_img_decoder_set_info_cb(decoder, infoCb);
+    lv_img_decoder_set_open_cb(decoder, openCb);
+    lv_img_decoder_set_read_line_cb(decoder, readLineCb);
+    lv_img_decoder_set_close_cb(decoder, closeCb);
+}
+
+const ImagePackStats *imgPackStats(uint16_t index)
+{
+    return index < img_pack_asset_count ? &stats[index] : NULL;
+}
+
+size_t imgPackCacheUsed(void)
+{
+    return cacheUsed;
+}
+
+size_t imgPackCachePeak(void)
+{
+    return cachePeak;
+}
+
+void imgPackResetStats(void)
+{
+    memset(stats, 0, sizeof(ImagePackStats) * img_pack_asset_count);
+    cachePeak = cacheUsed;
+}
+
+#endif
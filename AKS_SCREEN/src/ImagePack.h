@@ -0,0 +1,113 @@
+/*
+ * AKS Screen - packed image decoder and decoded-image cache
+ * Decodes the images packed by tools/img_pack (built with the
+ * esp32s3dev_ui_packed environment). A packed image keeps its lv_img_dsc_t
+ * symbol, with header.cf LV_IMG_CF_RAW (was TRUE_COLOR) or RAW_ALPHA (was
+ * TRUE_COLOR_ALPHA) and data pointing at an img_pack_header_t.
+ *
+ * Decoded images are kept in a cache with a byte budget and evicted least
+ * recently used first. LVGL's own image cache should be off
+ * (LV_IMG_CACHE_DEF_SIZE=0) so this one decides what stays decoded. An
+ * image larger than the whole budget is never cached; it is decoded row by
+ * row as LVGL draws it, which costs time on every frame but no memory.
+ *
+ * With the esp32s3dev_ui_fs environment the packed images live in LittleFS
+ * and each symbol's data is an img_pack_file_ref_t instead: the file is
+ * read through lv_fs (src/AssetFs.h) on a cache miss. imgPackWatchScreens()
+ * then queues the images of the other screens whenever one is loaded, and
+ * imgPackPrefetchPoll() decodes them ahead of time while the budget allows,
+ * so a screen change finds its images cached (also works for images packed
+ * into flash).
+ *
+ * Also builds for the host (tools/ui_bench), so no Arduino types here.
+ */
+
+#ifndef IMAGE_PACK_H
+#define IMAGE_PACK_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <lvgl.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define IMG_PACK_RLE      1   // run-length coded pixels
+#define IMG_PACK_PALETTE  2   // run-length coded 1-byte palette indices
+
+typedef struct {
+    char magic[4];            // "AKP1"
+    uint16_t id;              // index into img_pack_assets
+    uint8_t encoding;         // IMG_PACK_*
+    uint8_t pixel_size;       // 2 = RGB565, 3 = RGB565 + alpha
+    uint16_t w;
+    uint16_t h;
+    uint16_t palette_size;    // entries, IMG_PACK_PALETTE only
+    uint16_t reserved;
+    // then palette_size * pixel_size bytes of palette, uint32_t offset of
+    // each row (from the first row), and the rows. Each row is a run of
+    // control bytes: c < 0x80 is followed by c+1 literal units, otherwise
+    // one unit repeated (c & 0x7F) + 1 times. A unit is a pixel, or an
+    // index with IMG_PACK_PALETTE.
+} __attribute__((packed)) img_pack_header_t;
+
+// Data of an image stored in LittleFS (esp32s3dev_ui_fs)
+typedef struct {
+    char magic[4];            // "AKF1"
+    uint16_t id;              // index into img_pack_assets
+    uint16_t path_length;
+    uint32_t file_size;       // bytes of the img_pack_header_t image in the file
+    // then the lv_fs path, NUL terminated, e.g. "L:/img/ebike_bg_png.akp"
+} __attribute__((packed)) img_pack_file_ref_t;
+
+// Every image the packer saw, packed or left raw (generated)
+typedef struct {
+    const char *name;
+    const lv_img_dsc_t *img;
+    uint32_t raw_size;        // bytes before packing
+} img_pack_asset_t;
+
+extern const img_pack_asset_t img_pack_assets[];
+extern const uint16_t img_pack_asset_count;
+
+// Images used by each SquareLine screen (generated)
+typedef struct {
+    const char *name;
+    lv_obj_t **screen;
+    const lv_img_dsc_t *const *images;
+    uint16_t image_count;
+} img_pack_screen_t;
+
+extern const img_pack_screen_t img_pack_screens[];
+extern const uint16_t img_pack_screen_count;
+
+typedef struct {
+    uint32_t hits;            // opened from the cache
+    uint32_t misses;          // had to be decoded
+    uint32_t decodeUs;        // total time of whole-image decodes
+    uint32_t rowDecodes;      // rows decoded for images drawn uncached
+    uint32_t loads;           // files read from LittleFS
+    uint32_t loadUs;          // total time of those reads
+    uint32_t prefetches;      // decoded by imgPackPrefetchPoll() before use
+} ImagePackStats;
+
+// Registers the decoder; call after lv_init() and before ui_init()
+void imgPackInit(size_t cacheBytes);
+// Per-asset counters, indexed like img_pack_assets
+const ImagePackStats *imgPackStats(uint16_t index);
+bool imgPackIsPacked(const lv_img_dsc_t *img);
+bool imgPackIsFile(const lv_img_dsc_t *img);
+// Prefetch the other screens' images on every screen load; after ui_init()
+void imgPackWatchScreens(void);
+// Decodes one queued image if it fits without evicting; false when idle
+bool imgPackPrefetchPoll(void);
+size_t imgPackCacheUsed(void);
+size_t imgPackCachePeak(void);
+void imgPackResetStats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
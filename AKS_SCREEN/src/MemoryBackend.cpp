@@ -0,0 +1,23 @@
+#include "MemoryBackend.h"
+#include <stdlib.h>
+#include <string.h>
+
+MemoryBackend::~MemoryBackend()
+{
+    free(frame);
+}
+
+bool MemoryBackend::begin()
+{
+    if (!frame) frame = (lv_color_t *)calloc((size_t)hor * ver, sizeof(lv_color_t));
+    return frame != nullptr;
+}
+
+void MemoryBackend::flush(int32_t x, int32_t y, uint32_t w, uint32_t h, lv_color_t *pixels, uint32_t stride)
+{
+    lv_color_t *dest = &frame[(uint32_t)y * hor + x];
+    if (pixels == dest) return;    // rendered in place
+    for (uint32_t row = 0; row < h; row++) {
+        memcpy(&dest[row * hor], &pixels[row * stride], w * sizeof(lv_color_t));
+    }
+}
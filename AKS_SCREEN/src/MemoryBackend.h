@@ -0,0 +1,36 @@
+/*
+ * AKS Screen - memory display backend
+ * A frame in RAM standing in for the panel, so the draw and flush path can
+ * run and be measured without hardware (tools/ui_bench builds it on the
+ * host). Flushed rectangles are copied into the frame. The frame is also
+ * offered as the panel's own frame buffer, the way the RGB backend offers
+ * its PSRAM frame: rendering straight into it makes the flush a no-op.
+ */
+
+#ifndef MEMORY_BACKEND_H
+#define MEMORY_BACKEND_H
+
+#include "DisplayBackend.h"
+
+class MemoryBackend : public DisplayBackend {
+public:
+    MemoryBackend(uint16_t width, uint16_t height) : hor(width), ver(height) {}
+    ~MemoryBackend() override;
+
+    bool begin() override;
+    const char *name() const override { return "memory"; }
+    uint16_t width() const override { return hor; }
+    uint16_t height() const override { return ver; }
+    void flush(int32_t x, int32_t y, uint32_t w, uint32_t h, lv_color_t *pixels, uint32_t stride) override;
+    lv_color_t *frameBuffer(bool &psram) override { psram = false; return frame; }
+
+    // What the panel would show
+    const lv_color_t *pixels() const { return frame; }
+
+private:
+    uint16_t hor;
+    uint16_t ver;
+    lv_color_t *frame = nullptr;
+};
+
+#endif
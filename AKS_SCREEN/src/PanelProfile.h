@@ -0,0 +1,38 @@
+/*
+ * AKS Screen - panel profiles
+ * -D DISPLAY_PANEL=<n> picks the panel at build time. A profile fixes the
+ * resolution, the backend (DisplayBackend.h) and the default draw buffer
+ * strategy:
+ *
+ *   PANEL_ILI9341_SPI  240x320 ILI9341 on SPI through TFT_eSPI, used in
+ *                      landscape. Pins are TFT_eSPI's build flags.
+ *   PANEL_CROWPANEL_7  Elecrow CrowPanel ESP32-S3 7.0", 800x480 16-bit
+ *                      RGB on the LCD peripheral, the resolution the
+ *                      SquareLine dashboard is drawn for. Pins and timing
+ *                      are in RgbPanelBackend.cpp.
+ */
+
+#ifndef PANEL_PROFILE_H
+#define PANEL_PROFILE_H
+
+#define PANEL_ILI9341_SPI 1
+#define PANEL_CROWPANEL_7 2
+
+#ifndef DISPLAY_PANEL
+#define DISPLAY_PANEL PANEL_ILI9341_SPI
+#endif
+
+#if DISPLAY_PANEL == PANEL_ILI9341_SPI
+#define PANEL_WIDTH        320
+#define PANEL_HEIGHT       240
+#define PANEL_ROTATION     1             // TFT_eSPI rotation: landscape
+#define PANEL_BUF_STRATEGY DISP_BUF_PARTIAL
+#elif DISPLAY_PANEL == PANEL_CROWPANEL_7
+#define PANEL_WIDTH        800
+#define PANEL_HEIGHT       480
+#define PANEL_BUF_STRATEGY DISP_BUF_PANEL
+#else
+#error "Unknown DISPLAY_PANEL"
+#endif
+
+#endif
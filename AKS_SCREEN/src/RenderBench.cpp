@@ -0,0 +1,101 @@
+#include "RenderBench.h"
+#if AKS_SCREEN_UI
+#include <ui.h>
+#endif
+
+struct BenchScreen {
+    const char *name;
+    lv_obj_t *screen;
+};
+
+static const DisplayConfig BENCH_CONFIGS[] = {
+    { DISP_BUF_PARTIAL, 10, false },
+    { DISP_BUF_PARTIAL, 10, true },
+    { DISP_BUF_PARTIAL, 40, true },
+    { DISP_BUF_FULL, 0, false },
+    { DISP_BUF_DIRECT, 0, false },
+    { DISP_BUF_PANEL, 0, false },
+};
+
+static void printResult(Print &out, const char *pass, const FrameStats &s, uint32_t totalUs)
+{
+    if (s.frames == 0) {
+        out.printf("    %-8s no frames\n", pass);
+        return;
+    }
+    // totalUs covers only rendering and flushing for the redraw pass; the
+    // animated pass also idles, so its busy time comes from LVGL's monitor
+    uint32_t busyUs = totalUs ? totalUs : s.refreshMs * 1000;
+    uint32_t renderUs = busyUs > s.flushUs + s.waitUs ? busyUs - s.flushUs - s.waitUs : 0;
+    float fps = totalUs ? s.frames * 1e6f / totalUs : s.frames * 1000.0f / RENDER_BENCH_ANIM_MS;
+    out.printf("    %-8s %6.1f fps | render %6.2f ms | flush %6.2f ms | wait %6.2f ms | %6u px/frame\n",
+               pass, fps, renderUs / 1000.0f / s.frames, s.flushUs / 1000.0f / s.frames,
+               s.waitUs / 1000.0f / s.frames, s.pixels / s.frames);
+}
+
+static void benchScreen(Display &display, Print &out, const BenchScreen &screen)
+{
+    FrameStats stats;
+    lv_disp_t *disp = display.disp();
+    lv_disp_load_scr(screen.screen);
+    lv_refr_now(disp);
+    display.finishFlush();
+
+    display.takeStats(stats);
+    uint32_t start = micros();
+    for (int i = 0; i < RENDER_BENCH_FRAMES; i++) {
+        lv_obj_invalidate(screen.screen);
+        lv_refr_now(disp);
+        display.finishFlush();
+    }
+    uint32_t totalUs = micros() - start;
+    display.takeStats(stats);
+    out.printf("  %s\n", screen.name);
+    printResult(out, "redraw", stats, totalUs);
+
+    uint32_t startMs = millis();
+    while (millis() - startMs < RENDER_BENCH_ANIM_MS) {
+        display.poll();
+        lv_timer_handler();
+    }
+    display.finishFlush();
+    display.takeStats(stats);
+    printResult(out, "animated", stats, 0);
+}
+
+void renderBenchRun(Display &display, Print &out)
+{
+    const DisplayConfig original = display.config();
+    lv_obj_t *originalScreen = lv_disp_get_scr_act(display.disp());
+
+#if AKS_SCREEN_UI
+    const BenchScreen screens[] = { { "ui_Home", ui_Home }, { "ui_Settings", ui_Settings } };
+#else
+    const BenchScreen screens[] = { { "demo", originalScreen } };
+#endif
+
+    out.printf("=== Render benchmark (%s, %ux%u) ===\n", display.backend().name(),
+               display.backend().width(), display.backend().height());
+    for (const DisplayConfig &config : BENCH_CONFIGS) {
+        if (config.strategy == DISP_BUF_PARTIAL) {
+            out.printf("%s, %u lines, %s", Display::strategyName(config.strategy), config.lines,
+                       config.dma ? "2 buffers + DMA" : "1 buffer, blocking");
+        } else {
+            out.printf("%s", Display::strategyName(config.strategy));
+        }
+        if (!display.configure(config)) {
+            out.println(config.strategy == DISP_BUF_PANEL ? ": skipped, the panel has no frame buffer"
+                                                          : ": skipped, buffers do not fit");
+            continue;
+        }
+        out.printf(" (%u KB %s)\n", (unsigned)(display.bufferBytes() / 1024),
+                   display.buffersInPsram() ? "PSRAM" : "internal");
+        for (const BenchScreen &screen : screens) {
+            benchScreen(display, out, screen);
+        }
+    }
+
+    display.configure(original);
+    lv_disp_load_scr(originalScreen);
+    out.println("=== Render benchmark done ===");
+}
@@ -0,0 +1,28 @@
+/*
+ * AKS Screen - built-in render benchmark
+ * Renders each dashboard screen with every draw-buffer strategy (see
+ * Display.h) and prints fps, render time and flush time per frame, so the
+ * buffer layout for a panel can be picked from measurements. Two passes
+ * per screen and strategy:
+ *
+ *   redraw    the whole screen invalidated and refreshed
+ *             RENDER_BENCH_FRAMES times: worst case, repeatable
+ *   animated  RENDER_BENCH_ANIM_MS of normal running with no loop delay,
+ *             so only what the animations invalidate is redrawn
+ *
+ * Runs at boot with -D RENDER_BENCH=1, or when 'b' arrives on Serial.
+ * The display configuration and screen are restored afterwards.
+ */
+
+#ifndef RENDER_BENCH_H
+#define RENDER_BENCH_H
+
+#include <Arduino.h>
+#include "Display.h"
+
+#define RENDER_BENCH_FRAMES  30
+#define RENDER_BENCH_ANIM_MS 2000
+
+void renderBenchRun(Display &display, Print &out);
+
+#endif
@@ -0,0 +1,83 @@
+#include "PanelProfile.h"
+#if DISPLAY_PANEL == PANEL_CROWPANEL_7
+
+#include "RgbPanelBackend.h"
+#include <esp_idf_version.h>
+#include <esp_lcd_panel_ops.h>
+
+// Pins and timing from Elecrow's CrowPanel 7.0" examples
+const RgbPanelConfig RGB_PANEL_CROWPANEL_7 = {
+    800, 480, 15000000,
+    48, 40, 40,                        // hsync pulse, back, front porch
+    31, 13, 1,                         // vsync
+    true,
+    41, 40, 39, 0,                     // DE, VSYNC, HSYNC, PCLK
+    { 15, 7, 6, 5, 4, 9, 46, 3, 8, 16, 1, 14, 21, 47, 48, 45 },
+    2,
+};
+
+bool RgbPanelBackend::begin()
+{
+    esp_lcd_rgb_panel_config_t panelConfig = {};
+    panelConfig.clk_src = LCD_CLK_SRC_PLL160M;
+    panelConfig.timings.pclk_hz = config.pclkHz;
+    panelConfig.timings.h_res = config.width;
+    panelConfig.timings.v_res = config.height;
+    panelConfig.timings.hsync_pulse_width = config.hsyncPulse;
+    panelConfig.timings.hsync_back_porch = config.hsyncBack;
+    panelConfig.timings.hsync_front_porch = config.hsyncFront;
+    panelConfig.timings.vsync_pulse_width = config.vsyncPulse;
+    panelConfig.timings.vsync_back_porch = config.vsyncBack;
+    panelConfig.timings.vsync_front_porch = config.vsyncFront;
+    panelConfig.timings.flags.pclk_active_neg = config.pclkActiveNeg;
+    panelConfig.data_width = 16;
+    panelConfig.psram_trans_align = 64;
+    panelConfig.de_gpio_num = config.de;
+    panelConfig.vsync_gpio_num = config.vsync;
+    panelConfig.hsync_gpio_num = config.hsync;
+    panelConfig.pclk_gpio_num = config.pclk;
+    panelConfig.disp_gpio_num = -1;
+    for (int i = 0; i < 16; i++) {
+        panelConfig.data_gpio_nums[i] = config.data[i];
+    }
+    panelConfig.flags.fb_in_psram = 1;
+#if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 0, 0)
+    panelConfig.bounce_buffer_size_px = config.width * RGB_BOUNCE_LINES;
+#endif
+
+    if (esp_lcd_new_rgb_panel(&panelConfig, &panel) != ESP_OK) return false;
+    esp_lcd_panel_reset(panel);
+    esp_lcd_panel_init(panel);
+
+#if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 0, 0)
+    void *fb = nullptr;
+    if (esp_lcd_rgb_panel_get_frame_buffer(panel, 1, &fb) == ESP_OK) frame = (lv_color_t *)fb;
+#endif
+
+    if (config.backlight >= 0) {
+        pinMode(config.backlight, OUTPUT);
+        digitalWrite(config.backlight, HIGH);
+    }
+    return true;
+}
+
+void RgbPanelBackend::flush(int32_t x, int32_t y, uint32_t w, uint32_t h, lv_color_t *pixels, uint32_t stride)
+{
+    uint32_t framePixels = (uint32_t)config.width * config.height;
+    if (frame && pixels >= frame && pixels < frame + framePixels) {
+        // Rendered in place. Handing the driver the frame itself copies
+        // nothing; it only writes the dirty lines back from the cache.
+        esp_lcd_panel_draw_bitmap(panel, x, y, x + w, y + h, frame);
+        return;
+    }
+    // Copied into the frame by the CPU, one call per row unless packed
+    if (stride == w) {
+        esp_lcd_panel_draw_bitmap(panel, x, y, x + w, y + h, pixels);
+        return;
+    }
+    for (uint32_t row = 0; row < h; row++) {
+        esp_lcd_panel_draw_bitmap(panel, x, y + row, x + w, y + row + 1, &pixels[row * stride]);
+    }
+}
+
+#endif
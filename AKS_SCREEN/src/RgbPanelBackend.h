@@ -0,0 +1,65 @@
+/*
+ * AKS Screen - ESP32-S3 RGB panel display backend
+ * Parallel RGB panels on the ESP32-S3 LCD peripheral (esp_lcd). The panel
+ * has no memory of its own: the peripheral scans a full frame out of PSRAM
+ * continuously, 750 KB at 800x480. With ESP-IDF 5 (Arduino-ESP32 3.x) the
+ * LCD DMA reads from two bounce buffers of RGB_BOUNCE_LINES lines in
+ * internal RAM that the CPU refills from the frame, so PSRAM traffic from
+ * the app cannot starve the scan-out and shift the picture. The frame is
+ * offered to Display for DISP_BUF_PANEL, where LVGL renders into it
+ * directly.
+ *
+ * ESP-IDF 4.4 has neither bounce buffers nor access to the frame: every
+ * flush is copied into it and the other strategies have to be used.
+ */
+
+#ifndef RGB_PANEL_BACKEND_H
+#define RGB_PANEL_BACKEND_H
+
+#include <Arduino.h>
+#include <esp_lcd_panel_rgb.h>
+#include "DisplayBackend.h"
+
+#ifndef RGB_BOUNCE_LINES
+#define RGB_BOUNCE_LINES 10            // the frame height must be a multiple
+#endif
+
+struct RgbPanelConfig {
+    uint16_t width;
+    uint16_t height;
+    uint32_t pclkHz;
+    uint16_t hsyncPulse;
+    uint16_t hsyncBack;
+    uint16_t hsyncFront;
+    uint16_t vsyncPulse;
+    uint16_t vsyncBack;
+    uint16_t vsyncFront;
+    bool pclkActiveNeg;                // data latched on the falling edge
+    int8_t de;
+    int8_t vsync;
+    int8_t hsync;
+    int8_t pclk;
+    int8_t data[16];                   // B0-B4, G0-G5, R0-R4
+    int8_t backlight;                  // -1 if always on
+};
+
+class RgbPanelBackend : public DisplayBackend {
+public:
+    explicit RgbPanelBackend(const RgbPanelConfig &config) : config(config) {}
+
+    bool begin() override;
+    const char *name() const override { return "ESP32-S3 RGB"; }
+    uint16_t width() const override { return config.width; }
+    uint16_t height() const override { return config.height; }
+    void flush(int32_t x, int32_t y, uint32_t w, uint32_t h, lv_color_t *pixels, uint32_t stride) override;
+    lv_color_t *frameBuffer(bool &psram) override { psram = true; return frame; }
+
+private:
+    const RgbPanelConfig &config;
+    esp_lcd_panel_handle_t panel = nullptr;
+    lv_color_t *frame = nullptr;
+};
+
+extern const RgbPanelConfig RGB_PANEL_CROWPANEL_7;
+
+#endif
@@ -0,0 +1,162 @@
+#include "TelemetryBinding.h"
+#include <math.h>
+
+#if AKS_SCREEN_UI
+#include <ui.h>
+
+const TelemetryBind TELEMETRY_DASHBOARD[] = {
+    // ui_Label_Speed is the "Speed" caption; the speed itself is drawn twice
+    { &ui_Speed_Number_1,          TELEM_SPEED_KMH,       BIND_LABEL,  0, 0 },
+    { &ui_Speed_Number_2,          TELEM_SPEED_KMH,       BIND_LABEL,  0, 0 },
+    { &ui_Slider_Speed,            TELEM_SPEED_KMH,       BIND_SLIDER, 0, 0 },
+    { &ui_Slider_Battery,          TELEM_BATTERY_PERCENT, BIND_SLIDER, 0, 0 },
+    { &ui_Label_Battery_Number,    TELEM_BATTERY_PERCENT, BIND_LABEL,  0, 0 },
+    { &ui_Label_Temp2,             TELEM_BATTERY_TEMP_C,  BIND_LABEL,  1, BIND_SIGNED },
+    { &ui_Label_Temp5,             TELEM_BATTERY_TEMP_C,  BIND_LABEL,  1, BIND_SIGNED },
+    // On Home the names are swapped: ui_Label_AVG_Speed_Number sits under
+    // the "MAX. SPEED" caption and ui_Label_Max_Speed_Number under "AV. SPEED"
+    { &ui_Label_AVG_Speed_Number,  TELEM_MAX_SPEED_KMH,   BIND_LABEL,  1, 0 },
+    { &ui_Label_Max_Speed_Number,  TELEM_AVG_SPEED_KMH,   BIND_LABEL,  1, 0 },
+    { &ui_Label_Max_Speed_Number1, TELEM_MAX_SPEED_KMH,   BIND_LABEL,  1, 0 },
+    { &ui_Label_AVG_Speed_Number1, TELEM_AVG_SPEED_KMH,   BIND_LABEL,  1, 0 },
+};
+const uint8_t TELEMETRY_DASHBOARD_COUNT = sizeof(TELEMETRY_DASHBOARD) / sizeof(TELEMETRY_DASHBOARD[0]);
+#endif
+
+static const int32_t POW10[] = { 1, 10, 100, 1000 };
+
+bool TelemetryBinding::begin(const TelemetryBind *binds, uint8_t count, UiQueue *queue)
+{
+    if (count > TELEMETRY_MAX_BINDS) return false;
+    table = binds;
+    tableSize = count;
+    commands = queue;
+
+    lv_disp_t *disp = lv_disp_get_default();
+    uint32_t period = disp && disp->refr_timer ? disp->refr_timer->period : LV_DISP_DEF_REFR_PERIOD;
+    timer = lv_timer_create(timerCb, period, this);
+    return timer != NULL;
+}
+
+void TelemetryBinding::timerCb(lv_timer_t *timer)
+{
+    ((TelemetryBinding *)timer->user_data)->apply();
+}
+
+void TelemetryBinding::setCb(void *target, uint32_t field, UiValue value)
+{
+    ((TelemetryBinding *)target)->store(field, value.f);
+}
+
+// update()'s side: straight in, or through the queue to the render task.
+// A dropped value is only late; the next sample carries the field again.
+void TelemetryBinding::set(uint8_t field, float value)
+{
+    if (commands) {
+        commands->submit(setCb, this, field, value);
+    } else {
+        store(field, value);
+    }
+}
+
+void TelemetryBinding::store(uint8_t field, float value)
+{
+    values[field] = value;
+    valid |= 1UL << field;
+    dirty |= 1UL << field;
+    if (timer) lv_timer_ready(timer);
+}
+
+void TelemetryBinding::update(const GeneratorLink &link)
+{
+    if (!link.connected()) return;
+
+    const AksFastBlock &fast = link.fast();
+    if (fast.timestamp_ms != lastFastTs) {
+        float speed = fast.speed_centikmh / 100.0f;
+        if (lastFastTs && firstTs) {
+            distanceKm += speed * (fast.timestamp_ms - lastFastTs) / 3600000.0f;
+        } else {
+            firstTs = fast.timestamp_ms;
+        }
+        lastFastTs = fast.timestamp_ms;
+        if (speed > maxSpeed) maxSpeed = speed;
+
+        set(TELEM_SPEED_KMH, speed);
+        set(TELEM_MAX_SPEED_KMH, maxSpeed);
+        uint32_t elapsedMs = fast.timestamp_ms - firstTs;
+        if (elapsedMs) set(TELEM_AVG_SPEED_KMH, distanceKm * 3600000.0f / elapsedMs);
+        samples++;
+    }
+
+    const AksSlowBlock &slow = link.slow();
+    if (slow.timestamp_ms != lastSlowTs) {
+        lastSlowTs = slow.timestamp_ms;
+        set(TELEM_BATTERY_PERCENT, slow.remaining_energy_Wh * 100.0f / TELEMETRY_BATTERY_WH);
+        set(TELEM_BATTERY_TEMP_C, slow.battery_temp_deciC / 10.0f);
+        set(TELEM_BATTERY_VOLTAGE_V, slow.battery_voltage_deciV / 10.0f);
+        set(TELEM_MOTOR_TEMP_C, slow.motor_temp_deciC / 10.0f);
+        samples++;
+    }
+}
+
+void TelemetryBinding::apply()
+{
+    if (dirty) stats.applies++;
+    for (uint8_t i = 0; i < tableSize; i++) {
+        const TelemetryBind &bind = table[i];
+        lv_obj_t *widget = *bind.widget;
+        uint32_t bit = 1UL << bind.field;
+        if (!widget || !(valid & bit)) continue;
+        // A screen created again still shows its SquareLine placeholders
+        bool renewed = widget != shown[i].widget;
+        if (!(dirty & bit) && !renewed) continue;
+
+        int32_t value = lroundf(values[bind.field] * POW10[bind.kind == BIND_LABEL ? bind.decimals : 0]);
+        if (!renewed && value == shown[i].value) {
+            stats.unchanged++;
+            continue;
+        }
+        if (write(bind, shown[i], widget, value)) stats.writes++;
+        shown[i].widget = widget;
+    }
+    dirty = 0;
+}
+
+bool TelemetryBinding::write(const TelemetryBind &bind, Shown &out, lv_obj_t *widget, int32_t value)
+{
+    if (bind.kind == BIND_SLIDER) {
+        int32_t min = lv_slider_get_min_value(widget);
+        int32_t max = lv_slider_get_max_value(widget);
+        int32_t clamped = value < min ? min : value > max ? max : value;
+        out.value = value;
+        if (out.widget == widget && lv_slider_get_value(widget) == clamped) return false;
+        lv_slider_set_value(widget, clamped, LV_ANIM_OFF);
+        return true;
+    }
+
+    const char *sign = value < 0 ? "-" : (bind.flags & BIND_SIGNED) ? "+" : "";
+    uint32_t magnitude = value < 0 ? -value : value;
+    if (bind.decimals) {
+        uint32_t scale = POW10[bind.decimals];
+        snprintf(out.text, sizeof(out.text), "%s%lu.%0*lu", sign, (unsigned long)(magnitude / scale),
+                 bind.decimals, (unsigned long)(magnitude % scale));
+    } else {
+        snprintf(out.text, sizeof(out.text), "%s%lu", sign, (unsigned long)magnitude);
+    }
+    out.value = value;
+    // Same buffer every time: LVGL measures the new text and invalidates
+    // the label, without copying it to its heap
+    lv_label_set_text_static(widget, out.text);
+    return true;
+}
+
+void TelemetryBinding::takeStats(BindingStats &out)
+{
+    // samples only ever grows, so update() can count without a lock
+    uint32_t total = samples;
+    stats.samples = total - samplesTaken;
+    samplesTaken = total;
+    out = stats;
+    stats = {};
+}
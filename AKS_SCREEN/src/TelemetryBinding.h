@@ -0,0 +1,124 @@
+/*
+ * AKS Screen - telemetry to dashboard widgets
+ * Maps generator fields to SquareLine widgets through a table of bindings.
+ * Samples only update the field values; apply() runs from an LVGL timer
+ * with the display refresh period, so all widgets change together once per
+ * frame, and touches a widget only when the value it shows changed at its
+ * displayed precision. A label that reads "42" is left alone while the
+ * speed moves between 41.5 and 42.49, so it is neither re-laid out nor
+ * invalidated.
+ *
+ * Labels point at a text buffer owned by the binding
+ * (lv_label_set_text_static), so an update formats in place and LVGL
+ * allocates nothing. Sliders are clamped to their range.
+ *
+ * The widget pointers are read on every apply(): a screen that is
+ * destroyed and created again (ui_*_screen_destroy) is picked up and
+ * written in full on the next refresh.
+ *
+ * With a UiQueue, update() runs in loop() next to the I2C polling and
+ * hands each new value to the render task as a command; apply() is made
+ * due as soon as one arrives, so it lands on the frame that follows.
+ */
+
+#ifndef TELEMETRY_BINDING_H
+#define TELEMETRY_BINDING_H
+
+#include <Arduino.h>
+#include <lvgl.h>
+#include "GeneratorLink.h"
+#include "UiQueue.h"
+
+#ifndef TELEMETRY_BATTERY_WH
+#define TELEMETRY_BATTERY_WH 50000     // VEHICLE_DEFAULT_PARAMS.energyWh, for the SOC
+#endif
+#define TELEMETRY_MAX_BINDS  24
+#define TELEMETRY_TEXT_SIZE  12        // per label, with the terminator
+
+enum TelemetryField : uint8_t {
+    TELEM_SPEED_KMH,
+    TELEM_MAX_SPEED_KMH,               // since boot
+    TELEM_AVG_SPEED_KMH,               // distance over time since the first sample
+    TELEM_BATTERY_PERCENT,             // remaining energy over TELEMETRY_BATTERY_WH
+    TELEM_BATTERY_TEMP_C,
+    TELEM_BATTERY_VOLTAGE_V,
+    TELEM_MOTOR_TEMP_C,
+    TELEM_FIELD_COUNT
+};
+
+#define BIND_LABEL   0
+#define BIND_SLIDER  1
+
+#define BIND_SIGNED  0x01              // labels: always show the sign ("+21.0")
+
+struct TelemetryBind {
+    lv_obj_t **widget;                 // a SquareLine global, NULL while its screen is not created
+    uint8_t field;                     // TelemetryField
+    uint8_t kind;                      // BIND_*
+    uint8_t decimals;                  // labels: digits after the point
+    uint8_t flags;                     // BIND_SIGNED
+};
+
+// Accumulated since the last takeStats()
+struct BindingStats {
+    uint32_t samples;                  // generator samples taken in
+    uint32_t applies;                  // apply() calls with new values
+    uint32_t writes;                   // widgets changed
+    uint32_t unchanged;                // bound values that did not change on screen
+};
+
+class TelemetryBinding {
+public:
+    // Hooks apply() to the display refresh; call after ui_init(). With a
+    // queue, update() may run in another task than LVGL.
+    bool begin(const TelemetryBind *binds, uint8_t count, UiQueue *queue = nullptr);
+
+    // Takes a new sample from the link, if there is one; call from loop()
+    void update(const GeneratorLink &link);
+    // Writes the changed values to their widgets (runs from an LVGL timer)
+    void apply();
+
+    float value(uint8_t field) const { return values[field]; }
+    void takeStats(BindingStats &out);
+
+private:
+    struct Shown {
+        lv_obj_t *widget;              // what was written to, to notice a new screen
+        int32_t value;                 // at the displayed precision
+        char text[TELEMETRY_TEXT_SIZE];
+    };
+
+    static void timerCb(lv_timer_t *timer);
+    static void setCb(void *target, uint32_t field, UiValue value);
+    void set(uint8_t field, float value);
+    void store(uint8_t field, float value);
+    bool write(const TelemetryBind &bind, Shown &shown, lv_obj_t *widget, int32_t value);
+
+    const TelemetryBind *table = nullptr;
+    uint8_t tableSize = 0;
+    UiQueue *commands = nullptr;
+    lv_timer_t *timer = nullptr;
+    Shown shown[TELEMETRY_MAX_BINDS] = {};
+    float values[TELEM_FIELD_COUNT] = {};
+    uint32_t valid = 0;                // fields with a value, one bit each
+    uint32_t dirty = 0;                // fields set since the last apply()
+
+    // update()'s side
+    uint32_t lastFastTs = 0;
+    uint32_t lastSlowTs = 0;
+    uint32_t firstTs = 0;
+    float distanceKm = 0;
+    float maxSpeed = 0;
+    volatile uint32_t samples = 0;     // since begin(), read by takeStats()
+
+    uint32_t samplesTaken = 0;
+    BindingStats stats = {};
+};
+
+#if AKS_SCREEN_UI
+// The SquareLine dashboard in temp_ui
+extern const TelemetryBind TELEMETRY_DASHBOARD[];
+extern const uint8_t TELEMETRY_DASHBOARD_COUNT;
+#endif
+
+#endif
@@ -0,0 +1,42 @@
+#include "PanelProfile.h"
+#if DISPLAY_PANEL == PANEL_ILI9341_SPI
+
+#include "TftBackend.h"
+
+bool TftBackend::begin()
+{
+    tft.begin();
+    tft.setRotation(rotation);
+    tft.setSwapBytes(true);    // LVGL renders RGB565 little endian, the panel wants big
+    return tft.initDMA();
+}
+
+void TftBackend::setQueued(bool on)
+{
+    if (on == queued) return;
+    if (on) tft.startWrite();
+    else tft.endWrite();
+    queued = on;
+}
+
+void TftBackend::flush(int32_t x, int32_t y, uint32_t w, uint32_t h, lv_color_t *pixels, uint32_t stride)
+{
+    if (queued) {
+        // Waits for the previous transfer, byte-swaps in place and queues
+        // this one
+        tft.pushImageDMA(x, y, w, h, (uint16_t *)&pixels->full);
+        return;
+    }
+    tft.startWrite();
+    tft.setAddrWindow(x, y, w, h);
+    if (stride == w) {
+        tft.pushColors((uint16_t *)&pixels->full, w * h, true);
+    } else {
+        for (uint32_t row = 0; row < h; row++) {
+            tft.pushColors((uint16_t *)&pixels[row * stride].full, w, true);
+        }
+    }
+    tft.endWrite();
+}
+
+#endif
@@ -0,0 +1,41 @@
+/*
+ * AKS Screen - TFT_eSPI display backend
+ * SPI panels driven by TFT_eSPI, configured through its build flags. A
+ * flush is a blocking push, or in queued mode a DMA transfer from the
+ * draw buffer: the panel is the only device on its SPI bus, so the bus
+ * stays claimed while queued and each flush only starts a transfer.
+ */
+
+#ifndef TFT_BACKEND_H
+#define TFT_BACKEND_H
+
+#include <Arduino.h>
+#include <TFT_eSPI.h>
+#include "DisplayBackend.h"
+
+class TftBackend : public DisplayBackend {
+public:
+    // Width and height as seen after the rotation
+    TftBackend(TFT_eSPI &tft, uint16_t width, uint16_t height, uint8_t rotation)
+        : tft(tft), hor(width), ver(height), rotation(rotation) {}
+
+    bool begin() override;
+    const char *name() const override { return "TFT_eSPI SPI"; }
+    uint16_t width() const override { return hor; }
+    uint16_t height() const override { return ver; }
+    void flush(int32_t x, int32_t y, uint32_t w, uint32_t h, lv_color_t *pixels, uint32_t stride) override;
+
+    bool canQueue() const override { return true; }
+    void setQueued(bool on) override;
+    bool busy() override { return tft.dmaBusy(); }
+    void wait() override { tft.dmaWait(); }
+
+private:
+    TFT_eSPI &tft;
+    uint16_t hor;
+    uint16_t ver;
+    uint8_t rotation;
+    bool queued = false;
+};
+
+#endif
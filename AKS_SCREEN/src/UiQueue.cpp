@@ -0,0 +1,62 @@
+#include "UiQueue.h"
+
+UiQueue::UiQueue() : head(0), droppedCount(0)
+{
+    for (uint32_t i = 0; i < UI_QUEUE_SIZE; i++) {
+        slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+bool UiQueue::submit(const UiCommand &command)
+{
+    uint32_t pos = head.load(std::memory_order_relaxed);
+    Slot *slot;
+    for (;;) {
+        slot = &slots[pos & MASK];
+        int32_t diff = (int32_t)(slot->sequence.load(std::memory_order_acquire) - pos);
+        if (diff == 0) {
+            // Free: claim it, or retry from wherever another producer left head
+            if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+        } else if (diff < 0) {
+            // Still holds the command from one lap ago: full
+            droppedCount.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        } else {
+            pos = head.load(std::memory_order_relaxed);
+        }
+    }
+    slot->command = command;
+    slot->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+bool UiQueue::submit(UiCommandFn fn, void *target, uint32_t arg, int32_t value)
+{
+    UiCommand command = { fn, target, arg, {} };
+    command.value.i = value;
+    return submit(command);
+}
+
+bool UiQueue::submit(UiCommandFn fn, void *target, uint32_t arg, float value)
+{
+    UiCommand command = { fn, target, arg, {} };
+    command.value.f = value;
+    return submit(command);
+}
+
+uint16_t UiQueue::drain()
+{
+    uint16_t count = 0;
+    while (count < UI_QUEUE_SIZE) {
+        Slot &slot = slots[tail & MASK];
+        // A claimed slot whose producer has not finished writing stops the
+        // drain; it runs next frame
+        if (slot.sequence.load(std::memory_order_acquire) != tail + 1) break;
+        UiCommand command = slot.command;
+        slot.sequence.store(tail + UI_QUEUE_SIZE, std::memory_order_release);
+        tail++;
+        command.fn(command.target, command.arg, command.value);
+        count++;
+    }
+    return count;
+}
@@ -0,0 +1,72 @@
+/*
+ * AKS Screen - UI command queue
+ * LVGL is not thread safe and belongs to the render task (UiTask.h). Any
+ * other task changes the UI by submitting a command, a function with a
+ * target and two arguments, which the render task runs at the start of
+ * its next frame, in submission order.
+ *
+ * The queue is a fixed ring of UI_QUEUE_SIZE slots, each with a sequence
+ * number (D. Vyukov's bounded queue): producers claim a slot with one
+ * compare-and-swap on the head and never block, so submit() may be called
+ * from any task, on either core, with the render task in any state. When
+ * the ring is full the command is dropped and counted; nothing waits for
+ * the render task. Only the render task calls drain().
+ */
+
+#ifndef UI_QUEUE_H
+#define UI_QUEUE_H
+
+#include <stdint.h>
+#include <atomic>
+
+#ifndef UI_QUEUE_SIZE
+#define UI_QUEUE_SIZE 64               // power of two
+#endif
+
+union UiValue {
+    int32_t i;
+    float f;
+    const void *p;
+};
+
+typedef void (*UiCommandFn)(void *target, uint32_t arg, UiValue value);
+
+struct UiCommand {
+    UiCommandFn fn;
+    void *target;
+    uint32_t arg;
+    UiValue value;
+};
+
+class UiQueue {
+public:
+    UiQueue();
+
+    // Any task; false if the queue is full and the command was dropped
+    bool submit(const UiCommand &command);
+    bool submit(UiCommandFn fn, void *target, uint32_t arg = 0, int32_t value = 0);
+    bool submit(UiCommandFn fn, void *target, uint32_t arg, float value);
+
+    // Render task: runs the commands queued so far, at most one ring's
+    // worth, so commands that submit commands run next frame. Returns how
+    // many ran.
+    uint16_t drain();
+
+    uint32_t dropped() const { return droppedCount.load(std::memory_order_relaxed); }
+
+private:
+    static const uint32_t MASK = UI_QUEUE_SIZE - 1;
+    static_assert((UI_QUEUE_SIZE & MASK) == 0, "UI_QUEUE_SIZE must be a power of two");
+
+    struct Slot {
+        std::atomic<uint32_t> sequence;   // == position: free; position + 1: holds a command
+        UiCommand command;
+    };
+
+    Slot slots[UI_QUEUE_SIZE];
+    std::atomic<uint32_t> head;           // next position to claim (producers)
+    uint32_t tail = 0;                    // next position to run (render task only)
+    std::atomic<uint32_t> droppedCount;
+};
+
+#endif
@@ -0,0 +1,32 @@
+#include "UiReply.h"
+
+bool UiReply::claim()
+{
+    if (claimed) return false;
+    claimed = true;
+    length = 0;
+    truncated = false;
+    return true;
+}
+
+size_t UiReply::write(const uint8_t *data, size_t size)
+{
+    size_t room = sizeof(text) - length;
+    if (size > room) {
+        truncated = true;
+        size = room;
+    }
+    memcpy(text + length, data, size);
+    length += size;
+    return size;
+}
+
+bool UiReply::printTo(Print &out)
+{
+    if (!claimed || !ready.load(std::memory_order_acquire)) return false;
+    out.write((const uint8_t *)text, length);
+    if (truncated) out.println("... (reply cut off, raise UI_REPLY_BYTES)");
+    ready.store(false, std::memory_order_relaxed);
+    claimed = false;
+    return true;
+}
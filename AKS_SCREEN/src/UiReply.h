@@ -0,0 +1,43 @@
+/*
+ * AKS Screen - text from the render task
+ * A UI command that has something to say (the render benchmark, the image
+ * cache table) prints into a UiReply instead of Serial; loop() copies it
+ * to Serial once the command is done. Serial can block for tens of
+ * milliseconds when its buffer is full, which the render task must not.
+ *
+ * One reply is in flight at a time: loop() claims it before submitting
+ * the command and releases it after printing. Text past the capacity is
+ * cut off and marked.
+ */
+
+#ifndef UI_REPLY_H
+#define UI_REPLY_H
+
+#include <Arduino.h>
+#include <atomic>
+
+#ifndef UI_REPLY_BYTES
+#define UI_REPLY_BYTES 6144
+#endif
+
+class UiReply : public Print {
+public:
+    // loop(): false while an earlier reply is not printed yet
+    bool claim();
+    // Render task: the text is complete
+    void finish() { ready.store(true, std::memory_order_release); }
+    // loop(): prints a finished reply to out and releases it
+    bool printTo(Print &out);
+
+    size_t write(uint8_t c) override { return write(&c, 1); }
+    size_t write(const uint8_t *data, size_t size) override;
+
+private:
+    char text[UI_REPLY_BYTES];
+    size_t length = 0;
+    bool truncated = false;
+    bool claimed = false;                  // loop() only
+    std::atomic<bool> ready{false};
+};
+
+#endif
@@ -0,0 +1,69 @@
+#include "UiTask.h"
+
+void UiTask::begin(Display &disp, UiQueue &commands, void (*hook)())
+{
+    display = &disp;
+    queue = &commands;
+    afterFrame = hook;
+    stats.minIntervalUs = UINT32_MAX;
+}
+
+bool UiTask::start(uint8_t core, uint8_t priority, uint32_t periodMs)
+{
+    if (handle || !display) return false;
+    period = periodMs;
+    lastStart = 0;
+    return xTaskCreatePinnedToCore(taskFn, "lvgl", UI_TASK_STACK, this, priority, &handle, core) == pdPASS;
+}
+
+void UiTask::taskFn(void *arg)
+{
+    UiTask *self = (UiTask *)arg;
+    const TickType_t period = pdMS_TO_TICKS(self->period);
+    TickType_t wake = xTaskGetTickCount();
+    for (;;) {
+        self->tick();
+        // After an overrun the missed ticks run back to back and the
+        // schedule is kept, rather than every later tick sliding
+        vTaskDelayUntil(&wake, period);
+    }
+}
+
+void UiTask::tick()
+{
+    uint32_t start = micros();
+    if (lastStart) {
+        uint32_t interval = start - lastStart;
+        stats.ticks++;
+        stats.intervalUs += interval;
+        stats.intervalSqUs += (uint64_t)interval * interval;
+        if (interval < stats.minIntervalUs) stats.minIntervalUs = interval;
+        if (interval > stats.maxIntervalUs) stats.maxIntervalUs = interval;
+    }
+    lastStart = start;
+
+    uint16_t commands = queue->drain();
+    stats.commands += commands;
+    if (commands > stats.maxCommands) stats.maxCommands = commands;
+
+    display->poll();
+    // The refresh timer has the same period as the task but counts in
+    // whole milliseconds from when it last ran, so on its own it skips a
+    // tick now and then. Only the refresh is made due: the animation timer
+    // keeps the period AnimGovernor gives it.
+    lv_disp_t *disp = display->disp();
+    if (handle && disp && disp->refr_timer) lv_timer_ready(disp->refr_timer);
+    lv_timer_handler();
+    if (afterFrame) afterFrame();
+
+    uint32_t busy = micros() - start;
+    if (busy > stats.maxBusyUs) stats.maxBusyUs = busy;
+    if (handle && busy > period * 1000) stats.overruns++;
+}
+
+void UiTask::takeStats(UiTaskStats &out)
+{
+    out = stats;
+    stats = {};
+    stats.minIntervalUs = UINT32_MAX;
+}
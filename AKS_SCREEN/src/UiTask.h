@@ -0,0 +1,86 @@
+/*
+ * AKS Screen - LVGL render task
+ * Runs LVGL in a FreeRTOS task of its own, pinned to UI_TASK_CORE at a
+ * priority above loop(), so I2C polling, logging or anything else that
+ * blocks in loop() no longer holds up a frame. The task wakes every
+ * UI_TASK_PERIOD_MS on a fixed schedule (vTaskDelayUntil, so work inside a
+ * period does not push the next one back) and each tick:
+ *
+ *   1. runs the UI commands other tasks submitted (UiQueue.h)
+ *   2. completes a finished DMA flush
+ *   3. makes the display refresh due and runs the LVGL timers, so what
+ *      changed is drawn on this tick and not only when LVGL's refresh
+ *      timer happens to be due; animations still step at their own timer's
+ *      period (every 1st, 2nd or 4th tick, see AnimGovernor.h)
+ *   4. calls the after-frame hook (image prefetch)
+ *
+ * Once the task is started, LVGL and everything that runs from LVGL
+ * timers (telemetry widgets, animation governor) belong to it; other
+ * tasks reach them only through the queue.
+ *
+ * With -D UI_TASK=0 there is no task: loop() calls tick() itself, the old
+ * way, and the same statistics show how far it drifts.
+ */
+
+#ifndef UI_TASK_H
+#define UI_TASK_H
+
+#include <Arduino.h>
+#include <lvgl.h>
+#include "Display.h"
+#include "UiQueue.h"
+
+#ifndef UI_TASK_PERIOD_MS
+#define UI_TASK_PERIOD_MS LV_DISP_DEF_REFR_PERIOD
+#endif
+#ifndef UI_TASK_CORE
+#define UI_TASK_CORE      1            // loop()'s core; Wi-Fi and BT run on 0
+#endif
+#ifndef UI_TASK_PRIORITY
+#define UI_TASK_PRIORITY  3            // loop() runs at 1
+#endif
+#define UI_TASK_STACK     8192         // LVGL draws and the benchmark prints on it
+
+// Tick timing, accumulated since the last takeStats(). The interval is the
+// time from one tick's start to the next; its spread is the frame-time
+// jitter.
+struct UiTaskStats {
+    uint32_t ticks;
+    uint32_t intervalUs;               // sum over the intervals
+    uint64_t intervalSqUs;             // sum of squares, for the deviation
+    uint32_t minIntervalUs;
+    uint32_t maxIntervalUs;
+    uint32_t maxBusyUs;                // longest tick
+    uint32_t overruns;                 // ticks longer than the period
+    uint32_t commands;                 // UI commands run
+    uint16_t maxCommands;              // most in one tick
+};
+
+class UiTask {
+public:
+    void begin(Display &display, UiQueue &queue, void (*afterFrame)() = nullptr);
+    // Starts the task; from here on LVGL is only touched from it
+    bool start(uint8_t core = UI_TASK_CORE, uint8_t priority = UI_TASK_PRIORITY,
+               uint32_t periodMs = UI_TASK_PERIOD_MS);
+    bool running() const { return handle != nullptr; }
+    uint32_t periodMs() const { return period; }
+
+    // One tick; called by the task, or from loop() when it was not started
+    void tick();
+
+    // Render task only (a UI command)
+    void takeStats(UiTaskStats &out);
+
+private:
+    static void taskFn(void *arg);
+
+    Display *display = nullptr;
+    UiQueue *queue = nullptr;
+    void (*afterFrame)() = nullptr;
+    TaskHandle_t handle = nullptr;
+    uint32_t period = UI_TASK_PERIOD_MS;
+    uint32_t lastStart = 0;
+    UiTaskStats stats = {};
+};
+
+#endif
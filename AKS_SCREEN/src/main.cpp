@@ -1,26 +1,275 @@
 #include <Arduino.h>
 #include <lvgl.h>
+#include <Wire.h>
+#include <atomic>
+#include "GeneratorLink.h"
+#include "Display.h"
+#include "UiQueue.h"
+#include "UiTask.h"
+#include "UiReply.h"
+#include "PanelProfile.h"
+#if DISPLAY_PANEL == PANEL_ILI9341_SPI
 #include <TFT_eSPI.h>
+#include "TftBackend.h"
+#elif DISPLAY_PANEL == PANEL_CROWPANEL_7
+#include "RgbPanelBackend.h"
+#endif
+#include "RenderBench.h"
+#if AKS_SCREEN_UI
+#include <ui.h>
+#include "TelemetryBinding.h"
+#include "AnimGovernor.h"
+#endif
+#if AKS_IMG_PACK
+#include "ImagePack.h"
+#endif
+#if AKS_ASSET_FS
+#include "AssetFs.h"
+#endif
 
+// I2C to the AKS data generator (STM32, see AKS_DATA_GENERATOR_DUMP)
+#ifndef GENERATOR_SDA_PIN
+#define GENERATOR_SDA_PIN 20
+#endif
+#ifndef GENERATOR_SCL_PIN
+#define GENERATOR_SCL_PIN 19
+#endif
+#ifndef GENERATOR_I2C_HZ
+#define GENERATOR_I2C_HZ 400000    // 1000000 works if the generator keeps up (it stretches SCL)
+#endif
+
+// Display buffers (see Display.h): DISP_BUF_STRATEGY selects the layout,
+// DISP_BUF_LINES the stripe height and DISP_DMA the flush for partial
+// buffers. The render benchmark compares all of them on the panel. The
+// default depends on the panel (PanelProfile.h).
+#ifndef DISP_BUF_STRATEGY
+#define DISP_BUF_STRATEGY PANEL_BUF_STRATEGY
+#endif
+#ifndef DISP_BUF_LINES
+#define DISP_BUF_LINES 10
+#endif
+#ifndef DISP_DMA
+#define DISP_DMA 1
+#endif
+#ifndef RENDER_BENCH
+#define RENDER_BENCH 0             // 1: run the render benchmark at boot
+#endif
+#ifndef UI_TASK
+#define UI_TASK 1                  // 0: LVGL runs from loop(), as before UiTask.h
+#endif
+// Background load for the jitter comparison: a task on the render core, at
+// loop()'s priority, that keeps the CPU busy the way a slow I2C transfer or
+// a burst of logging would. 'l' on Serial switches it on and off.
+#ifndef UI_LOAD
+#define UI_LOAD 0                  // 1: start with the load on
+#endif
+#ifndef UI_LOAD_BUSY_MS
+#define UI_LOAD_BUSY_MS 20
+#endif
+#ifndef UI_LOAD_PERIOD_MS
+#define UI_LOAD_PERIOD_MS 50
+#endif
+#define FRAME_STATS_INTERVAL_MS 5000
+#ifndef ANIM_QUALITY
+#define ANIM_QUALITY ANIM_QUALITY_FULL   // highest level the animation governor may use
+#endif
+
+#if AKS_IMG_PACK
+#ifndef IMG_CACHE_BYTES
+#define IMG_CACHE_BYTES (2 * 1024 * 1024)   // decoded images, with PSRAM
+#endif
+#define IMG_CACHE_BYTES_NO_PSRAM (96 * 1024)
+#endif
+
+#if DISPLAY_PANEL == PANEL_ILI9341_SPI
 TFT_eSPI tft = TFT_eSPI();
+TftBackend panel(tft, PANEL_WIDTH, PANEL_HEIGHT, PANEL_ROTATION);
+#elif DISPLAY_PANEL == PANEL_CROWPANEL_7
+RgbPanelBackend panel(RGB_PANEL_CROWPANEL_7);
+#endif
+Display display;
+GeneratorLink generatorLink;
+UiQueue uiQueue;
+UiTask uiTask;
+UiReply uiReply;
+#if AKS_SCREEN_UI
+TelemetryBinding telemetryBinding;
+AnimGovernor animGovernor;
+#endif
+
+static TaskHandle_t loadTask = nullptr;
+static bool loadOn = false;
+
+// The statistics live on the render task's side: a command takes them
+// there and loop() prints them, so the render task never waits on Serial
+struct StatsReport {
+    uint32_t elapsedMs;
+    FrameStats frame;
+    UiTaskStats tick;
+    uint8_t strategy;
+#if AKS_SCREEN_UI
+    BindingStats binding;
+    uint8_t quality;
+    uint8_t maxQuality;
+    uint8_t running;
+    uint8_t loops;
+#endif
+};
+
+static StatsReport report;
+static std::atomic<bool> reportReady(false);
+static bool reportPending = false;
+static uint32_t lastReportRequest = 0;
+static uint32_t lastFrameReport = 0;
+
+// UI command: runs in the render task
+void takeReport(void *, uint32_t, UiValue)
+{
+    uint32_t now = millis();
+    report.elapsedMs = now - lastFrameReport;
+    lastFrameReport = now;
+    display.takeStats(report.frame);
+    uiTask.takeStats(report.tick);
+    report.strategy = display.config().strategy;
+#if AKS_SCREEN_UI
+    telemetryBinding.takeStats(report.binding);
+    report.quality = animGovernor.quality();
+    report.maxQuality = animGovernor.maxQuality();
+    report.running = animGovernor.running();
+    report.loops = animGovernor.loopCount();
+#endif
+    reportReady.store(true, std::memory_order_release);
+}
 
-static const uint32_t screenWidth  = 240;
-static const uint32_t screenHeight = 320;
+void printFrameStats(const StatsReport &r)
+{
+    const FrameStats &s = r.frame;
+    if (s.frames == 0) return;
+    Serial.printf("Frames: %.1f fps | refresh avg %.1f ms, max %u ms | flush CPU %u us/frame | %u px/frame (%s)\n",
+                  s.frames * 1000.0f / r.elapsedMs, (float)s.refreshMs / s.frames, s.maxRefreshMs,
+                  s.flushUs / s.frames, s.pixels / s.frames, Display::strategyName(r.strategy));
+    const UiTaskStats &t = r.tick;
+    if (t.ticks) {
+        // Spread of the tick interval: the frame-time jitter
+        float mean = (float)t.intervalUs / t.ticks;
+        float variance = (float)t.intervalSqUs / t.ticks - mean * mean;
+        Serial.printf("UI ticks (%s, %u ms): interval avg %.2f ms, sd %.2f ms, min %.2f, max %.2f ms"
+                      " | busy max %.2f ms, %u overruns | %u commands, max %u/tick, %u dropped | load %s\n",
+                      uiTask.running() ? "task" : "loop", uiTask.periodMs(), mean / 1000.0f,
+                      variance > 0 ? sqrtf(variance) / 1000.0f : 0.0f, t.minIntervalUs / 1000.0f,
+                      t.maxIntervalUs / 1000.0f, t.maxBusyUs / 1000.0f, t.overruns, t.commands,
+                      t.maxCommands, uiQueue.dropped(), loadOn ? "on" : "off");
+    }
+#if AKS_SCREEN_UI
+    const BindingStats &b = r.binding;
+    Serial.printf("Bindings: %u samples, %u batches, %u widget writes, %u unchanged\n",
+                  b.samples, b.applies, b.writes, b.unchanged);
+    Serial.printf("Animations: %s (max %s), %u of %u loops running\n",
+                  AnimGovernor::qualityName(r.quality), AnimGovernor::qualityName(r.maxQuality),
+                  r.running, r.loops);
+#endif
+}
 
-static lv_disp_draw_buf_t draw_buf;
-static lv_color_t buf[screenWidth * 10];
+// Asks the render task for a report every FRAME_STATS_INTERVAL_MS and
+// prints it once it is there
+void pollFrameStats(uint32_t nowMs)
+{
+    if (reportReady.load(std::memory_order_acquire)) {
+        printFrameStats(report);
+        reportReady.store(false, std::memory_order_relaxed);
+        reportPending = false;
+    }
+    if (!reportPending && nowMs - lastReportRequest >= FRAME_STATS_INTERVAL_MS) {
+        lastReportRequest = nowMs;
+        reportPending = uiQueue.submit(takeReport, nullptr);
+    }
+}
 
-void my_disp_flush(lv_disp_drv_t *disp, const lv_area_t *area, lv_color_t *color_p)
+void loadTaskFn(void *)
 {
-    uint32_t w = (area->x2 - area->x1 + 1);
-    uint32_t h = (area->y2 - area->y1 + 1);
+    for (;;) {
+        uint32_t start = micros();
+        while (micros() - start < UI_LOAD_BUSY_MS * 1000) {
+        }
+        vTaskDelay(pdMS_TO_TICKS(UI_LOAD_PERIOD_MS - UI_LOAD_BUSY_MS));
+    }
+}
 
-    tft.startWrite();
-    tft.setAddrWindow(area->x1, area->y1, w, h);
-    tft.pushColors((uint16_t *)&color_p->full, w * h, true);
-    tft.endWrite();
+void setLoad(bool on)
+{
+    if (!loadTask) return;
+    if (on) {
+        vTaskResume(loadTask);
+    } else {
+        vTaskSuspend(loadTask);
+    }
+    loadOn = on;
+}
 
-    lv_disp_flush_ready(disp);
+// UI commands for the serial keys; they run in the render task and write
+// to the UiReply they get as target, which loop() prints
+void runRenderBench(void *target, uint32_t, UiValue)
+{
+    UiReply *reply = (UiReply *)target;
+    renderBenchRun(display, *reply);
+    reply->finish();
+}
+
+#if AKS_SCREEN_UI
+void cycleAnimQuality(void *target, uint32_t, UiValue)
+{
+    UiReply *reply = (UiReply *)target;
+    // Full, reduced, low, off
+    animGovernor.setMaxQuality((animGovernor.maxQuality() + ANIM_QUALITY_FULL) % (ANIM_QUALITY_FULL + 1));
+    reply->printf("Animation quality up to %s\n", AnimGovernor::qualityName(animGovernor.maxQuality()));
+    reply->finish();
+}
+#endif
+
+#if AKS_IMG_PACK
+// After each frame in the render task
+void prefetchImages()
+{
+    imgPackPrefetchPoll();         // at most one image between frames
+}
+
+// The cache belongs to the render task, so the table is written there
+void printImagePackStats(void *target, uint32_t, UiValue)
+{
+    UiReply *reply = (UiReply *)target;
+    reply->printf("%-20s %8s %8s %6s %6s %8s %8s %10s %8s\n",
+                  "image", "raw", "flash", "hits", "misses", "prefetch", "load ms", "decode ms", "rows");
+    for (uint16_t i = 0; i < img_pack_asset_count; i++) {
+        const img_pack_asset_t &asset = img_pack_assets[i];
+        if (!imgPackIsPacked(asset.img)) {
+            reply->printf("%-20s %8u %8u   (not packed)\n", asset.name, asset.raw_size, asset.img->data_size);
+            continue;
+        }
+        // flash: the packed image, or only its file name for a LittleFS one
+        const ImagePackStats *s = imgPackStats(i);
+        uint32_t decodes = s->misses + s->prefetches;
+        reply->printf("%-20s %8u %8u %6u %6u %8u %8.2f %10.2f %8u\n", asset.name, asset.raw_size,
+                      asset.img->data_size, s->hits, s->misses, s->prefetches,
+                      s->loads ? s->loadUs / 1000.0f / s->loads : 0.0f,
+                      decodes ? s->decodeUs / 1000.0f / decodes : 0.0f, s->rowDecodes);
+    }
+    reply->printf("Image cache: %u KB used, %u KB peak\n",
+                  (unsigned)(imgPackCacheUsed() / 1024), (unsigned)(imgPackCachePeak() / 1024));
+    reply->finish();
+}
+#endif
+
+// Runs fn in the render task with the reply as its target
+void submitWithReply(UiCommandFn fn)
+{
+    if (!uiReply.claim()) {
+        Serial.println("Still busy with the previous command");
+        return;
+    }
+    if (!uiQueue.submit(fn, &uiReply)) {
+        uiReply.println("UI command queue full, try again");
+        uiReply.finish();
+    }
 }
 
 void my_touchpad_read(lv_indev_drv_t *indev_driver, lv_indev_data_t *data)
@@ -32,20 +281,17 @@ void setup()
 {
     Serial.begin(115200);
     
-    tft.begin();
-    tft.setRotation(1);
+    if (!panel.begin()) {
+        Serial.printf("%s panel failed to start\n", panel.name());
+    }
     
     lv_init();
     
-    lv_disp_draw_buf_init(&draw_buf, buf, NULL, screenWidth * 10);
-    
-    static lv_disp_drv_t disp_drv;
-    lv_disp_drv_init(&disp_drv);
-    disp_drv.hor_res = screenWidth;
-    disp_drv.ver_res = screenHeight;
-    disp_drv.flush_cb = my_disp_flush;
-    disp_drv.draw_buf = &draw_buf;
-    lv_disp_drv_register(&disp_drv);
+    const DisplayConfig displayConfig = { DISP_BUF_STRATEGY, DISP_BUF_LINES, DISP_DMA };
+    if (!display.begin(panel, displayConfig)) {
+        Serial.printf("%s buffers do not fit, using a single 10-line stripe\n",
+                      Display::strategyName(displayConfig.strategy));
+    }
     
     static lv_indev_drv_t indev_drv;
     lv_indev_drv_init(&indev_drv);
@@ -53,16 +299,92 @@ void setup()
     indev_drv.read_cb = my_touchpad_read;
     lv_indev_drv_register(&indev_drv);
     
+#if AKS_ASSET_FS
+    // Images are read from here on first use (esp32s3dev_ui_fs)
+    if (!assetFsBegin()) {
+        Serial.println("LittleFS does not mount, run: pio run -e esp32s3dev_ui_fs -t uploadfs");
+    }
+#endif
+#if AKS_IMG_PACK
+    // Decoded images need PSRAM to stay cached; without it the budget only
+    // covers the small ones and the backgrounds are decoded row by row
+    imgPackInit(psramFound() ? IMG_CACHE_BYTES : IMG_CACHE_BYTES_NO_PSRAM);
+#endif
+#if AKS_SCREEN_UI
+    // SquareLine dashboard (temp_ui), built by the esp32s3dev_ui environment
+    ui_init();
+#if AKS_IMG_PACK
+    imgPackWatchScreens();
+#endif
+    telemetryBinding.begin(TELEMETRY_DASHBOARD, TELEMETRY_DASHBOARD_COUNT, UI_TASK ? &uiQueue : nullptr);
+    animGovernor.begin(display, ANIM_DASHBOARD, ANIM_DASHBOARD_COUNT);
+    animGovernor.setMaxQuality(ANIM_QUALITY);
+#else
     // Create simple demo screen
     lv_obj_t *label = lv_label_create(lv_scr_act());
     lv_label_set_text(label, "E-Bike Display\nReady!");
     lv_obj_align(label, LV_ALIGN_CENTER, 0, 0);
+#endif
+    
+    Wire.begin(GENERATOR_SDA_PIN, GENERATOR_SCL_PIN, GENERATOR_I2C_HZ);
+    if (generatorLink.begin(Wire)) {
+        Serial.print("Data generator found, register map v");
+        Serial.println(AKS_REG_MAP_VERSION);
+    } else {
+        Serial.println("Data generator not responding");
+    }
+    
+#if RENDER_BENCH
+    renderBenchRun(display, Serial);
+#endif
+    
+#if AKS_IMG_PACK
+    uiTask.begin(display, uiQueue, prefetchImages);
+#else
+    uiTask.begin(display, uiQueue);
+#endif
+#if UI_TASK
+    // From here on LVGL belongs to the render task
+    if (!uiTask.start()) {
+        Serial.println("Render task did not start, LVGL runs from loop()");
+    }
+#endif
+    
+    xTaskCreatePinnedToCore(loadTaskFn, "load", 2048, nullptr, 1, &loadTask, UI_TASK_CORE);
+    setLoad(UI_LOAD);
     
     Serial.println("Setup done");
 }
 
 void loop()
 {
-    lv_timer_handler();
+    generatorLink.poll(millis());
+#if AKS_SCREEN_UI
+    telemetryBinding.update(generatorLink);
+#endif
+    if (!uiTask.running()) uiTask.tick();
+    pollFrameStats(millis());
+    uiReply.printTo(Serial);
+    
+    switch (Serial.available() ? Serial.read() : -1) {
+        case 'b':
+            submitWithReply(runRenderBench);
+            break;
+        case 'l':
+            setLoad(!loadOn);
+            Serial.printf("Background load %s (%u ms busy every %u ms)\n", loadOn ? "on" : "off",
+                          UI_LOAD_BUSY_MS, UI_LOAD_PERIOD_MS);
+            break;
+#if AKS_SCREEN_UI
+        case 'q':
+            submitWithReply(cycleAnimQuality);
+            break;
+#endif
+#if AKS_IMG_PACK
+        case 'i':
+            submitWithReply(printImagePackStats);
+            break;
+#endif
+    }
     delay(5);
 }
\ No newline at end of file
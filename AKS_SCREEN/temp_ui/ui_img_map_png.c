@@ -0,0 +1,30 @@
+// Placeholder for assets/map.png, which was not part of the SquareLine
+// export. ui_Home.c references it and lv_img tiles it over the map area,
+// so a small solid tile lets the UI link and render until the real asset
+// is exported.
+
+#include "ui.h"
+
+#ifndef LV_ATTRIBUTE_MEM_ALIGN
+    #define LV_ATTRIBUTE_MEM_ALIGN
+#endif
+
+#define MAP_TILE 16
+
+// RGB565 0x18E4 (dark blue-grey), little endian
+#define MAP_PX 0xE4,0x18,
+#define MAP_ROW MAP_PX MAP_PX MAP_PX MAP_PX MAP_PX MAP_PX MAP_PX MAP_PX \
+                MAP_PX MAP_PX MAP_PX MAP_PX MAP_PX MAP_PX MAP_PX MAP_PX
+
+const LV_ATTRIBUTE_MEM_ALIGN uint8_t ui_img_map_png_data[] = {
+    MAP_ROW MAP_ROW MAP_ROW MAP_ROW MAP_ROW MAP_ROW MAP_ROW MAP_ROW
+    MAP_ROW MAP_ROW MAP_ROW MAP_ROW MAP_ROW MAP_ROW MAP_ROW MAP_ROW
+};
+const lv_img_dsc_t ui_img_map_png = {
+    .header.always_zero = 0,
+    .header.w = MAP_TILE,
+    .header.h = MAP_TILE,
+    .data_size = sizeof(ui_img_map_png_data),
+    .header.cf = LV_IMG_CF_TRUE_COLOR,
+    .data = ui_img_map_png_data
+};
@@ -0,0 +1,46 @@
+/*
+ * AKS Protocol - bulk telemetry dataset file
+ * Written by tools/dataset_gen and tools/serial_tap, read by codec and
+ * storage benchmarks. Little endian, packed:
+ *
+ *   AksDatasetHeader                       32 bytes
+ *   AksDatasetRecord x N                   34 bytes each, vehicle-major
+ *
+ * N is vehicles * samples_per_vehicle; samples_per_vehicle is 0 when the
+ * length was not known up front (a captured stream), then read to EOF.
+ */
+
+#ifndef AKS_DATASET_H
+#define AKS_DATASET_H
+
+#include "AksRegisters.h"
+
+#define AKS_DATASET_MAGIC    "AKSD"
+#define AKS_DATASET_VERSION  1
+
+struct AksDatasetHeader {
+    char magic[4];                // AKS_DATASET_MAGIC, not terminated
+    uint16_t version;             // AKS_DATASET_VERSION
+    uint16_t record_size;         // sizeof(AksDatasetRecord)
+    uint32_t vehicles;
+    uint32_t samples_per_vehicle;
+    uint32_t sample_interval_ms;
+    uint32_t seed;                // base seed, vehicle v uses aksDatasetSeed()
+    uint8_t simulation_mode;      // AKS_MODE_*, 0 = mode cycling
+    uint8_t reserved[7];
+} __attribute__((packed));
+
+struct AksDatasetRecord {
+    uint32_t vehicle;
+    AKS_TelemetryData sample;
+} __attribute__((packed));
+
+static_assert(sizeof(AksDatasetHeader) == 32, "dataset header size");
+static_assert(sizeof(AksDatasetRecord) == 34, "dataset record size");
+
+// Per-vehicle simulation seed derived from the dataset's base seed
+static inline uint32_t aksDatasetSeed(uint32_t seed, uint32_t vehicle) {
+    return seed + vehicle * 0x9E3779B9u;
+}
+
+#endif
@@ -0,0 +1,217 @@
+/*
+ * AKS Protocol - Data generator I2C register map
+ * Shared by AKS_DATA_GENERATOR_DUMP (slave, address 0x42) and AKS_SCREEN
+ * (master).
+ *
+ * The generator exposes a 256-byte register map. A master writes one
+ * byte (the register address) and then reads with a repeated start; the
+ * read streams bytes from that address onward (auto-increment), so any
+ * block or run of adjacent blocks comes back in one transaction. A read
+ * without a preceding address write starts at 0x00, the legacy 30-byte
+ * AKS_TelemetryData, so older masters keep working unchanged.
+ *
+ * Writes:
+ *   1 byte 0x01-0x04   legacy command (reset energy, normal/fault/charging)
+ *   1 byte, any other  set the read address
+ *   2+ bytes           address followed by data for the config block
+ *
+ * Sample FIFO (0xD0-0xDF, live, not part of the published image): every
+ * published sample is also queued as an AksFifoSample once a master has
+ * started draining. Write [0xD8][n] and read with a repeated start to get
+ * an AksFifoBurstHeader followed by n samples, oldest first; entries past
+ * header.count are zero. A single-byte write of 0xD8 asks for the largest
+ * burst the slave's I2C transport can send. A burst is popped by the write
+ * and stays waiting until it is read; another [0xD8][n] before that read
+ * gets the waiting burst, at its original size.
+ *
+ * Multi-byte values are little endian. Scaled integers give the unit in
+ * the field name (deci = 0.1, centi = 0.01).
+ */
+
+#ifndef AKS_REGISTERS_H
+#define AKS_REGISTERS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define AKS_I2C_ADDRESS        0x42
+#define AKS_REG_MAP_VERSION    1
+#define AKS_REG_MAP_SIZE       256
+#define AKS_REG_MAGIC_0        'A'
+#define AKS_REG_MAGIC_1        'K'
+
+// Block addresses
+#define AKS_REG_LEGACY         0x00   // AKS_TelemetryData, 30 bytes
+#define AKS_REG_ID             0x20   // AksIdBlock
+#define AKS_REG_STATUS         0x28   // AksStatusBlock
+#define AKS_REG_FAST           0x30   // AksFastBlock, changes every sample
+#define AKS_REG_SLOW           0x40   // AksSlowBlock, thermal and energy
+#define AKS_REG_FAULT_LOG      0x60   // AksFaultLog
+#define AKS_REG_CONFIG         0xA0   // AksConfigBlock, read/write
+#define AKS_REG_DIAG           0xB0   // AksDiagBlock
+#define AKS_REG_FIFO_STATUS    0xD0   // AksFifoStatus, live
+#define AKS_REG_FIFO_DATA      0xD8   // burst drain, see above
+
+#define AKS_FIFO_MAX_BURST     16     // samples per burst read
+
+// Legacy single-byte commands
+#define AKS_CMD_RESET_ENERGY   0x01
+#define AKS_CMD_MODE_NORMAL    0x02
+#define AKS_CMD_MODE_FAULT     0x03
+#define AKS_CMD_MODE_CHARGING  0x04
+
+// system_status bits
+#define AKS_STATUS_MOTOR_READY   0x01
+#define AKS_STATUS_BATTERY_OK    0x02
+#define AKS_STATUS_BRAKE_OK      0x04
+#define AKS_STATUS_CHARGING      0x08
+#define AKS_STATUS_REGEN_ACTIVE  0x10
+#define AKS_STATUS_FIFO_OVERFLOW 0x20   // FIFO dropped samples since the last drain
+
+// fault_codes bits
+#define AKS_FAULT_SENSOR           0x01
+#define AKS_FAULT_BATTERY_OVERTEMP 0x02
+#define AKS_FAULT_MOTOR_OVERTEMP   0x04
+#define AKS_FAULT_BRAKE            0x08
+
+// simulation_mode values
+#define AKS_MODE_NORMAL    1
+#define AKS_MODE_FAULT     2
+#define AKS_MODE_CHARGING  3
+#define AKS_MODE_SCENARIO  4      // drive-cycle playback
+
+#define AKS_FAULT_LOG_ENTRIES  4
+
+// AKS telemetry data structure (legacy block)
+struct AKS_TelemetryData {
+    uint32_t timestamp_ms;        // Time since vehicle start (ms)
+    float vehicle_speed_kmh;      // Vehicle speed (km/h)
+    float battery_temp_C;         // Battery temperature (°C)
+    float battery_voltage_V;      // Total battery voltage (V)
+    float remaining_energy_Wh;    // Remaining energy (Wh)
+    float motor_temp_C;           // Motor temperature (°C)
+    float brake_pressure_bar;     // Brake pressure (bar)
+    uint8_t system_status;        // System status flags
+    uint8_t fault_codes;          // Fault diagnostic codes
+} __attribute__((packed));
+
+struct AksIdBlock {
+    char magic[2];                // "AK"
+    uint8_t map_version;          // AKS_REG_MAP_VERSION
+    uint8_t flags;                // reserved, 0
+    uint16_t sample_interval_ms;  // how often the map is refreshed
+    uint16_t reserved;
+} __attribute__((packed));
+
+struct AksStatusBlock {
+    uint32_t timestamp_ms;
+    uint8_t system_status;
+    uint8_t fault_codes;
+    uint8_t simulation_mode;      // AKS_MODE_*
+    uint8_t sample_seq;           // increments with every published sample
+} __attribute__((packed));
+
+struct AksFastBlock {
+    uint32_t timestamp_ms;
+    uint16_t speed_centikmh;
+    uint16_t brake_decibar;
+    uint8_t system_status;
+    uint8_t fault_codes;
+} __attribute__((packed));
+
+struct AksSlowBlock {
+    uint32_t timestamp_ms;
+    int16_t battery_temp_deciC;
+    uint16_t battery_voltage_deciV;
+    uint32_t remaining_energy_Wh;
+    int16_t motor_temp_deciC;
+} __attribute__((packed));
+
+struct AksFaultEntry {
+    uint32_t timestamp_ms;
+    uint8_t fault_codes;          // codes that were newly raised
+    uint8_t system_status;
+} __attribute__((packed));
+
+struct AksFaultLog {
+    uint8_t total;                // faults logged since boot (wraps)
+    uint8_t reserved;
+    AksFaultEntry entries[AKS_FAULT_LOG_ENTRIES];  // newest at (total-1) % ENTRIES
+} __attribute__((packed));
+
+struct AksConfigBlock {
+    uint8_t simulation_mode;      // write an AKS_MODE_* value to switch mode
+    uint8_t command;              // write an AKS_CMD_* value to run it
+    uint16_t sample_interval_ms;  // write to change the publish rate
+    uint8_t time_scale;           // simulated seconds per real second, 1-50
+    uint8_t scenario_lap;         // read only, current lap in scenario mode
+} __attribute__((packed));
+
+struct AksDiagBlock {
+    uint32_t i2c_requests;        // read transactions served
+    uint32_t i2c_writes;          // write transactions received
+    uint32_t published_samples;
+    uint32_t publish_retries;     // publishes delayed by a buffer in use
+    uint32_t i2c_rate;            // transactions per second, last second
+    uint32_t i2c_isr_cycles;      // average CPU cycles of I2C ISR per transaction
+} __attribute__((packed));
+
+struct AksFifoStatus {
+    uint8_t count;                // samples waiting
+    uint8_t capacity;
+    uint8_t sample_size;          // sizeof(AksFifoSample)
+    uint8_t max_burst;            // largest burst this slave can send
+    uint16_t dropped;             // samples lost to overflow since the last burst
+    uint16_t reserved;
+} __attribute__((packed));
+
+// One queued sample, the fast and slow signals of one publish
+struct AksFifoSample {
+    uint32_t timestamp_ms;
+    uint16_t speed_centikmh;
+    uint16_t brake_decibar;
+    uint16_t battery_voltage_deciV;
+    int16_t battery_temp_deciC;
+    int16_t motor_temp_deciC;
+    uint8_t system_status;
+    uint8_t fault_codes;
+} __attribute__((packed));
+
+struct AksFifoBurstHeader {
+    uint8_t count;                // valid samples in this burst
+    uint8_t remaining;            // samples still queued afterwards
+    uint16_t dropped;             // samples lost to overflow before this burst
+} __attribute__((packed));
+
+static_assert(sizeof(AksFifoSample) == 16, "FIFO sample size");
+
+// Whole register map as the slave keeps it in RAM
+struct AksRegisterMap {
+    AKS_TelemetryData legacy;     // 0x00
+    uint8_t pad0[2];
+    AksIdBlock id;                // 0x20
+    AksStatusBlock status;        // 0x28
+    AksFastBlock fast;            // 0x30
+    uint8_t pad1[6];
+    AksSlowBlock slow;            // 0x40
+    uint8_t pad2[18];
+    AksFaultLog faultLog;         // 0x60
+    uint8_t pad3[38];
+    AksConfigBlock config;        // 0xA0
+    uint8_t pad4[10];
+    AksDiagBlock diag;            // 0xB0
+    uint8_t pad5[56];
+} __attribute__((packed));
+
+static_assert(offsetof(AksRegisterMap, id) == AKS_REG_ID, "ID block address");
+static_assert(offsetof(AksRegisterMap, status) == AKS_REG_STATUS, "status block address");
+static_assert(offsetof(AksRegisterMap, fast) == AKS_REG_FAST, "fast block address");
+static_assert(offsetof(AksRegisterMap, slow) == AKS_REG_SLOW, "slow block address");
+static_assert(offsetof(AksRegisterMap, faultLog) == AKS_REG_FAULT_LOG, "fault log address");
+static_assert(offsetof(AksRegisterMap, config) == AKS_REG_CONFIG, "config block address");
+static_assert(offsetof(AksRegisterMap, diag) == AKS_REG_DIAG, "diag block address");
+static_assert(sizeof(AksRegisterMap) == AKS_REG_MAP_SIZE, "register map size");
+static_assert(offsetof(AksRegisterMap, diag) + sizeof(AksDiagBlock) <= AKS_REG_FIFO_STATUS,
+              "diag block overlaps the FIFO registers");
+
+#endif
@@ -0,0 +1,146 @@
+/*
+ * AKS Protocol - binary serial stream
+ * Framing for the generator's binary serial output, decoded on the host
+ * by tools/serial_tap. Each frame is
+ *
+ *   0x00, COBS( type, seq, payload..., crc16 lo, crc16 hi ), 0x00
+ *
+ * COBS removes every zero from the body, so 0x00 only ever marks a frame
+ * boundary and a receiver that starts mid-stream, or sees stray text,
+ * resynchronises at the next delimiter. The leading delimiter isolates a
+ * frame from anything printed before it. seq increments per frame so the
+ * receiver can count gaps. The CRC is CRC-16/CCITT-FALSE over type, seq
+ * and payload.
+ */
+
+#ifndef AKS_STREAM_H
+#define AKS_STREAM_H
+
+#include <string.h>
+#include "AksRegisters.h"
+
+// Frame types
+#define AKS_STREAM_TELEMETRY   0x01   // AKS_TelemetryData
+#define AKS_STREAM_INFO        0x02   // AksStreamInfo, sent once a second
+
+#define AKS_STREAM_MAX_PAYLOAD 32
+#define AKS_STREAM_MAX_BODY    (2 + AKS_STREAM_MAX_PAYLOAD + 2)
+// Body plus COBS overhead (one byte per 254) plus both delimiters
+#define AKS_STREAM_MAX_FRAME   (AKS_STREAM_MAX_BODY + 1 + 2)
+
+struct AksStreamInfo {
+    uint32_t seed;                // simulation seed, replays with -D SIM_SEED
+    uint16_t sample_interval_ms;  // simulated time between telemetry frames
+    uint8_t simulation_mode;      // AKS_MODE_*
+    uint8_t time_scale;
+    uint32_t dropped_frames;      // frames not sent because the UART was busy
+} __attribute__((packed));
+
+static_assert(sizeof(AksStreamInfo) <= AKS_STREAM_MAX_PAYLOAD, "stream info size");
+static_assert(sizeof(AKS_TelemetryData) <= AKS_STREAM_MAX_PAYLOAD, "telemetry frame size");
+
+static inline uint16_t aksCrc16(const uint8_t *data, size_t length, uint16_t crc = 0xFFFF) {
+    while (length--) {
+        crc ^= (uint16_t)*data++ << 8;
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            crc = crc & 0x8000 ? (uint16_t)(crc << 1) ^ 0x1021 : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+// Encodes one frame into out (AKS_STREAM_MAX_FRAME bytes), returns its
+// length including both delimiters, or 0 if the payload is too long
+static inline size_t aksStreamEncode(uint8_t type, uint8_t seq, const void *payload,
+                                     size_t length, uint8_t *out) {
+    if (length > AKS_STREAM_MAX_PAYLOAD) return 0;
+
+    uint8_t body[AKS_STREAM_MAX_BODY];
+    body[0] = type;
+    body[1] = seq;
+    memcpy(body + 2, payload, length);
+    uint16_t crc = aksCrc16(body, length + 2);
+    body[length + 2] = crc & 0xFF;
+    body[length + 3] = crc >> 8;
+    size_t bodyLength = length + 4;
+
+    size_t n = 0;
+    out[n++] = 0x00;
+    size_t code = n++;            // position of the current block's code byte
+    uint8_t run = 1;
+    for (size_t i = 0; i < bodyLength; i++) {
+        if (body[i] == 0) {
+            out[code] = run;
+            code = n++;
+            run = 1;
+        } else {
+            out[n++] = body[i];
+            if (++run == 0xFF) {
+                out[code] = run;
+                code = n++;
+                run = 1;
+            }
+        }
+    }
+    out[code] = run;
+    out[n++] = 0x00;
+    return n;
+}
+
+// Byte-at-a-time decoder. push() returns true when a complete frame with
+// a good CRC has arrived; its fields stay valid until the next push().
+class AksStreamDecoder {
+public:
+    bool push(uint8_t byte) {
+        if (byte != 0x00) {
+            if (fill < sizeof(encoded)) encoded[fill] = byte;
+            fill++;
+            return false;
+        }
+        size_t n = fill;
+        fill = 0;
+        if (n == 0) return false;             // back-to-back delimiters
+        if (n > sizeof(encoded) || !decode(n)) {
+            junk++;
+            return false;
+        }
+        uint16_t crc = aksCrc16(body, bodyLength - 2);
+        if ((body[bodyLength - 2] | (uint16_t)body[bodyLength - 1] << 8) != crc) {
+            crcErrors++;
+            return false;
+        }
+        frames++;
+        return true;
+    }
+
+    uint8_t type() const { return body[0]; }
+    uint8_t seq() const { return body[1]; }
+    const uint8_t *payload() const { return body + 2; }
+    size_t payloadLength() const { return bodyLength - 4; }
+
+    uint32_t frames = 0;          // good frames
+    uint32_t crcErrors = 0;       // well-formed frames with a bad CRC
+    uint32_t junk = 0;            // runs between delimiters that were not frames
+
+private:
+    bool decode(size_t n) {
+        size_t out = 0;
+        size_t i = 0;
+        while (i < n) {
+            uint8_t code = encoded[i++];
+            if (code == 0 || i + code - 1 > n) return false;
+            for (uint8_t k = 1; k < code; k++) body[out++] = encoded[i++];
+            // A zero follows every block except a full one and the last
+            if (code < 0xFF && i < n) body[out++] = 0x00;
+        }
+        bodyLength = out;
+        return bodyLength >= 4;
+    }
+
+    uint8_t encoded[AKS_STREAM_MAX_FRAME];
+    uint8_t body[AKS_STREAM_MAX_FRAME];
+    size_t fill = 0;
+    size_t bodyLength = 0;
+};
+
+#endif
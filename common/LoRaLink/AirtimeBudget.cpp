@@ -0,0 +1,42 @@
+#include "AirtimeBudget.h"
+
+// Share of the bucket each class must leave untouched, in percent
+static const uint8_t reservePercent[PRIORITY_COUNT] = { 0, 10, 25, 50 };
+
+void AirtimeBudget::begin(uint16_t dutyPermille, uint32_t windowMs, uint32_t nowMs) {
+  duty = dutyPermille;
+  bucketUs = (uint32_t)((uint64_t)windowMs * dutyPermille);
+  tokensUs = bucketUs;
+  lastUpdateMs = nowMs;
+}
+
+void AirtimeBudget::update(uint32_t nowMs) {
+  uint32_t elapsedMs = nowMs - lastUpdateMs;
+  lastUpdateMs = nowMs;
+
+  // permille of a millisecond is exactly that many microseconds
+  uint64_t tokens = (uint64_t)tokensUs + (uint64_t)elapsedMs * duty;
+  tokensUs = tokens > bucketUs ? bucketUs : (uint32_t)tokens;
+}
+
+uint32_t AirtimeBudget::reserveUs(FramePriority priority) const {
+  return (uint32_t)((uint64_t)bucketUs * reservePercent[priority] / 100);
+}
+
+bool AirtimeBudget::admit(uint32_t airtimeUs, FramePriority priority) const {
+  if (airtimeUs > tokensUs) return false;
+  return tokensUs - airtimeUs >= reserveUs(priority);
+}
+
+void AirtimeBudget::consume(uint32_t airtimeUs) {
+  tokensUs = airtimeUs > tokensUs ? 0 : tokensUs - airtimeUs;
+}
+
+bool AirtimeBudget::isLow() const {
+  return tokensUs < reserveUs(PRIORITY_PERIODIC) * 2;
+}
+
+uint8_t AirtimeBudget::remainingPercent() const {
+  if (bucketUs == 0) return 0;
+  return (uint8_t)((uint64_t)tokensUs * 100 / bucketUs);
+}
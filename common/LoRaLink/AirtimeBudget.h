@@ -0,0 +1,56 @@
+/*********
+  EC Telemetry Link - Airtime budget governor
+  Token bucket measured in microseconds of time-on-air. The bucket refills
+  at the regional duty cycle (1% = 10 us per ms) and holds at most one
+  averaging window worth of airtime. Lower priority frames must leave a
+  larger reserve in the bucket, so when the budget runs low periodic and
+  bulk traffic is deferred or degraded while fault frames still go out.
+*********/
+
+#ifndef AIRTIME_BUDGET_H
+#define AIRTIME_BUDGET_H
+
+#include <stdint.h>
+
+// Transmit priority classes, highest first
+enum FramePriority {
+  PRIORITY_CRITICAL = 0,  // faults, may use the whole bucket
+  PRIORITY_ALERT,         // warnings
+  PRIORITY_PERIODIC,      // regular telemetry samples
+  PRIORITY_BULK,          // FEC parity, backfill
+  PRIORITY_COUNT
+};
+
+class AirtimeBudget {
+public:
+  // dutyPermille: allowed share of airtime (10 = 1%)
+  // windowMs: period the duty cycle is averaged over, sets the bucket size
+  void begin(uint16_t dutyPermille, uint32_t windowMs, uint32_t nowMs);
+
+  // Adds the airtime earned since the last call
+  void update(uint32_t nowMs);
+
+  // True if a frame with this time-on-air may be sent now
+  bool admit(uint32_t airtimeUs, FramePriority priority) const;
+
+  // Books a transmitted frame against the bucket
+  void consume(uint32_t airtimeUs);
+
+  // True once the bucket falls below the periodic reserve; senders
+  // should switch to reduced frames and drop optional ones
+  bool isLow() const;
+
+  uint32_t remainingUs() const { return tokensUs; }
+  uint32_t capacityUs() const { return bucketUs; }
+  uint8_t remainingPercent() const;
+
+private:
+  uint32_t reserveUs(FramePriority priority) const;
+
+  uint16_t duty = 0;
+  uint32_t bucketUs = 0;
+  uint32_t tokensUs = 0;
+  uint32_t lastUpdateMs = 0;
+};
+
+#endif
@@ -0,0 +1,310 @@
+#include "LinkCrypto.h"
+#include <string.h>
+
+#if !LINK_AES_HW
+// Software AES-128, encrypt only. One T-table plus rotations keeps the
+// tables at 1.25 KB of RAM, built on first use instead of stored in flash.
+static uint8_t sbox[256];
+static uint32_t te0[256];
+static bool tablesReady = false;
+
+static inline uint8_t rotl8(uint8_t x, uint8_t n) {
+  return (uint8_t)((x << n) | (x >> (8 - n)));
+}
+
+static inline uint32_t ror32(uint32_t x, uint8_t n) {
+  return (x >> n) | (x << (32 - n));
+}
+
+static inline uint8_t xtime(uint8_t x) {
+  return (uint8_t)((x << 1) ^ ((x & 0x80) ? 0x1B : 0));
+}
+
+static void buildTables() {
+  // Walk GF(2^8) with generator 3 and its inverse to get the S-box
+  uint8_t p = 1;
+  uint8_t q = 1;
+  do {
+    p = p ^ xtime(p);
+    q ^= q << 1;
+    q ^= q << 2;
+    q ^= q << 4;
+    if (q & 0x80) q ^= 0x09;
+    sbox[p] = q ^ rotl8(q, 1) ^ rotl8(q, 2) ^ rotl8(q, 3) ^ rotl8(q, 4) ^ 0x63;
+  } while (p != 1);
+  sbox[0] = 0x63;
+
+  for (int i = 0; i < 256; i++) {
+    uint8_t s = sbox[i];
+    uint8_t s2 = xtime(s);
+    te0[i] = ((uint32_t)s2 << 24) | ((uint32_t)s << 16) | ((uint32_t)s << 8) | (uint8_t)(s2 ^ s);
+  }
+  tablesReady = true;
+}
+
+static inline uint32_t loadBE(const uint8_t* p) {
+  return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+static inline void storeBE(uint8_t* p, uint32_t v) {
+  p[0] = (uint8_t)(v >> 24);
+  p[1] = (uint8_t)(v >> 16);
+  p[2] = (uint8_t)(v >> 8);
+  p[3] = (uint8_t)v;
+}
+
+static inline uint32_t subWord(uint32_t w) {
+  return ((uint32_t)sbox[w >> 24] << 24) | ((uint32_t)sbox[(w >> 16) & 0xFF] << 16) |
+         ((uint32_t)sbox[(w >> 8) & 0xFF] << 8) | sbox[w & 0xFF];
+}
+
+void Aes128::setKey(const uint8_t key[LINK_KEY_SIZE]) {
+  if (!tablesReady) buildTables();
+
+  uint8_t rcon = 1;
+  for (int i = 0; i < 4; i++) roundKeys[i] = loadBE(key + 4 * i);
+  for (int i = 4; i < 44; i++) {
+    uint32_t temp = roundKeys[i - 1];
+    if (i % 4 == 0) {
+      temp = subWord((temp << 8) | (temp >> 24)) ^ ((uint32_t)rcon << 24);
+      rcon = xtime(rcon);
+    }
+    roundKeys[i] = roundKeys[i - 4] ^ temp;
+  }
+}
+
+void Aes128::encryptBlock(const uint8_t in[16], uint8_t out[16]) {
+  const uint32_t* rk = roundKeys;
+  uint32_t s0 = loadBE(in) ^ rk[0];
+  uint32_t s1 = loadBE(in + 4) ^ rk[1];
+  uint32_t s2 = loadBE(in + 8) ^ rk[2];
+  uint32_t s3 = loadBE(in + 12) ^ rk[3];
+
+  for (int round = 1; round < 10; round++) {
+    rk += 4;
+    uint32_t t0 = te0[s0 >> 24] ^ ror32(te0[(s1 >> 16) & 0xFF], 8) ^
+                  ror32(te0[(s2 >> 8) & 0xFF], 16) ^ ror32(te0[s3 & 0xFF], 24) ^ rk[0];
+    uint32_t t1 = te0[s1 >> 24] ^ ror32(te0[(s2 >> 16) & 0xFF], 8) ^
+                  ror32(te0[(s3 >> 8) & 0xFF], 16) ^ ror32(te0[s0 & 0xFF], 24) ^ rk[1];
+    uint32_t t2 = te0[s2 >> 24] ^ ror32(te0[(s3 >> 16) & 0xFF], 8) ^
+                  ror32(te0[(s0 >> 8) & 0xFF], 16) ^ ror32(te0[s1 & 0xFF], 24) ^ rk[2];
+    uint32_t t3 = te0[s3 >> 24] ^ ror32(te0[(s0 >> 16) & 0xFF], 8) ^
+                  ror32(te0[(s1 >> 8) & 0xFF], 16) ^ ror32(te0[s2 & 0xFF], 24) ^ rk[3];
+    s0 = t0; s1 = t1; s2 = t2; s3 = t3;
+  }
+
+  // Final round has no MixColumns
+  rk += 4;
+  storeBE(out,      (((uint32_t)sbox[s0 >> 24] << 24) | ((uint32_t)sbox[(s1 >> 16) & 0xFF] << 16) |
+                     ((uint32_t)sbox[(s2 >> 8) & 0xFF] << 8) | sbox[s3 & 0xFF]) ^ rk[0]);
+  storeBE(out + 4,  (((uint32_t)sbox[s1 >> 24] << 24) | ((uint32_t)sbox[(s2 >> 16) & 0xFF] << 16) |
+                     ((uint32_t)sbox[(s3 >> 8) & 0xFF] << 8) | sbox[s0 & 0xFF]) ^ rk[1]);
+  storeBE(out + 8,  (((uint32_t)sbox[s2 >> 24] << 24) | ((uint32_t)sbox[(s3 >> 16) & 0xFF] << 16) |
+                     ((uint32_t)sbox[(s0 >> 8) & 0xFF] << 8) | sbox[s1 & 0xFF]) ^ rk[2]);
+  storeBE(out + 12, (((uint32_t)sbox[s3 >> 24] << 24) | ((uint32_t)sbox[(s0 >> 16) & 0xFF] << 16) |
+                     ((uint32_t)sbox[(s1 >> 8) & 0xFF] << 8) | sbox[s2 & 0xFF]) ^ rk[3]);
+}
+
+void Aes128::ctr(const uint8_t counter[16], const uint8_t* in, uint8_t* out, size_t length) {
+  uint8_t block[16];
+  uint8_t stream[16];
+  memcpy(block, counter, 16);
+
+  for (size_t offset = 0; offset < length; offset += 16) {
+    encryptBlock(block, stream);
+    size_t n = length - offset < 16 ? length - offset : 16;
+    for (size_t i = 0; i < n; i++) out[offset + i] = in[offset + i] ^ stream[i];
+
+    // 128-bit big-endian increment, same as the ESP32 peripheral path
+    for (int i = 15; i >= 0 && ++block[i] == 0; i--) {}
+  }
+}
+
+void Aes128::cbcMac(const uint8_t* data, size_t length, uint8_t mac[16]) {
+  uint8_t state[16] = {0};
+  for (size_t offset = 0; offset < length; offset += 16) {
+    for (int i = 0; i < 16; i++) state[i] ^= data[offset + i];
+    encryptBlock(state, state);
+  }
+  memcpy(mac, state, 16);
+}
+
+#else
+// ESP32 crypto peripheral. Whole buffers go through one driver call so
+// the peripheral is locked and loaded with the key once per frame.
+void Aes128::setKey(const uint8_t key[LINK_KEY_SIZE]) {
+  esp_aes_init(&context);
+  esp_aes_setkey(&context, key, 128);
+}
+
+void Aes128::encryptBlock(const uint8_t in[16], uint8_t out[16]) {
+  esp_aes_crypt_ecb(&context, ESP_AES_ENCRYPT, in, out);
+}
+
+void Aes128::ctr(const uint8_t counter[16], const uint8_t* in, uint8_t* out, size_t length) {
+  uint8_t nonceCounter[16];
+  uint8_t streamBlock[16];
+  size_t offset = 0;
+  memcpy(nonceCounter, counter, 16);
+  esp_aes_crypt_ctr(&context, length, &offset, nonceCounter, streamBlock, in, out);
+}
+
+void Aes128::cbcMac(const uint8_t* data, size_t length, uint8_t mac[16]) {
+  // The driver writes every ciphertext block; only the last one is kept
+  uint8_t iv[16] = {0};
+  uint8_t scratch[LINK_SECURE_MAX_FRAME + 16];
+  if (length > sizeof(scratch)) length = sizeof(scratch) & ~(size_t)15;
+  esp_aes_crypt_cbc(&context, ESP_AES_ENCRYPT, length, iv, data, scratch);
+  memcpy(mac, scratch + length - 16, 16);
+}
+#endif
+
+// CMAC subkey derivation: doubling in GF(2^128)
+static void doubleBlock(const uint8_t in[16], uint8_t out[16]) {
+  uint8_t carry = in[0] & 0x80;
+  for (int i = 0; i < 15; i++) {
+    out[i] = (uint8_t)((in[i] << 1) | (in[i + 1] >> 7));
+  }
+  out[15] = (uint8_t)(in[15] << 1);
+  if (carry) out[15] ^= 0x87;
+}
+
+void LinkCipher::begin(const uint8_t key[LINK_KEY_SIZE], LinkDirection direction) {
+  // Separate encryption and MAC keys per direction, derived from the one
+  // link key
+  Aes128 master;
+  uint8_t label[16] = {0};
+  uint8_t derived[16];
+  master.setKey(key);
+  label[1] = (uint8_t)direction;
+  label[0] = 1;
+  master.encryptBlock(label, derived);
+  encAes.setKey(derived);
+  label[0] = 2;
+  master.encryptBlock(label, derived);
+  macAes.setKey(derived);
+
+  uint8_t zero[16] = {0};
+  uint8_t l[16];
+  macAes.encryptBlock(zero, l);
+  doubleBlock(l, cmacK1);
+  doubleBlock(cmacK1, cmacK2);
+}
+
+void LinkCipher::keystream(uint32_t sequence, const uint8_t* in, uint8_t* out, size_t length) {
+  // Sequence in the top bytes, block counter in the bottom ones
+  uint8_t counter[16] = {0};
+  counter[0] = (uint8_t)sequence;
+  counter[1] = (uint8_t)(sequence >> 8);
+  counter[2] = (uint8_t)(sequence >> 16);
+  counter[3] = (uint8_t)(sequence >> 24);
+  encAes.ctr(counter, in, out, length);
+}
+
+void LinkCipher::tag(const uint8_t* data, size_t length, uint8_t out[LINK_TAG_SIZE]) {
+  uint8_t padded[LINK_SECURE_MAX_FRAME + 16];
+  size_t full = length / 16;
+  bool complete = length > 0 && length % 16 == 0;
+  size_t blocks = complete ? full : full + 1;
+
+  // Last block is XORed with K1 if complete, padded 10* and XORed with K2 if not
+  memcpy(padded, data, length);
+  if (!complete) {
+    padded[length] = 0x80;
+    memset(padded + length + 1, 0, blocks * 16 - length - 1);
+  }
+  const uint8_t* subkey = complete ? cmacK1 : cmacK2;
+  uint8_t* last = padded + (blocks - 1) * 16;
+  for (int i = 0; i < 16; i++) last[i] ^= subkey[i];
+
+  uint8_t mac[16];
+  macAes.cbcMac(padded, blocks * 16, mac);
+  memcpy(out, mac, LINK_TAG_SIZE);
+}
+
+void LinkSealer::begin(const uint8_t key[LINK_KEY_SIZE], uint32_t firstSequence,
+                       LinkDirection direction) {
+  LinkCipher::begin(key, direction);
+  sequence = firstSequence;
+}
+
+size_t LinkSealer::seal(const uint8_t* payload, size_t length, uint8_t* out) {
+  if (length > LINK_SECURE_MAX_PAYLOAD) return 0;
+
+  out[0] = LINK_FRAME_SECURE;
+  out[1] = (uint8_t)sequence;
+  out[2] = (uint8_t)(sequence >> 8);
+  out[3] = (uint8_t)(sequence >> 16);
+  out[4] = (uint8_t)(sequence >> 24);
+  keystream(sequence, payload, out + LINK_SECURE_HEADER, length);
+  tag(out, LINK_SECURE_HEADER + length, out + LINK_SECURE_HEADER + length);
+  sequence++;
+  return length + LINK_SECURE_OVERHEAD;
+}
+
+void LinkOpener::begin(const uint8_t key[LINK_KEY_SIZE], LinkDirection direction) {
+  LinkCipher::begin(key, direction);
+  openedFrames = 0;
+  authFailures = 0;
+  replayedFrames = 0;
+  started = false;
+  highest = 0;
+  window = 0;
+  lastOpened = 0;
+}
+
+bool LinkOpener::seen(uint32_t sequence) const {
+  if (!started || sequence > highest) return false;
+  uint32_t age = highest - sequence;
+  if (age >= LINK_REPLAY_WINDOW) return true;  // too old to tell, reject
+  return (window >> age) & 1;
+}
+
+void LinkOpener::accept(uint32_t sequence) {
+  if (!started) {
+    started = true;
+    highest = sequence;
+    window = 1;
+  } else if (sequence > highest) {
+    uint32_t shift = sequence - highest;
+    window = shift >= LINK_REPLAY_WINDOW ? 0 : window << shift;
+    window |= 1;
+    highest = sequence;
+  } else {
+    window |= (uint32_t)1 << (highest - sequence);
+  }
+}
+
+size_t LinkOpener::open(const uint8_t* frame, size_t length, uint8_t* out) {
+  if (length < LINK_SECURE_OVERHEAD || length > LINK_SECURE_MAX_FRAME ||
+      frame[0] != LINK_FRAME_SECURE) {
+    authFailures++;
+    return 0;
+  }
+
+  size_t bodyLength = length - LINK_TAG_SIZE;
+  uint8_t expected[LINK_TAG_SIZE];
+  tag(frame, bodyLength, expected);
+
+  // Constant-time compare, so timing does not leak how much of a tag matched
+  uint8_t diff = 0;
+  for (int i = 0; i < LINK_TAG_SIZE; i++) diff |= expected[i] ^ frame[bodyLength + i];
+  if (diff != 0) {
+    authFailures++;
+    return 0;
+  }
+
+  uint32_t sequence = (uint32_t)frame[1] | ((uint32_t)frame[2] << 8) |
+                      ((uint32_t)frame[3] << 16) | ((uint32_t)frame[4] << 24);
+  if (seen(sequence)) {
+    replayedFrames++;
+    return 0;
+  }
+  accept(sequence);
+  lastOpened = sequence;
+
+  size_t payloadLength = bodyLength - LINK_SECURE_HEADER;
+  keystream(sequence, frame + LINK_SECURE_HEADER, out, payloadLength);
+  openedFrames++;
+  return payloadLength;
+}
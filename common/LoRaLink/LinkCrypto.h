@@ -0,0 +1,147 @@
+/*********
+  EC Telemetry Link - Frame encryption and authentication
+  AES-128 in CTR mode for confidentiality and a CMAC tag truncated to
+  LINK_TAG_SIZE bytes for authenticity, keyed from one shared link key.
+  Every frame carries a 32-bit sequence number that is both the CTR nonce
+  and the replay counter; the receiver accepts each number once, inside a
+  sliding window so reordered and FEC-recovered frames still get through.
+
+  Each direction derives its own keys, so the vehicle's frames and the
+  pitstop's beacons never share a keystream. A beacon is sealed under the
+  sequence number of the frame it answers, which the vehicle knows it
+  sent since booting; any other number is a replay there.
+
+  Frame layout:
+    [0]     LINK_FRAME_SECURE
+    [1..4]  sequence number (little endian)
+    [5..]   ciphertext, same length as the payload
+    [last LINK_TAG_SIZE bytes] CMAC over everything before it
+
+  The ESP32 runs AES on its crypto peripheral; elsewhere (STM32, host) a
+  table-driven software AES is used. Only the encrypt direction of the
+  block cipher is needed for both CTR and CMAC.
+*********/
+
+#ifndef LINK_CRYPTO_H
+#define LINK_CRYPTO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "LinkFrames.h"
+
+#if defined(ESP_PLATFORM) && !defined(LINK_AES_SOFTWARE)
+#define LINK_AES_HW 1
+#if __has_include("aes/esp_aes.h")
+#include "aes/esp_aes.h"
+#else
+#include "hwcrypto/aes.h"
+#endif
+#else
+#define LINK_AES_HW 0
+#endif
+
+#define LINK_KEY_SIZE          16
+#define LINK_SEQ_SIZE          4
+#define LINK_TAG_SIZE          4
+#define LINK_SECURE_HEADER     (1 + LINK_SEQ_SIZE)
+#define LINK_SECURE_OVERHEAD   (LINK_SECURE_HEADER + LINK_TAG_SIZE)
+#define LINK_SECURE_MAX_FRAME  255
+#define LINK_SECURE_MAX_PAYLOAD (LINK_SECURE_MAX_FRAME - LINK_SECURE_OVERHEAD)
+// The window lives in RAM: after the pitstop restarts, the first sealed
+// frame it hears sets the window, so frames recorded before the restart
+// can be replayed once each until the vehicle's numbers move past them.
+#define LINK_REPLAY_WINDOW     32
+
+enum LinkDirection { LINK_UPLINK, LINK_DOWNLINK };  // vehicle -> pitstop, and back
+
+// Shared 16-byte link key. Give each team its own with
+//   -D LINK_KEY_BYTES=0x..,0x..,...  (same flag on sender and receiver)
+// The built-in key is public and only fit for bench testing.
+#ifndef LINK_KEY_BYTES
+#define LINK_KEY_BYTES 0x41,0x4B,0x53,0x2D,0x45,0x43,0x2D,0x54,0x45,0x53,0x54,0x2D,0x4B,0x45,0x59,0x21
+#define LINK_KEY_IS_DEFAULT 1
+#endif
+
+// AES-128 with the two bulk operations the link needs
+class Aes128 {
+public:
+  void setKey(const uint8_t key[LINK_KEY_SIZE]);
+  void encryptBlock(const uint8_t in[16], uint8_t out[16]);
+
+  // XORs the keystream for the 128-bit big-endian counter block into data
+  void ctr(const uint8_t counter[16], const uint8_t* in, uint8_t* out, size_t length);
+
+  // CBC-MAC with a zero IV over whole blocks (length a multiple of 16)
+  void cbcMac(const uint8_t* data, size_t length, uint8_t mac[16]);
+
+private:
+#if LINK_AES_HW
+  esp_aes_context context;
+#else
+  uint32_t roundKeys[44];
+#endif
+};
+
+// Key schedule and CMAC shared by both ends of the link
+class LinkCipher {
+public:
+  void begin(const uint8_t key[LINK_KEY_SIZE], LinkDirection direction = LINK_UPLINK);
+
+protected:
+  void keystream(uint32_t sequence, const uint8_t* in, uint8_t* out, size_t length);
+  void tag(const uint8_t* data, size_t length, uint8_t out[LINK_TAG_SIZE]);
+
+private:
+  Aes128 encAes;
+  Aes128 macAes;
+  uint8_t cmacK1[16];
+  uint8_t cmacK2[16];
+};
+
+// Vehicle side, and the pitstop's beacons
+class LinkSealer : public LinkCipher {
+public:
+  // firstSequence must never have been used with this key before
+  void begin(const uint8_t key[LINK_KEY_SIZE], uint32_t firstSequence,
+             LinkDirection direction = LINK_UPLINK);
+
+  // Beacons: seal the next frame under the sequence of the frame it answers
+  void setSequence(uint32_t next) { sequence = next; }
+
+  // Writes the sealed frame to out (length + LINK_SECURE_OVERHEAD bytes).
+  // Returns its length, or 0 if the payload exceeds LINK_SECURE_MAX_PAYLOAD.
+  size_t seal(const uint8_t* payload, size_t length, uint8_t* out);
+
+  uint32_t nextSequence() const { return sequence; }
+
+private:
+  uint32_t sequence = 0;
+};
+
+// Pitstop side, and the vehicle's beacon listener
+class LinkOpener : public LinkCipher {
+public:
+  void begin(const uint8_t key[LINK_KEY_SIZE], LinkDirection direction = LINK_UPLINK);
+
+  // Verifies and decrypts a sealed frame into out. Returns the payload
+  // length, or 0 for a forged, corrupted or replayed frame.
+  size_t open(const uint8_t* frame, size_t length, uint8_t* out);
+
+  // Sequence of the frame open() last accepted
+  uint32_t lastSequence() const { return lastOpened; }
+
+  uint32_t openedFrames;
+  uint32_t authFailures;
+  uint32_t replayedFrames;
+
+private:
+  bool seen(uint32_t sequence) const;
+  void accept(uint32_t sequence);
+
+  bool started;
+  uint32_t highest;
+  uint32_t window;     // bit n set: highest - n already accepted
+  uint32_t lastOpened;
+};
+
+#endif
@@ -0,0 +1,17 @@
+/*********
+  EC Telemetry Link - Frame type registry
+  First byte of every binary frame on the vehicle <-> pitstop LoRa link.
+  Plain JSON telemetry always starts with '{' (0x7B), so a receiver can
+  dispatch on the first byte without any extra framing.
+*********/
+
+#ifndef LINK_FRAMES_H
+#define LINK_FRAMES_H
+
+#define LINK_FRAME_JSON     '{'   // Legacy/plain JSON telemetry packet
+#define LINK_FRAME_FEC      0xFC  // TelemetryFec data or parity frame
+#define LINK_FRAME_BACKFILL 0xBF  // SampleCodec batch of buffered samples
+#define LINK_FRAME_BEACON   0xBE  // Pitstop -> vehicle link beacon
+#define LINK_FRAME_SECURE   0xA5  // LinkCrypto encrypted and authenticated frame
+
+#endif
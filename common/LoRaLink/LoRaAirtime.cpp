@@ -0,0 +1,20 @@
+#include "LoRaAirtime.h"
+
+uint32_t loraTimeOnAirUs(const LoRaRadioConfig& config, uint8_t payloadLength) {
+  const int32_t sf = config.spreadingFactor;
+  const uint64_t symbolUs = ((uint64_t)1000000 << sf) / config.signalBandwidth;
+  const int32_t lowDataRate = symbolUs > 16000 ? 1 : 0;
+
+  // Payload symbols: 8 + max(ceil((8PL - 4SF + 28 + 16CRC - 20IH) / (4(SF - 2DE))) * CR, 0)
+  int32_t numerator = 8 * (int32_t)payloadLength - 4 * sf + 28
+                    + (config.crc ? 16 : 0) - (config.implicitHeader ? 20 : 0);
+  int32_t denominator = 4 * (sf - 2 * lowDataRate);
+  int32_t payloadSymbols = 8;
+  if (numerator > 0) {
+    payloadSymbols += ((numerator + denominator - 1) / denominator) * config.codingRateDenom;
+  }
+
+  // Preamble is (n + 4.25) symbols, so count everything in quarter symbols
+  uint64_t quarterSymbols = (uint64_t)config.preambleLength * 4 + 17 + (uint64_t)payloadSymbols * 4;
+  return (uint32_t)((quarterSymbols * ((uint64_t)1000000 << sf) / config.signalBandwidth) / 4);
+}
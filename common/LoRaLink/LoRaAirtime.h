@@ -0,0 +1,28 @@
+/*********
+  EC Telemetry Link - LoRa time-on-air calculator
+  Semtech SX127x time-on-air formula (AN1200.13), integer only so it
+  gives the same answer on the ESP32, the STM32 and the host.
+*********/
+
+#ifndef LORA_AIRTIME_H
+#define LORA_AIRTIME_H
+
+#include <stdint.h>
+
+// Radio settings that affect time-on-air. Mirrors what is passed to the
+// sandeepmistry LoRa library in setup() on both ends of the link.
+struct LoRaRadioConfig {
+  uint8_t spreadingFactor;   // 6..12
+  uint32_t signalBandwidth;  // Hz, e.g. 125000
+  uint8_t codingRateDenom;   // 5..8 for 4/5..4/8
+  uint16_t preambleLength;   // symbols (library default 8)
+  bool crc;                  // payload CRC enabled
+  bool implicitHeader;       // implicit header mode
+};
+
+// Time-on-air of one packet with the given payload length, in microseconds.
+// Low data rate optimisation is applied automatically for symbols longer
+// than 16 ms, the same rule the LoRa library uses.
+uint32_t loraTimeOnAirUs(const LoRaRadioConfig& config, uint8_t payloadLength);
+
+#endif
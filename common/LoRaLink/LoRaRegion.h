@@ -0,0 +1,37 @@
+/*********
+  EC Telemetry Link - Regional radio settings
+  Pick the band with -D LORA_REGION=LORA_REGION_xxx in platformio.ini.
+  Sender and receiver must be built for the same region.
+*********/
+
+#ifndef LORA_REGION_H
+#define LORA_REGION_H
+
+#define LORA_REGION_EU433  1   // 433.05-434.79 MHz SRD band, 10% duty cycle
+#define LORA_REGION_EU868  2   // 868.0-868.6 MHz sub-band g1, 1% duty cycle
+#define LORA_REGION_US915  3   // 902-928 MHz, no duty cycle limit
+
+#ifndef LORA_REGION
+#define LORA_REGION LORA_REGION_EU433
+#endif
+
+#if LORA_REGION == LORA_REGION_EU433
+#define LORA_REGION_NAME          "EU433"
+#define LORA_FREQUENCY            433175000L
+#define LORA_DUTY_CYCLE_PERMILLE  100   // 10%
+#define LORA_MAX_TX_POWER         10    // dBm ERP
+#elif LORA_REGION == LORA_REGION_EU868
+#define LORA_REGION_NAME          "EU868"
+#define LORA_FREQUENCY            868100000L
+#define LORA_DUTY_CYCLE_PERMILLE  10    // 1%
+#define LORA_MAX_TX_POWER         14    // dBm ERP
+#elif LORA_REGION == LORA_REGION_US915
+#define LORA_REGION_NAME          "US915"
+#define LORA_FREQUENCY            915000000L
+#define LORA_DUTY_CYCLE_PERMILLE  1000  // no duty cycle, dwell time only
+#define LORA_MAX_TX_POWER         20    // dBm
+#else
+#error "Unknown LORA_REGION"
+#endif
+
+#endif
@@ -0,0 +1,107 @@
+#include "SampleCodec.h"
+
+static void sampleToFields(const TelemetrySample& s, int32_t* f) {
+  f[0] = (int32_t)s.timestampMs;
+  f[1] = s.batteryVoltage;
+  f[2] = s.batteryCurrent;
+  f[3] = s.batterySoc;
+  f[4] = s.batteryTemp;
+  f[5] = s.motorTemp;
+  f[6] = s.motorCurrent;
+  f[7] = s.vehicleSpeed;
+  f[8] = s.motorRpm;
+  f[9] = s.energyConsumption;
+  f[10] = s.motorEfficiency;
+}
+
+static void fieldsToSample(const int32_t* f, TelemetrySample& s) {
+  s.timestampMs = (uint32_t)f[0];
+  s.batteryVoltage = (uint16_t)f[1];
+  s.batteryCurrent = (int16_t)f[2];
+  s.batterySoc = (uint16_t)f[3];
+  s.batteryTemp = (int16_t)f[4];
+  s.motorTemp = (int16_t)f[5];
+  s.motorCurrent = (int16_t)f[6];
+  s.vehicleSpeed = (uint16_t)f[7];
+  s.motorRpm = (uint16_t)f[8];
+  s.energyConsumption = (uint16_t)f[9];
+  s.motorEfficiency = (uint8_t)f[10];
+}
+
+static size_t putVarint(uint8_t* out, int32_t value) {
+  // Zigzag maps small negative and positive deltas to small codes
+  uint32_t v = ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+  size_t n = 0;
+  while (v >= 0x80) {
+    out[n++] = (uint8_t)(v | 0x80);
+    v >>= 7;
+  }
+  out[n++] = (uint8_t)v;
+  return n;
+}
+
+static bool getVarint(const uint8_t* in, size_t length, size_t& pos, int32_t& value) {
+  uint32_t v = 0;
+  for (uint8_t shift = 0; shift < 35; shift += 7) {
+    if (pos >= length) return false;
+    uint8_t b = in[pos++];
+    v |= (uint32_t)(b & 0x7F) << shift;
+    if (!(b & 0x80)) {
+      value = (int32_t)(v >> 1) ^ -(int32_t)(v & 1);
+      return true;
+    }
+  }
+  return false;
+}
+
+size_t encodeSampleBatch(const TelemetrySample* samples, size_t count,
+                         uint8_t* out, size_t maxLength, size_t* encoded) {
+  *encoded = 0;
+  if (maxLength <= SAMPLE_BATCH_HEADER) return 0;
+  if (count > SAMPLE_BATCH_MAX) count = SAMPLE_BATCH_MAX;
+
+  int32_t previous[SAMPLE_FIELD_COUNT] = {0};
+  int32_t fields[SAMPLE_FIELD_COUNT];
+  uint8_t scratch[SAMPLE_FIELD_COUNT * 5];
+  size_t length = SAMPLE_BATCH_HEADER;
+
+  for (size_t i = 0; i < count; i++) {
+    sampleToFields(samples[i], fields);
+
+    // The first sample is coded against zero, so it carries absolute values
+    size_t n = 0;
+    for (uint8_t f = 0; f < SAMPLE_FIELD_COUNT; f++) {
+      n += putVarint(scratch + n, (int32_t)((uint32_t)fields[f] - (uint32_t)previous[f]));
+      previous[f] = fields[f];
+    }
+    if (length + n > maxLength) break;
+
+    for (size_t b = 0; b < n; b++) out[length + b] = scratch[b];
+    length += n;
+    (*encoded)++;
+  }
+
+  if (*encoded == 0) return 0;
+  out[0] = LINK_FRAME_BACKFILL;
+  out[1] = (uint8_t)*encoded;
+  return length;
+}
+
+size_t decodeSampleBatch(const uint8_t* frame, size_t length,
+                         TelemetrySample* out, size_t maxSamples) {
+  if (length < SAMPLE_BATCH_HEADER || frame[0] != LINK_FRAME_BACKFILL) return 0;
+  size_t count = frame[1];
+  if (count == 0 || count > maxSamples) return 0;
+
+  int32_t fields[SAMPLE_FIELD_COUNT] = {0};
+  size_t pos = SAMPLE_BATCH_HEADER;
+  for (size_t i = 0; i < count; i++) {
+    for (uint8_t f = 0; f < SAMPLE_FIELD_COUNT; f++) {
+      int32_t delta;
+      if (!getVarint(frame, length, pos, delta)) return 0;
+      fields[f] = (int32_t)((uint32_t)fields[f] + (uint32_t)delta);
+    }
+    fieldsToSample(fields, out[i]);
+  }
+  return pos == length ? count : 0;
+}
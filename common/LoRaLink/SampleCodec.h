@@ -0,0 +1,50 @@
+/*********
+  EC Telemetry Link - Compact telemetry samples and backfill batches
+  A TelemetrySample is one updateSensorReadings() snapshot in fixed point,
+  small enough to buffer thousands of them on the vehicle. Batches of
+  samples are delta coded against the previous sample and written as
+  zigzag varints, so slowly changing channels cost one byte each.
+
+  Batch frame layout:
+    [0] LINK_FRAME_BACKFILL
+    [1] sample count
+    [2..] first sample as varints, then one delta per field per sample
+*********/
+
+#ifndef SAMPLE_CODEC_H
+#define SAMPLE_CODEC_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "LinkFrames.h"
+
+#define SAMPLE_FIELD_COUNT   11
+#define SAMPLE_BATCH_HEADER  2
+#define SAMPLE_BATCH_MAX     32
+
+struct TelemetrySample {
+  uint32_t timestampMs;        // vehicle millis() when sampled
+  uint16_t batteryVoltage;     // 0.1 V
+  int16_t  batteryCurrent;     // 0.1 A
+  uint16_t batterySoc;         // 0.1 %
+  int16_t  batteryTemp;        // 0.1 °C
+  int16_t  motorTemp;          // 0.1 °C
+  int16_t  motorCurrent;       // 0.1 A
+  uint16_t vehicleSpeed;       // 0.1 km/h
+  uint16_t motorRpm;           // RPM
+  uint16_t energyConsumption;  // 0.1 Wh/km
+  uint8_t  motorEfficiency;    // %
+};
+
+// Encodes up to count samples (oldest first) into a batch frame of at most
+// maxLength bytes. Returns the frame length; *encoded is set to the number
+// of samples that fit, which may be fewer than count.
+size_t encodeSampleBatch(const TelemetrySample* samples, size_t count,
+                         uint8_t* out, size_t maxLength, size_t* encoded);
+
+// Decodes a batch frame into at most maxSamples samples.
+// Returns the sample count, 0 for a malformed frame.
+size_t decodeSampleBatch(const uint8_t* frame, size_t length,
+                         TelemetrySample* out, size_t maxSamples);
+
+#endif
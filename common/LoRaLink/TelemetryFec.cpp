@@ -0,0 +1,193 @@
+#include "TelemetryFec.h"
+#include <string.h>
+
+// ---------------------------------------------------------------- encoder
+
+bool FecEncoder::begin(uint8_t groupSize, uint8_t interleaveDepth) {
+  if (groupSize < 2 || groupSize > FEC_MAX_GROUP_SIZE) return false;
+  if (interleaveDepth < 1 || interleaveDepth > FEC_MAX_DEPTH) return false;
+
+  k = groupSize;
+  d = interleaveDepth;
+  nextSlot = 0;
+  nextGroupId = 0;
+  readySlot = -1;
+  for (uint8_t slot = 0; slot < d; slot++) {
+    openGroup(slot);
+  }
+  return true;
+}
+
+void FecEncoder::openGroup(uint8_t slot) {
+  Group& group = groups[slot];
+  group.id = nextGroupId++;
+  group.count = 0;
+  group.lengthXor = 0;
+  group.maxLength = 0;
+  memset(group.parity, 0, sizeof(group.parity));
+}
+
+size_t FecEncoder::encode(const uint8_t* payload, size_t length, uint8_t* out) {
+  if (k == 0 || length > FEC_MAX_PAYLOAD) return 0;
+
+  // A parity frame not collected by the caller is dropped, the group restarts
+  if (readySlot >= 0) {
+    openGroup(readySlot);
+    readySlot = -1;
+  }
+
+  uint8_t slot = nextSlot;
+  nextSlot = (nextSlot + 1) % d;
+  Group& group = groups[slot];
+
+  out[0] = LINK_FRAME_FEC;
+  out[1] = k;
+  out[2] = group.id;
+  out[3] = group.count;
+  memcpy(out + FEC_HEADER_SIZE, payload, length);
+
+  for (size_t i = 0; i < length; i++) {
+    group.parity[i] ^= payload[i];
+  }
+  group.lengthXor ^= (uint16_t)length;
+  if (length > group.maxLength) group.maxLength = length;
+
+  if (++group.count == k) {
+    readySlot = slot;
+  }
+  return FEC_HEADER_SIZE + length;
+}
+
+size_t FecEncoder::takeParity(uint8_t* out) {
+  if (readySlot < 0) return 0;
+
+  Group& group = groups[readySlot];
+  out[0] = LINK_FRAME_FEC;
+  out[1] = FEC_FLAG_PARITY | k;
+  out[2] = group.id;
+  out[3] = k;
+  out[4] = group.lengthXor & 0xFF;
+  out[5] = group.lengthXor >> 8;
+  memcpy(out + FEC_HEADER_SIZE + 2, group.parity, group.maxLength);
+  size_t frameLength = FEC_HEADER_SIZE + 2 + group.maxLength;
+
+  openGroup(readySlot);
+  readySlot = -1;
+  return frameLength;
+}
+
+// ---------------------------------------------------------------- decoder
+
+void FecDecoder::begin(FecDeliverFn deliver) {
+  deliverFn = deliver;
+  memset(groups, 0, sizeof(groups));
+}
+
+FecDecoder::Group* FecDecoder::findGroup(uint8_t id, uint8_t k, bool create) {
+  Group* oldest = &groups[0];
+  for (uint8_t i = 0; i < FEC_DECODER_GROUPS; i++) {
+    Group& group = groups[i];
+    if (group.used && group.id == id && group.k == k) {
+      group.lastTouch = ++touchCounter;
+      return &group;
+    }
+    if (!group.used) {
+      oldest = &group;
+    } else if (oldest->used && group.lastTouch < oldest->lastTouch) {
+      oldest = &group;
+    }
+  }
+  if (!create) return 0;
+
+  // Evicting a group whose parity never arrived loses nothing extra:
+  // its missing frames are already counted as lost by packet ID
+  oldest->used = true;
+  oldest->id = id;
+  oldest->k = k;
+  oldest->receivedMask = 0;
+  oldest->lastTouch = ++touchCounter;
+  return oldest;
+}
+
+bool FecDecoder::push(const uint8_t* frame, size_t length) {
+  if (length < FEC_HEADER_SIZE || frame[0] != LINK_FRAME_FEC) return false;
+
+  bool isParity = frame[1] & FEC_FLAG_PARITY;
+  uint8_t k = frame[1] & 0x0F;
+  uint8_t groupId = frame[2];
+  uint8_t index = frame[3];
+  if (k < 2 || k > FEC_MAX_GROUP_SIZE) return false;
+
+  if (isParity) {
+    if (length < FEC_HEADER_SIZE + 2 || length > FEC_MAX_FRAME) return false;
+    parityFrames++;
+    Group* group = findGroup(groupId, k, false);
+    if (group) {
+      resolveGroup(*group, frame + FEC_HEADER_SIZE, length - FEC_HEADER_SIZE);
+    } else {
+      unrecoverableFrames += k;  // whole group missing
+    }
+    return true;
+  }
+
+  size_t payloadLength = length - FEC_HEADER_SIZE;
+  if (index >= k || payloadLength > FEC_MAX_PAYLOAD) return false;
+  dataFrames++;
+
+  Group* group = findGroup(groupId, k, true);
+  if (!(group->receivedMask & (1 << index))) {
+    group->receivedMask |= 1 << index;
+    group->length[index] = payloadLength;
+    memcpy(group->data[index], frame + FEC_HEADER_SIZE, payloadLength);
+  }
+
+  if (deliverFn) deliverFn(frame + FEC_HEADER_SIZE, payloadLength, false);
+  return true;
+}
+
+void FecDecoder::resolveGroup(Group& group, const uint8_t* parity, size_t length) {
+  uint8_t fullMask = (1 << group.k) - 1;
+  uint8_t missingMask = fullMask & ~group.receivedMask;
+  group.used = false;
+
+  if (missingMask == 0) return;
+
+  uint8_t missingCount = 0;
+  uint8_t missingIndex = 0;
+  for (uint8_t i = 0; i < group.k; i++) {
+    if (missingMask & (1 << i)) {
+      missingCount++;
+      missingIndex = i;
+    }
+  }
+  if (missingCount > 1) {
+    unrecoverableFrames += missingCount;
+    return;
+  }
+
+  // Missing frame = parity XOR every frame we did receive
+  uint16_t missingLength = parity[0] | (parity[1] << 8);
+  const uint8_t* parityData = parity + 2;
+  size_t parityLength = length - 2;
+  uint8_t* rebuilt = group.data[missingIndex];
+
+  for (uint8_t i = 0; i < group.k; i++) {
+    if (i != missingIndex) missingLength ^= group.length[i];
+  }
+  if (missingLength > parityLength) {
+    unrecoverableFrames++;
+    return;
+  }
+
+  memcpy(rebuilt, parityData, missingLength);
+  for (uint8_t i = 0; i < group.k; i++) {
+    if (i == missingIndex) continue;
+    size_t n = group.length[i] < missingLength ? group.length[i] : missingLength;
+    for (size_t j = 0; j < n; j++) {
+      rebuilt[j] ^= group.data[i][j];
+    }
+  }
+
+  recoveredFrames++;
+  if (deliverFn) deliverFn(rebuilt, missingLength, true);
+}
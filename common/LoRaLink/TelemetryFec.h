@@ -0,0 +1,107 @@
+/*********
+  EC Telemetry Link - Packet-level forward error correction
+  XOR parity over groups of K consecutive telemetry frames. Several groups
+  are filled round-robin (interleaving depth D), so a burst of up to D
+  lost packets costs at most one frame per group and every frame of the
+  burst can be rebuilt from its group's parity frame.
+
+  Frame layout (all frames start with LINK_FRAME_FEC):
+    [0] LINK_FRAME_FEC
+    [1] bit 7 = parity frame, bits 0-3 = group size K
+    [2] group ID (rolling)
+    [3] index in group (0..K-1, K for the parity frame)
+    data frame:   [4..] original payload
+    parity frame: [4..5] XOR of payload lengths (little endian)
+                  [6..]  XOR of payloads, zero padded to the longest one
+*********/
+
+#ifndef TELEMETRY_FEC_H
+#define TELEMETRY_FEC_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "LinkFrames.h"
+
+#define FEC_HEADER_SIZE     4
+#define FEC_MAX_GROUP_SIZE  8
+#define FEC_MAX_DEPTH       4
+#define FEC_MAX_PAYLOAD     248   // keeps parity frames inside one 255-byte LoRa packet
+#define FEC_MAX_FRAME       (FEC_HEADER_SIZE + 2 + FEC_MAX_PAYLOAD)
+#define FEC_DECODER_GROUPS  (FEC_MAX_DEPTH + 2)
+
+#define FEC_FLAG_PARITY     0x80
+
+// Vehicle side: wraps payloads into data frames and produces parity frames
+class FecEncoder {
+public:
+  // groupSize: data frames per parity frame (2..FEC_MAX_GROUP_SIZE)
+  // depth: groups filled round-robin (1..FEC_MAX_DEPTH)
+  bool begin(uint8_t groupSize, uint8_t depth);
+
+  // Wraps payload into a data frame. out must hold FEC_MAX_FRAME bytes.
+  // Returns the frame length, or 0 if the payload is too long.
+  size_t encode(const uint8_t* payload, size_t length, uint8_t* out);
+
+  // Parity frame completed by the last encode() call, if any.
+  // Returns the frame length, or 0 when no parity frame is due.
+  size_t takeParity(uint8_t* out);
+
+  uint8_t groupSize() const { return k; }
+  uint8_t depth() const { return d; }
+
+private:
+  struct Group {
+    uint8_t id;
+    uint8_t count;
+    uint16_t lengthXor;
+    uint16_t maxLength;
+    uint8_t parity[FEC_MAX_PAYLOAD];
+  };
+
+  void openGroup(uint8_t slot);
+
+  Group groups[FEC_MAX_DEPTH];
+  uint8_t k = 0;
+  uint8_t d = 0;
+  uint8_t nextSlot = 0;
+  uint8_t nextGroupId = 0;
+  int8_t readySlot = -1;
+};
+
+// Pitstop side: passes data frames through and rebuilds single losses
+typedef void (*FecDeliverFn)(const uint8_t* payload, size_t length, bool recovered);
+
+class FecDecoder {
+public:
+  void begin(FecDeliverFn deliver);
+
+  // Feeds one received FEC frame. Data frames are delivered immediately,
+  // a frame rebuilt from parity is delivered with recovered = true.
+  // Returns false if the frame is malformed.
+  bool push(const uint8_t* frame, size_t length);
+
+  uint32_t dataFrames = 0;           // data frames received
+  uint32_t parityFrames = 0;         // parity frames received
+  uint32_t recoveredFrames = 0;      // frames rebuilt from parity
+  uint32_t unrecoverableFrames = 0;  // frames lost with their group short of parity
+
+private:
+  struct Group {
+    bool used;
+    uint8_t id;
+    uint8_t k;
+    uint8_t receivedMask;
+    uint32_t lastTouch;
+    uint16_t length[FEC_MAX_GROUP_SIZE];
+    uint8_t data[FEC_MAX_GROUP_SIZE][FEC_MAX_PAYLOAD];
+  };
+
+  Group* findGroup(uint8_t id, uint8_t k, bool create);
+  void resolveGroup(Group& group, const uint8_t* parity, size_t length);
+
+  Group groups[FEC_DECODER_GROUPS];
+  FecDeliverFn deliverFn = 0;
+  uint32_t touchCounter = 0;
+};
+
+#endif
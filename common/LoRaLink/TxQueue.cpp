@@ -0,0 +1,84 @@
+#include "TxQueue.h"
+#include <string.h>
+
+bool TxQueue::push(FramePriority priority, const uint8_t* data, size_t length, uint32_t nowMs) {
+  if (length == 0 || length > TXQ_MAX_FRAME) return false;
+
+  Ring& ring = rings[priority];
+  if (ring.count == TXQ_SLOTS_PER_CLASS) {
+    ring.head = (ring.head + 1) % TXQ_SLOTS_PER_CLASS;
+    ring.count--;
+    classStats[priority].dropped++;
+  }
+
+  TxFrame& frame = ring.slots[(ring.head + ring.count) % TXQ_SLOTS_PER_CLASS];
+  memcpy(frame.data, data, length);
+  frame.length = length;
+  frame.priority = priority;
+  frame.enqueuedMs = nowMs;
+  frame.deferred = false;
+  ring.count++;
+  classStats[priority].queued++;
+  return true;
+}
+
+TxFrame* TxQueue::peek(uint32_t nowMs) {
+  TxFrame* best = 0;
+  int32_t bestRank = 0;
+
+  // Only the head of each class can be sent, so compare class heads by
+  // their aged priority; ties go to the higher base class
+  for (uint8_t p = 0; p < PRIORITY_COUNT; p++) {
+    Ring& ring = rings[p];
+    if (ring.count == 0) continue;
+
+    TxFrame* head = &ring.slots[ring.head];
+    int32_t promotion = aging > 0 ? (int32_t)((nowMs - head->enqueuedMs) / aging) : 0;
+    int32_t rank = (int32_t)p - promotion;
+    if (rank < 0) rank = 0;
+
+    if (!best || rank < bestRank) {
+      best = head;
+      bestRank = rank;
+    }
+  }
+  return best;
+}
+
+void TxQueue::defer(TxFrame* frame) {
+  if (!frame->deferred) {
+    frame->deferred = true;
+    classStats[frame->priority].deferred++;
+  }
+}
+
+void TxQueue::pop(TxFrame* frame, uint32_t nowMs) {
+  Ring& ring = rings[frame->priority];
+  if (ring.count == 0 || frame != &ring.slots[ring.head]) return;
+
+  uint32_t delayMs = nowMs - frame->enqueuedMs;
+  TxClassStats& stats = classStats[frame->priority];
+  stats.sent++;
+  stats.totalDelayMs += delayMs;
+  if (delayMs > stats.maxDelayMs) stats.maxDelayMs = delayMs;
+
+  ring.head = (ring.head + 1) % TXQ_SLOTS_PER_CLASS;
+  ring.count--;
+}
+
+void TxQueue::discard(TxFrame* frame) {
+  Ring& ring = rings[frame->priority];
+  if (ring.count == 0 || frame != &ring.slots[ring.head]) return;
+
+  classStats[frame->priority].dropped++;
+  ring.head = (ring.head + 1) % TXQ_SLOTS_PER_CLASS;
+  ring.count--;
+}
+
+size_t TxQueue::size() const {
+  size_t total = 0;
+  for (uint8_t p = 0; p < PRIORITY_COUNT; p++) {
+    total += rings[p].count;
+  }
+  return total;
+}
@@ -0,0 +1,72 @@
+/*********
+  EC Telemetry Link - Multi-level transmit queue
+  One FIFO per FramePriority class, served in strict priority order so a
+  fault frame takes the next free air slot instead of waiting behind a
+  periodic sample. Aging stops starvation: every agingMs a frame waits it
+  competes one class higher. Queueing delay is tracked per class.
+*********/
+
+#ifndef TX_QUEUE_H
+#define TX_QUEUE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "AirtimeBudget.h"
+
+#define TXQ_SLOTS_PER_CLASS  4
+#define TXQ_MAX_FRAME        255
+
+struct TxFrame {
+  uint8_t data[TXQ_MAX_FRAME];
+  uint8_t length;
+  FramePriority priority;   // class the frame was queued in
+  uint32_t enqueuedMs;
+  bool deferred;            // already refused once by the airtime budget
+};
+
+// Per-class counters, delays in milliseconds
+struct TxClassStats {
+  uint32_t queued;
+  uint32_t sent;
+  uint32_t dropped;         // pushed out of a full class or discarded
+  uint32_t deferred;        // frames that had to wait for airtime budget
+  uint32_t totalDelayMs;
+  uint32_t maxDelayMs;
+};
+
+class TxQueue {
+public:
+  explicit TxQueue(uint32_t agingMs) : aging(agingMs) {}
+
+  // Queues a copy of the frame. A full class drops its oldest frame.
+  bool push(FramePriority priority, const uint8_t* data, size_t length, uint32_t nowMs);
+
+  // Frame to send next, or 0 if every class is empty
+  TxFrame* peek(uint32_t nowMs);
+
+  // Marks the frame from peek() as refused by the airtime budget
+  void defer(TxFrame* frame);
+
+  // Removes the frame from peek() after it went on air
+  void pop(TxFrame* frame, uint32_t nowMs);
+
+  // Removes the frame from peek() without sending it, counted as dropped
+  void discard(TxFrame* frame);
+
+  size_t size() const;
+  size_t size(FramePriority priority) const { return rings[priority].count; }
+  const TxClassStats& stats(FramePriority priority) const { return classStats[priority]; }
+
+private:
+  struct Ring {
+    TxFrame slots[TXQ_SLOTS_PER_CLASS];
+    uint8_t head;
+    uint8_t count;
+  };
+
+  uint32_t aging;
+  Ring rings[PRIORITY_COUNT] = {};
+  TxClassStats classStats[PRIORITY_COUNT] = {};
+};
+
+#endif
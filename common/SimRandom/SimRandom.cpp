@@ -0,0 +1,44 @@
+#include "SimRandom.h"
+
+static inline uint32_t rotl(uint32_t x, int k) {
+    return (x << k) | (x >> (32 - k));
+}
+
+void SimRandom::reseed(uint32_t seed) {
+    initialSeed = seed;
+    // splitmix32 expansion
+    uint32_t z = seed;
+    for (int i = 0; i < 4; i++) {
+        z += 0x9E3779B9u;
+        uint32_t x = z;
+        x = (x ^ (x >> 16)) * 0x85EBCA6Bu;
+        x = (x ^ (x >> 13)) * 0xC2B2AE35u;
+        state[i] = x ^ (x >> 16);
+    }
+}
+
+uint32_t SimRandom::next() {
+    uint32_t result = rotl(state[1] * 5, 7) * 9;
+    uint32_t t = state[1] << 9;
+
+    state[2] ^= state[0];
+    state[3] ^= state[1];
+    state[1] ^= state[2];
+    state[0] ^= state[3];
+    state[2] ^= t;
+    state[3] = rotl(state[3], 11);
+
+    return result;
+}
+
+int32_t SimRandom::range(int32_t low, int32_t high) {
+    if (high <= low) return low;
+    return low + (int32_t)below((uint32_t)(high - low));
+}
+
+float SimRandom::gaussian(float sigma) {
+    // Sum of four uniform bytes: mean 510, standard deviation 147.8
+    uint32_t r = next();
+    int32_t sum = (int32_t)(r & 0xFF) + ((r >> 8) & 0xFF) + ((r >> 16) & 0xFF) + (r >> 24);
+    return (sum - 510) * (sigma / 147.8f);
+}
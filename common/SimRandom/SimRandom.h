@@ -0,0 +1,51 @@
+/*
+ * AKS Simulation - seedable pseudo-random numbers
+ * xoshiro128** (Blackman & Vigna): 128-bit state, a handful of shifts and
+ * one multiply per draw, no division, so it is much cheaper than the
+ * Arduino random() and identical on every core and on a host build.
+ * The 32-bit seed is expanded with splitmix32, so every seed (including
+ * 0) gives a well-mixed state and a printed seed replays a whole session.
+ *
+ * Shared by the data generator, lora_sender and the host tools.
+ */
+
+#ifndef SIM_RANDOM_H
+#define SIM_RANDOM_H
+
+#include <stdint.h>
+
+class SimRandom {
+public:
+    explicit SimRandom(uint32_t seed = 1) { reseed(seed); }
+
+    void reseed(uint32_t seed);
+    uint32_t seed() const { return initialSeed; }
+
+    uint32_t next();
+    // Uniform integer in [0, bound), multiply-shift reduction
+    uint32_t below(uint32_t bound) { return (uint32_t)(((uint64_t)next() * bound) >> 32); }
+    // Uniform integer in [low, high), drop-in for Arduino random(low, high)
+    int32_t range(int32_t low, int32_t high);
+    // Uniform float in [0, 1) from the top 24 bits
+    float uniform() { return (next() >> 8) * (1.0f / 16777216.0f); }
+    // Uniform noise in [-amplitude, amplitude)
+    float noise(float amplitude) { return (2.0f * uniform() - 1.0f) * amplitude; }
+    // Approximately normal, mean 0 and the given sigma: Irwin-Hall sum of
+    // the four bytes of one draw, bounded at about +-3.5 sigma. No log or
+    // trig calls, good enough for sensor noise.
+    float gaussian(float sigma);
+
+private:
+    uint32_t state[4];
+    uint32_t initialSeed;
+};
+
+// Seed to use at boot: SIM_SEED when defined at build time, otherwise the
+// entropy the caller supplies. Print the result so the run can be replayed.
+#ifdef SIM_SEED
+#define SIM_BOOT_SEED(entropy) ((uint32_t)(SIM_SEED))
+#else
+#define SIM_BOOT_SEED(entropy) ((uint32_t)(entropy))
+#endif
+
+#endif
@@ -0,0 +1,101 @@
+#include "DriveScenario.h"
+#include <AksRegisters.h>
+
+// km/h -> m/s and 0.1 % -> rise/run, both Q16.16
+#define KMH_TO_MS Q16(1.0 / 3.6)
+#define DECIPCT_TO_GRADE Q16(0.001)
+
+// Rolling lap of a 2.1 km street circuit: start/finish straight, hairpin,
+// 3 % climb, fast descent and a chicane back onto the straight
+static const ScenarioPoint EFFICIENCY_LAP[] = {
+    {   0, 20,   0 },
+    {  15, 40,   0 },
+    {  45, 45,   0 },
+    {  55, 25,   0 },   // hairpin
+    {  65, 25,   0 },
+    {  80, 40,  30 },   // climb
+    { 110, 35,  30 },
+    { 120, 40,   0 },
+    { 140, 50, -25 },   // descent
+    { 160, 45, -25 },
+    { 170, 30,   0 },   // chicane
+    { 180, 30,   0 },
+    { 195, 40,   0 },
+    { 210, 20,   0 },
+};
+
+static const ScenarioEvent EFFICIENCY_EVENTS[] = {
+    {  600, SCENARIO_SET_FAULTS,   AKS_FAULT_SENSOR },
+    {  615, SCENARIO_CLEAR_FAULTS, AKS_FAULT_SENSOR },
+    { 1200, SCENARIO_POWER_LIMIT,  60 },
+    { 1200, SCENARIO_SET_FAULTS,   AKS_FAULT_MOTOR_OVERTEMP },
+    { 1320, SCENARIO_CLEAR_FAULTS, AKS_FAULT_MOTOR_OVERTEMP },
+    { 1320, SCENARIO_POWER_LIMIT,  100 },
+    { 1900, SCENARIO_SET_FAULTS,   AKS_FAULT_BRAKE },
+    { 1960, SCENARIO_CLEAR_FAULTS, AKS_FAULT_BRAKE },
+};
+
+const DriveScenario SCENARIO_EFFICIENCY_RACE = {
+    "efficiency-race",
+    EFFICIENCY_LAP, sizeof(EFFICIENCY_LAP) / sizeof(EFFICIENCY_LAP[0]),
+    12,
+    EFFICIENCY_EVENTS, sizeof(EFFICIENCY_EVENTS) / sizeof(EFFICIENCY_EVENTS[0]),
+};
+
+void ScenarioPlayer::begin(const DriveScenario &scenario) {
+    s = &scenario;
+    elapsed = 0;
+    lapStart = 0;
+    currentLap = 1;
+    nextEvent = 0;
+    done = false;
+    limit = Q16_ONE;
+    faults = 0;
+    sampleProfile(0);
+}
+
+void ScenarioPlayer::step(q16_t dt) {
+    if (!s || done) return;
+    elapsed += dt;
+
+    while (nextEvent < s->eventCount && q16FromInt(s->events[nextEvent].timeS) <= elapsed) {
+        const ScenarioEvent &event = s->events[nextEvent++];
+        switch (event.action) {
+            case SCENARIO_SET_FAULTS:   faults |= event.value; break;
+            case SCENARIO_CLEAR_FAULTS: faults &= ~event.value; break;
+            case SCENARIO_POWER_LIMIT:  limit = q16FromInt(event.value) / 100; break;
+        }
+    }
+
+    q16_t lapLength = q16FromInt(s->lap[s->lapPoints - 1].timeS);
+    while (elapsed - lapStart >= lapLength) {
+        lapStart += lapLength;
+        if (currentLap == s->laps) {
+            // Race over: coast to a stop on the straight
+            done = true;
+            speed = 0;
+            roadGrade = 0;
+            return;
+        }
+        currentLap++;
+    }
+    sampleProfile(elapsed - lapStart);
+}
+
+void ScenarioPlayer::sampleProfile(q16_t lapTime) {
+    const ScenarioPoint *a = &s->lap[0];
+    const ScenarioPoint *b = a;
+    for (uint8_t i = 1; i < s->lapPoints; i++) {
+        b = &s->lap[i];
+        if (q16FromInt(b->timeS) > lapTime) break;
+        a = b;
+    }
+
+    q16_t speedA = a->speedKmh * KMH_TO_MS;
+    q16_t speedB = b->speedKmh * KMH_TO_MS;
+    q16_t span = q16FromInt(b->timeS - a->timeS);
+    q16_t fraction = span > 0 ? q16Clamp(q16Div(lapTime - q16FromInt(a->timeS), span), 0, Q16_ONE) : 0;
+    speed = speedA + q16Mul(speedB - speedA, fraction);
+    roadGrade = a->gradeDeciPct * DECIPCT_TO_GRADE
+              + q16Mul((b->gradeDeciPct - a->gradeDeciPct) * DECIPCT_TO_GRADE, fraction);
+}
@@ -0,0 +1,79 @@
+/*
+ * AKS Vehicle Simulation - drive-cycle scenario playback
+ * A scenario is a lap profile (target speed and road grade against time,
+ * linearly interpolated) repeated for a number of laps, plus scripted
+ * events at absolute race times: fault injections, clears and motor
+ * derating. Tables are const so they stay in flash on the MCUs.
+ *
+ * The player only turns simulated time into driver targets; the caller
+ * feeds those to VehicleModel, so playback speed is set by how fast the
+ * caller steps simulated time.
+ */
+
+#ifndef DRIVE_SCENARIO_H
+#define DRIVE_SCENARIO_H
+
+#include "FixedPoint.h"
+
+// One profile breakpoint, 4 bytes
+struct ScenarioPoint {
+    uint16_t timeS;              // seconds since lap start
+    uint8_t speedKmh;            // target speed at this point
+    int8_t gradeDeciPct;         // road grade, 0.1 % (+ uphill)
+};
+
+enum ScenarioAction : uint8_t {
+    SCENARIO_SET_FAULTS = 1,     // OR value into the injected fault codes
+    SCENARIO_CLEAR_FAULTS,       // clear value from the injected fault codes
+    SCENARIO_POWER_LIMIT,        // motor derating, value in percent
+};
+
+struct ScenarioEvent {
+    uint16_t timeS;              // seconds since race start
+    ScenarioAction action;
+    uint8_t value;
+};
+
+struct DriveScenario {
+    const char *name;
+    const ScenarioPoint *lap;
+    uint8_t lapPoints;           // last point's time is the lap length
+    uint8_t laps;
+    const ScenarioEvent *events; // sorted by time
+    uint8_t eventCount;
+};
+
+// Efficiency Challenge style race: 2.1 km lap, 12 laps, scripted faults
+extern const DriveScenario SCENARIO_EFFICIENCY_RACE;
+
+class ScenarioPlayer {
+public:
+    void begin(const DriveScenario &scenario);
+    // Advances race time by dt and applies events that became due
+    void step(q16_t dt);
+
+    q16_t targetSpeed() const { return speed; }    // m/s
+    q16_t grade() const { return roadGrade; }      // rise / run
+    q16_t powerLimit() const { return limit; }     // 0..1
+    uint8_t faultCodes() const { return faults; }
+    uint8_t lap() const { return currentLap; }     // 1-based
+    bool finished() const { return done; }
+    q16_t raceTime() const { return elapsed; }     // seconds
+    const char *name() const { return s ? s->name : ""; }
+
+private:
+    void sampleProfile(q16_t lapTime);
+
+    const DriveScenario *s = 0;
+    q16_t elapsed = 0;
+    q16_t lapStart = 0;
+    uint8_t currentLap = 1;
+    uint8_t nextEvent = 0;
+    bool done = false;
+    q16_t speed = 0;
+    q16_t roadGrade = 0;
+    q16_t limit = Q16_ONE;
+    uint8_t faults = 0;
+};
+
+#endif
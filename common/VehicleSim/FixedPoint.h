@@ -0,0 +1,67 @@
+/*
+ * AKS Vehicle Simulation - Q16.16 fixed-point helpers
+ * Integer-only arithmetic so the model is cheap on the Cortex-M4 (no
+ * soft-float calls, 32x32->64 multiplies are single-cycle SMULL) and gives
+ * bit-identical results on a host build. Right shifts of negative values
+ * are arithmetic on every compiler the project uses (GCC on ARM and x86).
+ *
+ * q16_t   Q16.16, range +-32768, resolution 1.5e-5
+ * int64_t integrator states are kept in Q32.32 so that small per-step
+ * increments (rate * dt) are not lost to truncation.
+ */
+
+#ifndef FIXED_POINT_H
+#define FIXED_POINT_H
+
+#include <stdint.h>
+
+typedef int32_t q16_t;
+
+#define Q16_ONE 65536
+#define Q16(x) ((q16_t)((x) * 65536.0 + ((x) >= 0 ? 0.5 : -0.5)))   // constants only
+
+static inline q16_t q16FromInt(int32_t value) {
+    return (q16_t)(value * Q16_ONE);
+}
+
+static inline q16_t q16Mul(q16_t a, q16_t b) {
+    return (q16_t)(((int64_t)a * b) >> 16);
+}
+
+static inline q16_t q16Div(q16_t a, q16_t b) {
+    return (q16_t)(((int64_t)a * Q16_ONE) / b);
+}
+
+static inline q16_t q16Clamp(q16_t value, q16_t low, q16_t high) {
+    return value < low ? low : (value > high ? high : value);
+}
+
+// Q32.32 state <-> Q16.16 value
+static inline q16_t q16FromQ32(int64_t value) {
+    return (q16_t)(value >> 16);
+}
+
+static inline int64_t q32FromQ16(q16_t value) {
+    return (int64_t)value * Q16_ONE;
+}
+
+// rate (Q16.16 per second) * dt (Q16.16 seconds) is exactly a Q32.32 step
+static inline int64_t q32Step(q16_t rate, q16_t dt) {
+    return (int64_t)rate * dt;
+}
+
+// Length of physics step number step (counted from 0) at hz steps per
+// second. Q16_ONE / hz alone drops a fraction of a unit on every step
+// (655 for 655.36 at 100 Hz), and the simulated clock would fall behind
+// by 36 units a second. The carried remainder makes each step 655 or 656
+// units, and every hz steps add up to exactly one second.
+static inline q16_t q16StepDt(uint32_t step, uint32_t hz) {
+    uint32_t k = step % hz;
+    return (q16_t)((uint64_t)Q16_ONE * (k + 1) / hz - (uint64_t)Q16_ONE * k / hz);
+}
+
+static inline float q16ToFloat(q16_t value) {
+    return value / 65536.0f;
+}
+
+#endif
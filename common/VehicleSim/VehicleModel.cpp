@@ -0,0 +1,172 @@
+#include "VehicleModel.h"
+
+#define GRAVITY       Q16(9.80665)
+#define AIR_DENSITY_HALF Q16(0.6125)   // rho / 2 at 15 C, kg/m^3
+#define DRIVER_GAIN   Q16(0.4)         // pedal per m/s of speed error
+#define DRIVER_MAX_BRAKE Q16(0.5)      // about 4 m/s^2, no emergency stops
+
+const VehicleParams VEHICLE_DEFAULT_PARAMS = {
+    1200,            // massKg
+    Q16(0.62),       // dragArea
+    Q16(0.011),      // rollingCoeff
+    4500,            // maxTractionN
+    9000,            // maxBrakeN
+    80000,           // maxMotorPowerW
+    40000,           // maxRegenPowerW
+    Q16(0.92),       // motorEfficiency
+    400,             // auxPowerW
+    45,              // brakeNPerBar: 9 kN at 200 bar
+    500000,          // capacityAs: 139 Ah
+    50000,           // energyWh
+    {                // 96 cells, 3.00 .. 4.20 V per cell
+        Q16(288.0), Q16(331.2), Q16(340.8), Q16(347.5), Q16(353.3), Q16(359.0),
+        Q16(366.7), Q16(374.4), Q16(382.1), Q16(391.7), Q16(403.2)
+    },
+    Q16(0.06),       // r0
+    Q16(0.03),       // r1
+    3000,            // c1: 90 s polarisation time constant
+    60000,           // batteryHeatCapJ
+    Q16(0.04),       // batteryToAmbient
+    12000,           // motorHeatCapJ
+    Q16(0.015),      // motorToAmbient
+};
+
+void VehicleModel::begin(const VehicleParams &params, q16_t initialSoc, q16_t ambientC) {
+    p = &params;
+    gradeForcePerUnit = q16Mul(q16FromInt(params.massKg), GRAVITY);
+    rollingForce = q16Mul(params.rollingCoeff, gradeForcePerUnit);
+    dragFactor = q16Mul(AIR_DENSITY_HALF, params.dragArea);
+    tau1 = q16Mul(params.r1, q16FromInt(params.c1));
+
+    speedQ32 = 0;
+    v1Q32 = 0;
+    energyOutQ32 = 0;
+    batteryTempQ32 = q32FromQ16(ambientC);
+    motorTempQ32 = q32FromQ16(ambientC);
+    setSoc(initialSoc);
+
+    accel = 0;
+    brakeBar = 0;
+    motorForce = 0;
+    current = 0;
+    terminalVoltage = openCircuitVoltage(soc());
+}
+
+void VehicleModel::setSoc(q16_t value) {
+    value = q16Clamp(value, 0, Q16_ONE);
+    chargeQ32 = ((int64_t)value * p->capacityAs) * Q16_ONE;
+}
+
+q16_t VehicleModel::soc() const {
+    return (q16_t)((chargeQ32 >> 16) / p->capacityAs);
+}
+
+int32_t VehicleModel::remainingWh() const {
+    return (int32_t)(((int64_t)soc() * p->energyWh) >> 16);
+}
+
+// Linear interpolation in the OCV table
+q16_t VehicleModel::openCircuitVoltage(q16_t value) const {
+    value = q16Clamp(value, 0, Q16_ONE);
+    q16_t scaled = value * (VEHICLE_OCV_POINTS - 1);
+    int index = scaled >> 16;
+    if (index >= VEHICLE_OCV_POINTS - 1) return p->ocv[VEHICLE_OCV_POINTS - 1];
+    q16_t fraction = scaled & (Q16_ONE - 1);
+    return p->ocv[index] + q16Mul(p->ocv[index + 1] - p->ocv[index], fraction);
+}
+
+q16_t VehicleModel::pedalForSpeed(q16_t targetSpeed) const {
+    // Feed-forward for the flat-road cruise load plus a proportional term;
+    // grade and acceleration are left to the proportional part
+    q16_t pedal = q16Mul(targetSpeed - speed(), DRIVER_GAIN);
+    if (targetSpeed > 0) {
+        q16_t cruise = q16Mul(q16Mul(dragFactor, targetSpeed), targetSpeed) + rollingForce;
+        pedal += q16Div(cruise, q16FromInt(p->maxTractionN));
+    }
+    return q16Clamp(pedal, -DRIVER_MAX_BRAKE, Q16_ONE);
+}
+
+void VehicleModel::step(const VehicleInputs &in, q16_t dt) {
+    q16_t v = speed();
+    bool moving = v > 0;
+    q16_t pedal = q16Clamp(in.pedal, -Q16_ONE, Q16_ONE);
+    q16_t maxTraction = q16FromInt(p->maxTractionN);
+
+    // Motor force: torque limited at low speed, power limited above base speed
+    q16_t vForPower = v > Q16_ONE ? v : Q16_ONE;
+    q16_t mechanicalBrake = 0;
+    if (pedal >= 0) {
+        int64_t powerLimited = ((int64_t)p->maxMotorPowerW << 32) / vForPower;
+        q16_t available = powerLimited < maxTraction ? (q16_t)powerLimited : maxTraction;
+        available = q16Mul(available, q16Clamp(in.powerLimit, 0, Q16_ONE));
+        motorForce = q16Mul(pedal, available);
+    } else {
+        // Regen first, friction brakes take the rest
+        q16_t demand = q16Mul(-pedal, q16FromInt(p->maxBrakeN));
+        q16_t regenLimit = 0;
+        if (moving) {
+            int64_t powerLimited = ((int64_t)p->maxRegenPowerW << 32) / vForPower;
+            regenLimit = powerLimited < maxTraction ? (q16_t)powerLimited : maxTraction;
+        }
+        q16_t regen = demand < regenLimit ? demand : regenLimit;
+        motorForce = -regen;
+        mechanicalBrake = demand - regen;
+    }
+
+    // Road loads and the resulting acceleration
+    q16_t gradeForce = q16Mul(gradeForcePerUnit, in.grade);
+    q16_t net;
+    if (moving) {
+        q16_t drag = q16Mul(q16Mul(dragFactor, v), v);
+        net = motorForce - drag - rollingForce - gradeForce - mechanicalBrake;
+    } else {
+        // At standstill brakes and rolling resistance hold the vehicle
+        // until the drive force overcomes them; it never rolls backwards
+        q16_t drive = motorForce - gradeForce;
+        q16_t hold = mechanicalBrake + rollingForce;
+        net = drive > hold ? drive - hold : 0;
+    }
+    accel = net / p->massKg;
+    speedQ32 += q32Step(accel, dt);
+    if (speedQ32 < 0) speedQ32 = 0;
+    brakeBar = mechanicalBrake / p->brakeNPerBar;
+
+    // Electrical power drawn from the pack (Q16.16 watts)
+    int64_t wheelPower = ((int64_t)motorForce * v) >> 16;
+    int64_t electricalPower;
+    if (wheelPower >= 0) {
+        electricalPower = wheelPower * Q16_ONE / p->motorEfficiency;
+    } else {
+        electricalPower = (wheelPower * p->motorEfficiency) >> 16;
+    }
+    int64_t motorLoss = electricalPower - wheelPower;
+    if (motorLoss < 0) motorLoss = -motorLoss;
+    electricalPower += (int64_t)p->auxPowerW << 16;
+    if (!moving && in.chargerPowerW > 0) {
+        electricalPower -= (int64_t)in.chargerPowerW << 16;
+    }
+
+    // Battery: current from the last terminal voltage, then the circuit
+    current = (q16_t)(electricalPower * Q16_ONE / terminalVoltage);
+    q16_t v1 = q16FromQ32(v1Q32);
+    v1Q32 += q32Step(current / p->c1 - q16Div(v1, tau1), dt);
+    v1 = q16FromQ32(v1Q32);
+    terminalVoltage = openCircuitVoltage(soc()) - q16Mul(current, p->r0) - v1;
+
+    chargeQ32 -= q32Step(current, dt);
+    int64_t fullQ32 = (int64_t)p->capacityAs << 32;
+    if (chargeQ32 < 0) chargeQ32 = 0;
+    if (chargeQ32 > fullQ32) chargeQ32 = fullQ32;
+    energyOutQ32 += electricalPower * dt;
+
+    // Thermal RC networks to ambient
+    q16_t packHeat = (q16_t)(((((int64_t)current * current) >> 16) * p->r0) >> 16)
+                   + q16Div(q16Mul(v1, v1), p->r1);
+    q16_t batteryT = batteryTemp();
+    q16_t batteryFlow = packHeat - q16Div(batteryT - in.ambientC, p->batteryToAmbient);
+    batteryTempQ32 += q32Step(batteryFlow / p->batteryHeatCapJ, dt);
+
+    q16_t motorT = motorTemp();
+    q16_t motorFlow = (q16_t)motorLoss - q16Div(motorT - in.ambientC, p->motorToAmbient);
+    motorTempQ32 += q32Step(motorFlow / p->motorHeatCapJ, dt);
+}
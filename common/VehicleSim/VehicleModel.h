@@ -0,0 +1,107 @@
+/*
+ * AKS Vehicle Simulation - coupled longitudinal, battery and thermal model
+ *
+ * Longitudinal: traction or regen from the motor, mechanical brake,
+ *   aerodynamic drag, rolling resistance and road grade (small-angle
+ *   approximation, sin = grade, cos = 1).
+ * Battery: Thevenin equivalent circuit, OCV(SOC) table + R0 + one R1||C1
+ *   pair, so the pack voltage sags under load and recovers afterwards.
+ * Thermal: first-order RC networks to ambient for pack and motor, heated
+ *   by I^2R losses and motor losses respectively.
+ *
+ * Everything is Q16.16 fixed point (see FixedPoint.h); forces must stay
+ * below 32768 N, which holds for vehicles up to about 3 t.
+ */
+
+#ifndef VEHICLE_MODEL_H
+#define VEHICLE_MODEL_H
+
+#include "FixedPoint.h"
+
+#define VEHICLE_OCV_POINTS 11    // OCV table at SOC 0 %, 10 %, ... 100 %
+
+struct VehicleParams {
+    // Longitudinal
+    int32_t massKg;              // vehicle with driver
+    q16_t dragArea;              // Cd * A, m^2
+    q16_t rollingCoeff;          // Crr
+    int32_t maxTractionN;
+    int32_t maxBrakeN;           // motor regen + mechanical at full pedal
+    int32_t maxMotorPowerW;
+    int32_t maxRegenPowerW;
+    q16_t motorEfficiency;       // same in drive and regen
+    int32_t auxPowerW;           // constant electrical load
+    int32_t brakeNPerBar;        // mechanical brake force per bar line pressure
+    // Battery
+    int32_t capacityAs;          // ampere-seconds
+    int32_t energyWh;            // usable energy at 100 % SOC
+    q16_t ocv[VEHICLE_OCV_POINTS];
+    q16_t r0;                    // ohm
+    q16_t r1;                    // ohm
+    int32_t c1;                  // farad
+    // Thermal
+    int32_t batteryHeatCapJ;     // J/K
+    q16_t batteryToAmbient;      // K/W
+    int32_t motorHeatCapJ;
+    q16_t motorToAmbient;
+};
+
+// Same scale as the original generator: 96s Li-ion pack, 50 kWh
+extern const VehicleParams VEHICLE_DEFAULT_PARAMS;
+
+struct VehicleInputs {
+    q16_t pedal;                 // -1 full brake .. +1 full throttle
+    q16_t grade;                 // rise / run, + uphill
+    q16_t powerLimit;            // 0..1 motor derating (faults)
+    int32_t chargerPowerW;       // applied only while stopped
+    q16_t ambientC;
+};
+
+class VehicleModel {
+public:
+    void begin(const VehicleParams &params, q16_t initialSoc, q16_t ambientC);
+    void step(const VehicleInputs &in, q16_t dt);
+
+    // Proportional driver that tracks a target speed (m/s)
+    q16_t pedalForSpeed(q16_t targetSpeed) const;
+    void setSoc(q16_t soc);
+
+    q16_t speed() const { return q16FromQ32(speedQ32); }          // m/s
+    q16_t acceleration() const { return accel; }                   // m/s^2
+    q16_t brakePressureBar() const { return brakeBar; }
+    q16_t motorForceN() const { return motorForce; }                // < 0 regen
+    q16_t batteryVoltage() const { return terminalVoltage; }
+    q16_t batteryCurrent() const { return current; }                // > 0 discharge
+    q16_t soc() const;                                               // 0..1
+    int32_t remainingWh() const;
+    int32_t energyUsedWh() const { return (int32_t)((energyOutQ32 >> 32) / 3600); }
+    q16_t batteryTemp() const { return q16FromQ32(batteryTempQ32); }
+    q16_t motorTemp() const { return q16FromQ32(motorTempQ32); }
+    bool regenActive() const { return motorForce < 0; }
+    bool charging() const { return current < 0 && speedQ32 == 0; }
+
+private:
+    q16_t openCircuitVoltage(q16_t soc) const;
+
+    const VehicleParams *p = 0;
+    q16_t rollingForce = 0;      // Crr * m * g
+    q16_t gradeForcePerUnit = 0; // m * g
+    q16_t dragFactor = 0;        // rho / 2 * Cd * A
+    q16_t tau1 = 0;              // R1 * C1, seconds
+
+    // Q32.32 integrator states
+    int64_t speedQ32 = 0;
+    int64_t chargeQ32 = 0;       // ampere-seconds left
+    int64_t v1Q32 = 0;           // R1||C1 polarisation voltage
+    int64_t batteryTempQ32 = 0;
+    int64_t motorTempQ32 = 0;
+    int64_t energyOutQ32 = 0;    // joules drawn from the pack
+
+    q16_t accel = 0;
+    q16_t brakeBar = 0;
+    q16_t motorForce = 0;
+    q16_t current = 0;
+    q16_t terminalVoltage = 0;
+};
+
+#endif
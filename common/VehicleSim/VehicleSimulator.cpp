@@ -0,0 +1,115 @@
+#include "VehicleSimulator.h"
+
+void VehicleSimulator::begin(uint32_t seed, uint8_t mode, bool cycleModes) {
+    rng.reseed(seed);
+    noise.reseed(seed ^ 0xA5A5A5A5u);
+    cycle = cycleModes;
+    modeTime = 0;
+    targetAge = q16FromInt(SIM_TARGET_PERIOD_S);   // draw a target on the first step
+    cruiseTarget = 0;
+    model.begin(VEHICLE_DEFAULT_PARAMS, SIM_INITIAL_SOC, SIM_AMBIENT_C);
+    setMode(mode);
+}
+
+bool VehicleSimulator::setMode(uint8_t mode) {
+    if (mode < AKS_MODE_NORMAL || mode > AKS_MODE_SCENARIO) return false;
+    simulationMode = mode;
+    if (mode == AKS_MODE_SCENARIO) {
+        player.begin(SCENARIO_EFFICIENCY_RACE);
+        model.begin(VEHICLE_DEFAULT_PARAMS, SIM_INITIAL_SOC, SIM_AMBIENT_C);
+    }
+    return true;
+}
+
+void VehicleSimulator::resetEnergy() {
+    model.setSoc(Q16_ONE);
+}
+
+uint8_t VehicleSimulator::step(q16_t dt) {
+    uint8_t events = 0;
+
+    targetAge += dt;
+    if (targetAge >= q16FromInt(SIM_TARGET_PERIOD_S)) {
+        targetAge = 0;
+        cruiseTarget = q16FromInt(rng.range(0, 34)); // 0 to 33 m/s (120 km/h)
+    }
+
+    VehicleInputs inputs;
+    inputs.grade = 0;
+    inputs.powerLimit = Q16_ONE;
+    inputs.chargerPowerW = 0;
+    inputs.ambientC = SIM_AMBIENT_C;
+    q16_t target = cruiseTarget;
+
+    switch (simulationMode) {
+        case AKS_MODE_NORMAL:
+            break;
+        case AKS_MODE_FAULT: // motor derated to half power
+            inputs.powerLimit = Q16(0.5);
+            break;
+        case AKS_MODE_CHARGING: // stop and plug in
+            target = 0;
+            inputs.chargerPowerW = SIM_CHARGER_POWER_W;
+            break;
+        case AKS_MODE_SCENARIO:
+            player.step(dt);
+            target = player.targetSpeed();
+            inputs.grade = player.grade();
+            inputs.powerLimit = player.powerLimit();
+            break;
+    }
+
+    inputs.pedal = model.pedalForSpeed(target);
+    model.step(inputs, dt);
+
+    if (simulationMode == AKS_MODE_SCENARIO) {
+        // Race over and stopped: recharge and start the next one
+        if (player.finished() && model.speed() == 0) {
+            setMode(AKS_MODE_SCENARIO);
+            events |= SIM_EVENT_SCENARIO_RESTART;
+        }
+    } else if (cycle) {
+        modeTime += dt;
+        if (modeTime > q16FromInt(SIM_MODE_PERIOD_S)) {
+            simulationMode = simulationMode >= AKS_MODE_CHARGING ? AKS_MODE_NORMAL : simulationMode + 1;
+            modeTime = 0;
+            events |= SIM_EVENT_MODE_CHANGED;
+        }
+    }
+    return events;
+}
+
+void VehicleSimulator::sample(AKS_TelemetryData &out, uint32_t timestampMs) {
+    out.timestamp_ms = timestampMs;
+
+    // All signals come from one coupled model state, plus sensor noise
+    out.vehicle_speed_kmh = q16ToFloat(model.speed()) * 3.6f;
+    out.battery_temp_C = q16ToFloat(model.batteryTemp()) + noise.gaussian(0.05f);
+    out.battery_voltage_V = q16ToFloat(model.batteryVoltage()) + noise.gaussian(0.2f);
+    out.remaining_energy_Wh = model.remainingWh();
+    out.motor_temp_C = q16ToFloat(model.motorTemp()) + noise.gaussian(0.1f);
+    out.brake_pressure_bar = q16ToFloat(model.brakePressureBar());
+    if (out.brake_pressure_bar > 0.0f) {
+        out.brake_pressure_bar += noise.gaussian(0.5f);
+        if (out.brake_pressure_bar < 0.0f) out.brake_pressure_bar = 0.0f;
+    }
+
+    out.system_status = AKS_STATUS_MOTOR_READY | AKS_STATUS_BATTERY_OK | AKS_STATUS_BRAKE_OK;
+    if (model.charging()) out.system_status |= AKS_STATUS_CHARGING;
+    if (model.regenActive()) out.system_status |= AKS_STATUS_REGEN_ACTIVE;
+
+    out.fault_codes = 0;
+    if (simulationMode == AKS_MODE_FAULT || out.motor_temp_C > SIM_MOTOR_OVERTEMP_C) {
+        out.fault_codes |= AKS_FAULT_MOTOR_OVERTEMP;
+    }
+    if (out.battery_temp_C > SIM_BATTERY_OVERTEMP_C) {
+        out.fault_codes |= AKS_FAULT_BATTERY_OVERTEMP;
+    }
+    if (simulationMode == AKS_MODE_SCENARIO) {
+        out.fault_codes |= player.faultCodes();
+    }
+
+    if (out.fault_codes & AKS_FAULT_MOTOR_OVERTEMP) out.system_status &= ~AKS_STATUS_MOTOR_READY;
+    if (out.fault_codes & AKS_FAULT_BATTERY_OVERTEMP) out.system_status &= ~AKS_STATUS_BATTERY_OK;
+    if (out.fault_codes & AKS_FAULT_BRAKE) out.system_status &= ~AKS_STATUS_BRAKE_OK;
+}
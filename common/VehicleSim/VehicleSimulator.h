@@ -0,0 +1,58 @@
+/*
+ * AKS Vehicle Simulation - one simulated vehicle
+ * Bundles the vehicle model, a speed-tracking driver, scenario playback
+ * and the generator's simulation modes, and samples the result into
+ * AKS_TelemetryData with sensor noise, status bits and fault codes. The
+ * data generator runs one of these; tools/dataset_gen runs thousands, so
+ * both produce the same data for the same seed.
+ */
+
+#ifndef VEHICLE_SIMULATOR_H
+#define VEHICLE_SIMULATOR_H
+
+#include <AksRegisters.h>
+#include <SimRandom.h>
+#include "VehicleModel.h"
+#include "DriveScenario.h"
+
+#define SIM_AMBIENT_C          Q16(25.0)
+#define SIM_INITIAL_SOC        Q16(0.9)
+#define SIM_CHARGER_POWER_W    11000
+#define SIM_MOTOR_OVERTEMP_C   110.0f
+#define SIM_BATTERY_OVERTEMP_C 60.0f
+#define SIM_MODE_PERIOD_S      30      // modes 1-3 rotate this often
+#define SIM_TARGET_PERIOD_S    10      // new cruise target this often
+
+// step() result flags
+#define SIM_EVENT_MODE_CHANGED     0x01
+#define SIM_EVENT_SCENARIO_RESTART 0x02
+
+class VehicleSimulator {
+public:
+    void begin(uint32_t seed, uint8_t mode, bool cycleModes = true);
+    // AKS_MODE_*; entering scenario mode starts the race from the grid
+    bool setMode(uint8_t mode);
+    void resetEnergy();
+
+    // One fixed physics step of dt seconds, returns SIM_EVENT_* flags
+    uint8_t step(q16_t dt);
+    void sample(AKS_TelemetryData &out, uint32_t timestampMs);
+
+    uint8_t mode() const { return simulationMode; }
+    uint32_t seed() const { return rng.seed(); }
+    const VehicleModel &vehicle() const { return model; }
+    const ScenarioPlayer &scenario() const { return player; }
+
+private:
+    VehicleModel model;
+    ScenarioPlayer player;
+    SimRandom rng;                // driver and mode decisions
+    SimRandom noise;              // sensor noise, so sampling never alters the drive
+    uint8_t simulationMode = AKS_MODE_NORMAL;
+    bool cycle = true;
+    q16_t modeTime = 0;
+    q16_t targetAge = 0;
+    q16_t cruiseTarget = 0;
+};
+
+#endif
@@ -0,0 +1,25 @@
+#include "FrameGate.h"
+
+void FrameGate::begin(LinkOpener* opener, FecDeliverFn deliver, uint32_t (*cycles)()) {
+  linkOpener = opener;
+  deliverFn = deliver;
+  cycleCounter = cycles;
+}
+
+FrameGate::Result FrameGate::pass(const uint8_t* frame, size_t length, bool recovered) {
+  if (length == 0 || frame[0] != LINK_FRAME_SECURE) {
+    unsealedFrames++;
+    return UNSEALED;
+  }
+
+  uint8_t plain[LINK_SECURE_MAX_PAYLOAD];
+  uint32_t start = cycleCounter ? cycleCounter() : 0;
+  size_t plainLength = linkOpener->open(frame, length, plain);
+  if (cycleCounter) openCycles += cycleCounter() - start;
+  if (plainLength == 0) {
+    rejectedFrames++;
+    return REJECTED;
+  }
+  deliverFn(plain, plainLength, recovered);
+  return DELIVERED;
+}
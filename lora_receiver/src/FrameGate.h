@@ -0,0 +1,38 @@
+/*********
+  STM32F411RE LoRa Pitstop Receiver - Link security gate
+  First stop for every telemetry frame off the radio or out of the FEC
+  decoder. A sealed frame is authenticated and decrypted, and its plain
+  payload goes on to the handler; anything else is refused, since anyone
+  on the channel can send it. The gate only looks at raw frames: what it
+  delivers is never fed through it again.
+*********/
+
+#ifndef FRAME_GATE_H
+#define FRAME_GATE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <LinkCrypto.h>
+#include <TelemetryFec.h>
+
+class FrameGate {
+public:
+  enum Result { DELIVERED, REJECTED, UNSEALED };
+
+  // cycles, if given, times open() (DWT->CYCCNT on the STM32)
+  void begin(LinkOpener* opener, FecDeliverFn deliver, uint32_t (*cycles)() = nullptr);
+
+  // Opens one sealed frame and hands the payload to deliver()
+  Result pass(const uint8_t* frame, size_t length, bool recovered);
+
+  uint32_t rejectedFrames = 0;       // bad tag or replayed sequence
+  uint32_t unsealedFrames = 0;       // plain frames, not trusted
+  unsigned long openCycles = 0;
+
+private:
+  LinkOpener* linkOpener = nullptr;
+  FecDeliverFn deliverFn = nullptr;
+  uint32_t (*cycleCounter)() = nullptr;
+};
+
+#endif
@@ -0,0 +1,47 @@
+#include "SampleHistory.h"
+#include <string.h>
+
+SampleHistory::InsertResult SampleHistory::insert(const TelemetrySample& sample, bool partial) {
+  // First sample newer than the new one; live samples land at the end
+  size_t low = 0;
+  size_t high = count;
+  while (low < high) {
+    size_t mid = (low + high) / 2;
+    if (samples[mid].timestampMs <= sample.timestampMs) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  if (low > 0 && samples[low - 1].timestampMs == sample.timestampMs) {
+    if (!partialFlags[low - 1] || partial) return DUPLICATE;
+    samples[low - 1] = sample;
+    partialFlags[low - 1] = false;
+    return REPLACED;
+  }
+
+  if (count == HISTORY_SAMPLES) {
+    if (low == 0) return TOO_OLD;
+    memmove(&samples[0], &samples[1], (low - 1) * sizeof(TelemetrySample));
+    memmove(&partialFlags[0], &partialFlags[1], (low - 1) * sizeof(bool));
+    samples[low - 1] = sample;
+    partialFlags[low - 1] = partial;
+    return INSERTED;
+  }
+
+  memmove(&samples[low + 1], &samples[low], (count - low) * sizeof(TelemetrySample));
+  memmove(&partialFlags[low + 1], &partialFlags[low], (count - low) * sizeof(bool));
+  samples[low] = sample;
+  partialFlags[low] = partial;
+  count++;
+  return INSERTED;
+}
+
+uint32_t SampleHistory::largestGapMs() const {
+  uint32_t largest = 0;
+  for (size_t i = 1; i < count; i++) {
+    uint32_t gap = samples[i].timestampMs - samples[i - 1].timestampMs;
+    if (gap > largest) largest = gap;
+  }
+  return largest;
+}
@@ -0,0 +1,41 @@
+/*********
+  STM32F411RE LoRa Pitstop Receiver - Vehicle sample history
+  Live and backfilled telemetry samples kept in vehicle timestamp order.
+  Backfill arrives late and may overlap samples that did get through
+  live, so inserts go to their sorted position and exact timestamp
+  duplicates are ignored. A reduced live frame is kept as a partial
+  sample until the full one turns up in a backfill and replaces it.
+  When full, the oldest samples are dropped.
+*********/
+
+#ifndef SAMPLE_HISTORY_H
+#define SAMPLE_HISTORY_H
+
+#include <Arduino.h>
+#include <SampleCodec.h>
+
+#define HISTORY_SAMPLES 256
+
+class SampleHistory {
+public:
+  enum InsertResult { INSERTED, REPLACED, DUPLICATE, TOO_OLD };
+
+  // partial: fields the frame left out are zero
+  InsertResult insert(const TelemetrySample& sample, bool partial = false);
+
+  size_t size() const { return count; }
+  const TelemetrySample& at(size_t i) const { return samples[i]; }  // 0 = oldest
+  bool isPartial(size_t i) const { return partialFlags[i]; }
+  uint32_t oldestMs() const { return count ? samples[0].timestampMs : 0; }
+  uint32_t newestMs() const { return count ? samples[count - 1].timestampMs : 0; }
+
+  // Longest time between neighbouring samples, i.e. the worst remaining hole
+  uint32_t largestGapMs() const;
+
+private:
+  TelemetrySample samples[HISTORY_SAMPLES];
+  bool partialFlags[HISTORY_SAMPLES];
+  size_t count = 0;
+};
+
+#endif
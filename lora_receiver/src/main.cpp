@@ -9,6 +9,13 @@
 #include <SPI.h>
 #include <LoRa.h>
 #include <ArduinoJson.h>
+#include <LoRaAirtime.h>
+#include <LoRaRegion.h>
+#include <TelemetryFec.h>
+#include <SampleCodec.h>
+#include <LinkCrypto.h>
+#include "SampleHistory.h"
+#include "FrameGate.h"
 
 // Define pins used by the LoRa transceiver module for STM32F411RE
 #define SS    PA4   // NSS pin
@@ -20,6 +27,24 @@
 // MISO = PA6
 // MOSI = PA7
 
+// LoRa radio settings (must match the vehicle transmitter)
+#define LORA_SPREADING_FACTOR 7
+#define LORA_BANDWIDTH        125000
+#define LORA_CODING_RATE      5     // 4/5
+
+// Only frames sealed with the link key are accepted (must match the vehicle)
+#ifndef LINK_SECURE
+#define LINK_SECURE 1
+#endif
+
+// Beacon sent back to the vehicle after a frame that opened and parsed,
+// at most this often, so its store-and-forward logic knows the link is up
+#define BEACON_INTERVAL_MS 10000
+
+const LoRaRadioConfig radioConfig = {
+  LORA_SPREADING_FACTOR, LORA_BANDWIDTH, LORA_CODING_RATE, 8, false, false
+};
+
 // Telemetry monitoring variables
 unsigned long lastPacketTime = 0;
 unsigned long systemStartTime = 0;
@@ -38,6 +63,45 @@ float snrSum = 0;
 unsigned long totalBytes = 0;
 float dataRate = 0; // bytes per second
 
+// Packet-level FEC (frames starting with LINK_FRAME_FEC)
+FecDecoder fecDecoder;
+uint8_t packetBuffer[256];
+int recoveredPackets = 0;
+unsigned long dataAirtimeUs = 0;    // received telemetry frames
+unsigned long parityAirtimeUs = 0;  // received FEC parity frames
+int lossBursts[4] = {0, 0, 0, 0};   // loss bursts of 1, 2, 3 and 4+ packets
+int longestLossBurst = 0;
+int reorderedPackets = 0;           // frames overtaken by vehicle fault events
+int duplicatePackets = 0;           // IDs already received
+int senderRestarts = 0;             // IDs that jumped back past the loss window
+// Loss window: bit n set means ID lastPacketID - n was counted as lost and
+// has not arrived yet, so a late frame is only credited back once
+#define LOSS_WINDOW 32
+uint32_t missingIDs = 0;
+int faultEvents = 0;
+int lastRssi = 0;
+float lastSnr = 0;
+
+// Link security: frames are opened with the shared key, timed in CPU cycles.
+// Beacons go back sealed with the downlink keys.
+#if LINK_SECURE
+const uint8_t linkKey[LINK_KEY_SIZE] = { LINK_KEY_BYTES };
+LinkOpener linkOpener;
+LinkSealer beaconSealer;
+FrameGate frameGate;
+
+uint32_t cycleCount() {
+  return DWT->CYCCNT;
+}
+#endif
+
+// Store-and-forward: beacons to the vehicle and the merged sample history
+SampleHistory history;
+unsigned long lastBeaconSent = 0;
+int beaconsSent = 0;
+unsigned long backfilledSamples = 0;
+unsigned long duplicateSamples = 0;
+
 // Performance metrics
 struct TelemetryStats {
   float successRate;
@@ -70,6 +134,15 @@ void printStatistics();
 void printSystemStatus();
 void updateStatistics(int rssi, float snr, int packetSize);
 void checkConnectionTimeout();
+void handleTelemetryPayload(const uint8_t* payload, size_t length, bool recovered);
+void processPlainPayload(const uint8_t* payload, size_t length, bool recovered);
+void printFecStatistics();
+void printFaultEvent(JsonDocument& doc);
+void sendBeacon();
+void answerVehicle();
+void handleBackfill(const uint8_t* frame, size_t length);
+void recordLiveSample(JsonDocument& doc);
+void printSecurityStatistics();
 
 void setup() {
   // Initialize Serial Monitor
@@ -85,15 +158,37 @@ void setup() {
   
   Serial.println("[INIT] Initializing LoRa module...");
   
-  // 868MHz for Europe (as per EC requirements)
-  while (!LoRa.begin(433E6)) {
+  // Band comes from the build-time region (EU868 as per EC requirements)
+  while (!LoRa.begin(LORA_FREQUENCY)) {
     Serial.println("[ERROR] LoRa init failed, retrying in 500ms...");
     delay(500);
   }
   
   // EC telemetry sync word (must match vehicle)
   LoRa.setSyncWord(0xEC); // 'E'fficiency 'C'hallenge
-  LoRa.setSpreadingFactor(7); // Must match transmitter
+  LoRa.setSpreadingFactor(LORA_SPREADING_FACTOR); // Must match transmitter
+  LoRa.setSignalBandwidth(LORA_BANDWIDTH);
+  LoRa.setCodingRate4(LORA_CODING_RATE);
+  LoRa.setTxPower(LORA_MAX_TX_POWER); // beacons only, keep inside regional limit
+
+  fecDecoder.begin(handleTelemetryPayload);
+
+#if LINK_SECURE
+  // DWT cycle counter for timing frame authentication
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT = 0;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+  linkOpener.begin(linkKey);
+  beaconSealer.begin(linkKey, 0, LINK_DOWNLINK);
+  frameGate.begin(&linkOpener, processPlainPayload, cycleCount);
+  Serial.print("[INIT] Link security: AES-128-CTR + ");
+  Serial.print(LINK_TAG_SIZE * 8);
+  Serial.println("-bit CMAC, replay window 32");
+#ifdef LINK_KEY_IS_DEFAULT
+  Serial.println("[WARNING] ⚠️  Default link key in use, set LINK_KEY_BYTES");
+#endif
+#endif
   
   Serial.println("[SUCCESS] LoRa Pitstop Receiver Ready!");
   Serial.println("[INFO] Waiting for vehicle telemetry data...");
@@ -109,64 +204,42 @@ void loop() {
   int packetSize = LoRa.parsePacket();
   if (packetSize) {
     // Read the complete packet
-    String receivedData = "";
+    size_t length = 0;
     while (LoRa.available()) {
-      receivedData += (char)LoRa.read();
+      uint8_t b = LoRa.read();
+      if (length < sizeof(packetBuffer)) packetBuffer[length++] = b;
     }
     
-    int rssi = LoRa.packetRssi();
-    float snr = LoRa.packetSnr();
+    lastRssi = LoRa.packetRssi();
+    lastSnr = LoRa.packetSnr();
     totalPacketsReceived++;
     totalBytes += packetSize;
     lastPacketTime = millis();
     
-    printPacketHeader(packetSize, rssi, snr);
+    printPacketHeader(packetSize, lastRssi, lastSnr);
     
-    // Parse JSON telemetry data
-    StaticJsonDocument<512> doc;
-    DeserializationError error = deserializeJson(doc, receivedData);
-    
-    if (error) {
-      corruptedPackets++;
-      Serial.println("[ERROR] ❌ JSON Parse Failed!");
-      Serial.print("[DEBUG] Error: ");
-      Serial.println(error.c_str());
-      Serial.print("[DEBUG] Raw data (");
-      Serial.print(receivedData.length());
-      Serial.print(" chars): ");
-      Serial.println(receivedData);
-      Serial.println("[INFO] Attempting partial data recovery...");
-    } else {
-      // Successfully parsed JSON
-      int packetID = doc["id"];
-      String vehicleID = doc["vehicle_id"];
-      unsigned long timestamp = doc["timestamp"];
-      
-      // Update vehicle status
-      vehicle.vehicleID = vehicleID;
-      vehicle.isConnected = true;
-      vehicle.lastSeen = millis();
-      
-      // Check for lost packets
-      if (lastPacketID != -1 && packetID != lastPacketID + 1) {
-        int lost = packetID - lastPacketID - 1;
-        lostPackets += lost;
-        Serial.print("[WARNING] ⚠️  Packet Loss Detected! Missing ");
-        Serial.print(lost);
-        Serial.print(" packet(s). Expected ID: ");
-        Serial.print(lastPacketID + 1);
-        Serial.print(", Received ID: ");
-        Serial.println(packetID);
+    if (length > 0 && packetBuffer[0] == LINK_FRAME_FEC) {
+      bool isParity = length > 1 && (packetBuffer[1] & FEC_FLAG_PARITY);
+      if (isParity) {
+        parityAirtimeUs += loraTimeOnAirUs(radioConfig, length);
+        Serial.print("├─ [FEC] Parity frame for group ");
+        Serial.println(packetBuffer[2]);
+      } else {
+        dataAirtimeUs += loraTimeOnAirUs(radioConfig, length);
+      }
+      if (!fecDecoder.push(packetBuffer, length)) {
+        corruptedPackets++;
+        Serial.println("[ERROR] ❌ Malformed FEC frame!");
       }
-      lastPacketID = packetID;
-      
-      printTelemetryData(doc);
-      printSignalAnalysis(rssi, snr);
-      printAlerts(doc);
+    } else {
+      dataAirtimeUs += loraTimeOnAirUs(radioConfig, length);
+      handleTelemetryPayload(packetBuffer, length, false);
     }
     
-    updateStatistics(rssi, snr, packetSize);
+    updateStatistics(lastRssi, lastSnr, packetSize);
     printStatistics();
+    printFecStatistics();
+    printSecurityStatistics();
     Serial.println("──────────────────────────────────────────────────────────");
     
   } else {
@@ -184,15 +257,134 @@ void loop() {
   delay(100); // Small delay for stability
 }
 
+// Takes one raw telemetry frame: a plain packet, an FEC data frame or a
+// frame the FEC decoder rebuilt from parity. With LINK_SECURE it has to be
+// sealed, and only its opened payload is processed.
+void handleTelemetryPayload(const uint8_t* payload, size_t length, bool recovered) {
+#if LINK_SECURE
+  switch (frameGate.pass(payload, length, recovered)) {
+    case FrameGate::REJECTED:
+      corruptedPackets++;
+      Serial.println("[SECURITY] 🔒 Frame rejected: bad tag or replayed sequence");
+      break;
+    case FrameGate::UNSEALED:
+      // Anyone on the channel can send plain frames, so they are not trusted
+      Serial.println("[SECURITY] 🔒 Unauthenticated frame ignored");
+      break;
+    case FrameGate::DELIVERED:
+      break;
+  }
+#else
+  processPlainPayload(payload, length, recovered);
+#endif
+}
+
+// Parses and reports one plain payload: backfill or JSON telemetry
+void processPlainPayload(const uint8_t* payload, size_t length, bool recovered) {
+  if (length > 0 && payload[0] == LINK_FRAME_BACKFILL) {
+    handleBackfill(payload, length);
+    return;
+  }
+
+  // Parse JSON telemetry data
+  StaticJsonDocument<512> doc;
+  DeserializationError error = deserializeJson(doc, (const char*)payload, length);
+  
+  if (error) {
+    corruptedPackets++;
+    Serial.println("[ERROR] ❌ JSON Parse Failed!");
+    Serial.print("[DEBUG] Error: ");
+    Serial.println(error.c_str());
+    Serial.print("[DEBUG] Raw data (");
+    Serial.print(length);
+    Serial.print(" chars): ");
+    Serial.write(payload, length);
+    Serial.println();
+    Serial.println("[INFO] Attempting partial data recovery...");
+    return;
+  }
+
+  // Successfully parsed JSON
+  answerVehicle();
+  int packetID = doc["id"];
+  String vehicleID = doc["vehicle_id"];
+  
+  // Update vehicle status
+  vehicle.vehicleID = vehicleID;
+  vehicle.isConnected = true;
+  vehicle.lastSeen = millis();
+  
+  int behind = lastPacketID - packetID;
+  if (lastPacketID != -1 && behind >= LOSS_WINDOW) {
+    // Far older than anything still tracked: the vehicle rebooted and
+    // counts from 0 again
+    senderRestarts++;
+    lastPacketID = packetID;
+    missingIDs = 0;
+    Serial.print("[INFO] Sender restarted, packet IDs resume at ");
+    Serial.println(packetID);
+  } else if (lastPacketID == -1 || packetID > lastPacketID) {
+    // Check for lost packets
+    if (lastPacketID != -1 && packetID != lastPacketID + 1) {
+      int lost = packetID - lastPacketID - 1;
+      lostPackets += lost;
+      lossBursts[min(lost, 4) - 1]++;
+      if (lost > longestLossBurst) longestLossBurst = lost;
+      Serial.print("[WARNING] ⚠️  Packet Loss Detected! Missing ");
+      Serial.print(lost);
+      Serial.print(" packet(s). Expected ID: ");
+      Serial.print(lastPacketID + 1);
+      Serial.print(", Received ID: ");
+      Serial.println(packetID);
+    }
+    if (lastPacketID != -1) {
+      // Shift the window to the new ID and mark the skipped ones
+      int step = packetID - lastPacketID;
+      missingIDs = step < LOSS_WINDOW ? missingIDs << step : 0;
+      for (int n = 1; n < step && n < LOSS_WINDOW; n++) missingIDs |= 1UL << n;
+    }
+    lastPacketID = packetID;
+  } else if (missingIDs & (1UL << behind)) {
+    // Late frame fills a gap counted as lost above: either rebuilt from
+    // parity or overtaken on the vehicle by a higher-priority frame
+    missingIDs &= ~(1UL << behind);
+    lostPackets--;
+    if (!recovered) reorderedPackets++;
+  } else {
+    duplicatePackets++;
+  }
+
+  if (recovered) {
+    recoveredPackets++;
+    Serial.print("├─ [FEC] ♻️  Packet ID ");
+    Serial.print(packetID);
+    Serial.println(" recovered from parity");
+  }
+
+  if (doc.containsKey("event")) {
+    printFaultEvent(doc);
+    return;
+  }
+  
+  recordLiveSample(doc);
+  printTelemetryData(doc);
+  printSignalAnalysis(lastRssi, lastSnr);
+  printAlerts(doc);
+}
+
 void printSystemHeader() {
   Serial.println();
   Serial.println("╔══════════════════════════════════════════════════════════╗");
   Serial.println("║        EC TELEMETRY SYSTEM - PITSTOP RECEIVER           ║");
   Serial.println("║              STM32F411RE Advanced Monitor                ║");
   Serial.println("╠══════════════════════════════════════════════════════════╣");
-  Serial.print("║ Frequency: 868MHz | Sync: 0xEC | Board: ");
+  Serial.print("║ Region: ");
+  Serial.print(LORA_REGION_NAME);
+  Serial.print(" ");
+  Serial.print(LORA_FREQUENCY / 1000000.0, 3);
+  Serial.print("MHz | Sync: 0xEC | Board: ");
   Serial.print("STM32F411RE");
-  Serial.println("        ║");
+  Serial.println("  ║");
   Serial.print("║ Started: ");
   Serial.print(millis());
   Serial.println("ms                                     ║");
@@ -255,6 +447,15 @@ void printTelemetryData(JsonDocument& doc) {
   Serial.print(packetID);
   Serial.print(" │ Timestamp: ");
   Serial.println(timestamp);
+
+  // Vehicle-side airtime budget; reduced frames carry only alert fields
+  Serial.print("├─ Airtime budget: ");
+  Serial.print((int)doc["airtime"]);
+  Serial.print("%");
+  if (doc["reduced"]) {
+    Serial.print(" │ ⏬ Reduced frame (vehicle airtime budget low)");
+  }
+  Serial.println();
   
   Serial.println("├─ BATTERY MANAGEMENT SYSTEM ─────────────────────────────");
   Serial.print("├─   Voltage: ");
@@ -286,6 +487,116 @@ void printTelemetryData(JsonDocument& doc) {
   Serial.println(" Wh/km");
 }
 
+// Link beacon: [LINK_FRAME_BEACON][last packet ID, little endian]. With
+// LINK_SECURE it is sealed under the sequence of the frame just opened, so
+// the vehicle can tell it answers something it sent since booting.
+void sendBeacon() {
+  uint16_t lastID = lastPacketID < 0 ? 0 : (uint16_t)lastPacketID;
+  uint8_t beacon[3] = { LINK_FRAME_BEACON, (uint8_t)(lastID & 0xFF), (uint8_t)(lastID >> 8) };
+  LoRa.beginPacket();
+#if LINK_SECURE
+  uint8_t sealed[sizeof(beacon) + LINK_SECURE_OVERHEAD];
+  beaconSealer.setSequence(linkOpener.lastSequence());
+  LoRa.write(sealed, beaconSealer.seal(beacon, sizeof(beacon), sealed));
+#else
+  LoRa.write(beacon, sizeof(beacon));
+#endif
+  LoRa.endPacket();
+  lastBeaconSent = millis();
+  beaconsSent++;
+}
+
+// Beacon for a frame that got through intact. Noise, corrupted frames and
+// anything failing the link security never count as the link being up.
+// Sent before the frame is printed, since the vehicle may go back to
+// transmitting at any time.
+void answerVehicle() {
+  if (lastBeaconSent == 0 || millis() - lastBeaconSent >= BEACON_INTERVAL_MS) {
+    sendBeacon();
+  }
+}
+
+// Samples the vehicle buffered during a link outage, merged into the
+// history by vehicle timestamp
+void handleBackfill(const uint8_t* frame, size_t length) {
+  TelemetrySample samples[SAMPLE_BATCH_MAX];
+  size_t count = decodeSampleBatch(frame, length, samples, SAMPLE_BATCH_MAX);
+  if (count == 0) {
+    corruptedPackets++;
+    Serial.println("[ERROR] ❌ Malformed backfill batch!");
+    return;
+  }
+  answerVehicle();
+
+  int merged = 0;
+  int duplicates = 0;
+  for (size_t i = 0; i < count; i++) {
+    SampleHistory::InsertResult result = history.insert(samples[i]);
+    // A replaced sample had only come in as a reduced live frame
+    if (result == SampleHistory::INSERTED || result == SampleHistory::REPLACED) merged++;
+    else if (result == SampleHistory::DUPLICATE) duplicates++;
+  }
+  backfilledSamples += merged;
+  duplicateSamples += duplicates;
+
+  Serial.println("├─ BACKFILL ──────────────────────────────────────────────");
+  Serial.print("├─   ");
+  Serial.print(count);
+  Serial.print(" samples │ Vehicle time: ");
+  Serial.print(samples[0].timestampMs);
+  Serial.print(" - ");
+  Serial.print(samples[count - 1].timestampMs);
+  Serial.print("ms │ Merged: ");
+  Serial.print(merged);
+  Serial.print(" │ Duplicates: ");
+  Serial.println(duplicates);
+  Serial.print("├─   History: ");
+  Serial.print(history.size());
+  Serial.print(" samples │ Largest gap: ");
+  Serial.print(history.largestGapMs() / 1000);
+  Serial.println("s");
+}
+
+// Live JSON telemetry in the same fixed-point form as backfilled samples.
+// Fields a reduced frame leaves out are stored as zero and the sample is
+// marked partial, so a backfill of the full sample can replace it.
+void recordLiveSample(JsonDocument& doc) {
+  TelemetrySample sample;
+  sample.timestampMs = doc["timestamp"];
+  sample.batteryVoltage = (uint16_t)lroundf((float)doc["battery"]["voltage"] * 10);
+  sample.batteryCurrent = (int16_t)lroundf((float)doc["battery"]["current"] * 10);
+  sample.batterySoc = (uint16_t)lroundf((float)doc["battery"]["soc"] * 10);
+  sample.batteryTemp = (int16_t)lroundf((float)doc["battery"]["temp"] * 10);
+  sample.motorTemp = (int16_t)lroundf((float)doc["motor"]["temp"] * 10);
+  sample.motorCurrent = (int16_t)lroundf((float)doc["motor"]["current"] * 10);
+  sample.vehicleSpeed = (uint16_t)lroundf((float)doc["vehicle"]["speed"] * 10);
+  sample.motorRpm = (uint16_t)(int)doc["motor"]["rpm"];
+  sample.energyConsumption = (uint16_t)lroundf((float)doc["vehicle"]["energy_consumption"] * 10);
+  sample.motorEfficiency = (uint8_t)(int)doc["motor"]["efficiency"];
+  history.insert(sample, doc["reduced"] | false);
+}
+
+// Fault event queued ahead of periodic telemetry by the vehicle
+void printFaultEvent(JsonDocument& doc) {
+  const char* code = doc["event"]["code"] | "UNKNOWN";
+  const char* level = doc["event"]["level"] | "alert";
+  float value = doc["event"]["value"];
+  unsigned long timestamp = doc["timestamp"];
+  faultEvents++;
+
+  Serial.println("├─ VEHICLE FAULT EVENT ───────────────────────────────────");
+  Serial.print("├─   ");
+  Serial.print(strcmp(level, "critical") == 0 ? "🚨 CRITICAL: " : "⚠️  ALERT: ");
+  Serial.print(code);
+  Serial.print(" │ Value: ");
+  Serial.print(value, 1);
+  Serial.print(" │ Packet ID: ");
+  Serial.print((int)doc["id"]);
+  Serial.print(" │ Vehicle time: ");
+  Serial.print(timestamp);
+  Serial.println("ms");
+}
+
 void printSignalAnalysis(int rssi, float snr) {
   Serial.println("├─ SIGNAL ANALYSIS ───────────────────────────────────────");
   
@@ -388,6 +699,14 @@ void printStatistics() {
   Serial.print(lostPackets);
   Serial.print(" │ Corrupted: ");
   Serial.print(corruptedPackets);
+  Serial.print(" │ Reordered: ");
+  Serial.print(reorderedPackets);
+  Serial.print(" │ Duplicates: ");
+  Serial.print(duplicatePackets);
+  Serial.print(" │ Restarts: ");
+  Serial.print(senderRestarts);
+  Serial.print(" │ Faults: ");
+  Serial.print(faultEvents);
   Serial.print(" │ Success: ");
   Serial.print(stats.successRate, 1);
   Serial.println("%");
@@ -407,6 +726,54 @@ void printStatistics() {
   Serial.println("s ago");
 }
 
+void printFecStatistics() {
+  if (fecDecoder.parityFrames == 0 && fecDecoder.dataFrames == 0) return;
+
+  Serial.println("├─ FEC STATISTICS ────────────────────────────────────────");
+  Serial.print("├─   Recovered: ");
+  Serial.print(recoveredPackets);
+  Serial.print(" │ Unrecoverable: ");
+  Serial.print(fecDecoder.unrecoverableFrames);
+  Serial.print(" │ Parity frames: ");
+  Serial.print(fecDecoder.parityFrames);
+  Serial.print(" │ Airtime overhead: ");
+  Serial.print(dataAirtimeUs > 0 ? parityAirtimeUs * 100.0 / dataAirtimeUs : 0.0, 1);
+  Serial.println("%");
+
+  // Burst lengths tell how deep to interleave, their rate how small K must be
+  Serial.print("├─   Loss bursts 1/2/3/4+: ");
+  Serial.print(lossBursts[0]);
+  Serial.print("/");
+  Serial.print(lossBursts[1]);
+  Serial.print("/");
+  Serial.print(lossBursts[2]);
+  Serial.print("/");
+  Serial.print(lossBursts[3]);
+  Serial.print(" │ Longest: ");
+  Serial.print(longestLossBurst);
+  Serial.println(" packet(s)");
+}
+
+void printSecurityStatistics() {
+#if LINK_SECURE
+  uint32_t checked = linkOpener.openedFrames + linkOpener.authFailures + linkOpener.replayedFrames;
+  Serial.println("├─ LINK SECURITY ─────────────────────────────────────────");
+  Serial.print("├─   Authenticated: ");
+  Serial.print(linkOpener.openedFrames);
+  Serial.print(" │ Bad tag: ");
+  Serial.print(linkOpener.authFailures);
+  Serial.print(" │ Replayed: ");
+  Serial.print(linkOpener.replayedFrames);
+  Serial.print(" │ Unsealed: ");
+  Serial.println(frameGate.unsealedFrames);
+  Serial.print("├─   Avg open: ");
+  Serial.print(checked > 0 ? frameGate.openCycles / checked : 0);
+  Serial.print(" cycles (");
+  Serial.print(checked > 0 ? frameGate.openCycles / checked / (F_CPU / 1000000.0) : 0.0, 1);
+  Serial.println(" us)");
+#endif
+}
+
 void updateStatistics(int rssi, float snr, int packetSize) {
   // Update RSSI statistics
   if (rssi > bestRSSI) bestRSSI = rssi;
@@ -465,6 +832,16 @@ void printSystemStatus() {
   Serial.print("║ Data Rate: ");
   Serial.print(dataRate, 1);
   Serial.println(" bytes/sec                            ║");
+
+  Serial.print("║ History: ");
+  Serial.print(history.size());
+  Serial.print(" samples │ Backfilled: ");
+  Serial.print(backfilledSamples);
+  Serial.print(" │ Dup: ");
+  Serial.print(duplicateSamples);
+  Serial.print(" │ Beacons: ");
+  Serial.print(beaconsSent);
+  Serial.println("   ║");
   
   Serial.println("╚══════════════════════════════════════════════════════════╝");
 }
\ No newline at end of file
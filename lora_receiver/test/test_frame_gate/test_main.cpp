@@ -0,0 +1,95 @@
+// Native tests for the receiver's security gate: pio test -e native
+#include <unity.h>
+#include <string.h>
+#include <LinkCrypto.h>
+#include "FrameGate.h"
+
+static const uint8_t KEY[LINK_KEY_SIZE] = { LINK_KEY_BYTES };
+static const char JSON[] = "{\"id\":7,\"vehicle_id\":\"EC-01\",\"battery\":{\"soc\":81.5}}";
+
+static LinkSealer sealer;
+static LinkOpener opener;
+static FrameGate gate;
+
+static uint8_t delivered[LINK_SECURE_MAX_PAYLOAD];
+static size_t deliveredLength;
+static int deliveries;
+static bool deliveredRecovered;
+
+static void deliver(const uint8_t* payload, size_t length, bool recovered) {
+  memcpy(delivered, payload, length);
+  deliveredLength = length;
+  deliveredRecovered = recovered;
+  deliveries++;
+}
+
+static size_t sealJson(uint8_t* frame) {
+  return sealer.seal((const uint8_t*)JSON, strlen(JSON), frame);
+}
+
+void setUp() {
+  sealer.begin(KEY, 1);
+  opener.begin(KEY);
+  gate = FrameGate();
+  gate.begin(&opener, deliver);
+  deliveries = 0;
+  deliveredLength = 0;
+  deliveredRecovered = false;
+}
+
+void tearDown() {}
+
+// The opened payload is delivered once, as the JSON that was sealed
+void test_sealed_frame_delivers_plain_json() {
+  uint8_t frame[LINK_SECURE_MAX_FRAME];
+  size_t length = sealJson(frame);
+  TEST_ASSERT_EQUAL(strlen(JSON) + LINK_SECURE_OVERHEAD, length);
+
+  TEST_ASSERT_EQUAL(FrameGate::DELIVERED, gate.pass(frame, length, false));
+  TEST_ASSERT_EQUAL(1, deliveries);
+  TEST_ASSERT_EQUAL(strlen(JSON), deliveredLength);
+  TEST_ASSERT_EQUAL_MEMORY(JSON, delivered, deliveredLength);
+  TEST_ASSERT_EQUAL_UINT8('{', delivered[0]);
+  TEST_ASSERT_EQUAL(0, gate.unsealedFrames);
+  TEST_ASSERT_EQUAL(0, gate.rejectedFrames);
+}
+
+void test_recovered_flag_is_passed_on() {
+  uint8_t frame[LINK_SECURE_MAX_FRAME];
+  size_t length = sealJson(frame);
+  TEST_ASSERT_EQUAL(FrameGate::DELIVERED, gate.pass(frame, length, true));
+  TEST_ASSERT_TRUE(deliveredRecovered);
+}
+
+void test_plain_frame_is_not_delivered() {
+  TEST_ASSERT_EQUAL(FrameGate::UNSEALED, gate.pass((const uint8_t*)JSON, strlen(JSON), false));
+  TEST_ASSERT_EQUAL(0, deliveries);
+  TEST_ASSERT_EQUAL(1, gate.unsealedFrames);
+}
+
+void test_tampered_frame_is_rejected() {
+  uint8_t frame[LINK_SECURE_MAX_FRAME];
+  size_t length = sealJson(frame);
+  frame[LINK_SECURE_HEADER + 3] ^= 0x01;
+  TEST_ASSERT_EQUAL(FrameGate::REJECTED, gate.pass(frame, length, false));
+  TEST_ASSERT_EQUAL(0, deliveries);
+  TEST_ASSERT_EQUAL(1, gate.rejectedFrames);
+}
+
+void test_replayed_frame_is_rejected() {
+  uint8_t frame[LINK_SECURE_MAX_FRAME];
+  size_t length = sealJson(frame);
+  TEST_ASSERT_EQUAL(FrameGate::DELIVERED, gate.pass(frame, length, false));
+  TEST_ASSERT_EQUAL(FrameGate::REJECTED, gate.pass(frame, length, false));
+  TEST_ASSERT_EQUAL(1, deliveries);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_sealed_frame_delivers_plain_json);
+  RUN_TEST(test_recovered_flag_is_passed_on);
+  RUN_TEST(test_plain_frame_is_not_delivered);
+  RUN_TEST(test_tampered_frame_is_rejected);
+  RUN_TEST(test_replayed_frame_is_rejected);
+  return UNITY_END();
+}
@@ -0,0 +1,99 @@
+#include "SampleStore.h"
+#include <LittleFS.h>
+
+// Ring file of STORE_FLASH_SAMPLES fixed-size records. Slots are always
+// filled in order, so writes only ever land at or before the end of file.
+static size_t recordOffset(uint32_t index) {
+  return (size_t)index * sizeof(TelemetrySample);
+}
+
+bool SampleStore::begin() {
+  ramHead = 0;
+  ramCount = 0;
+  flashHead = 0;
+  flashCount = 0;
+  dropped = 0;
+
+  flashReady = LittleFS.begin(true);
+  if (!flashReady) return false;
+
+  // Timestamps are millis() since boot, so a backlog left over from before
+  // a reset cannot be merged on the pitstop and is discarded
+  File file = LittleFS.open(STORE_FILE, "w");
+  if (!file) {
+    flashReady = false;
+    return false;
+  }
+  file.close();
+  return true;
+}
+
+void SampleStore::push(const TelemetrySample& sample) {
+  if (ramCount == STORE_RAM_SAMPLES && !spillToFlash()) {
+    ramHead = (ramHead + 1) % STORE_RAM_SAMPLES;
+    ramCount--;
+    dropped++;
+  }
+  ram[(ramHead + ramCount) % STORE_RAM_SAMPLES] = sample;
+  ramCount++;
+}
+
+// Moves the oldest STORE_SPILL_BLOCK RAM samples to the flash ring
+bool SampleStore::spillToFlash() {
+  if (!flashReady) return false;
+
+  File file = LittleFS.open(STORE_FILE, "r+");
+  if (!file) return false;
+
+  for (uint16_t i = 0; i < STORE_SPILL_BLOCK && ramCount > 0; i++) {
+    if (flashCount == STORE_FLASH_SAMPLES) {
+      flashHead = (flashHead + 1) % STORE_FLASH_SAMPLES;
+      flashCount--;
+      dropped++;
+    }
+    uint32_t slot = (flashHead + flashCount) % STORE_FLASH_SAMPLES;
+    file.seek(recordOffset(slot));
+    file.write((const uint8_t*)&ram[ramHead], sizeof(TelemetrySample));
+    flashCount++;
+    ramHead = (ramHead + 1) % STORE_RAM_SAMPLES;
+    ramCount--;
+  }
+  file.close();
+  return true;
+}
+
+size_t SampleStore::peekOldest(TelemetrySample* out, size_t max) {
+  size_t n = 0;
+
+  // Spilled samples are always older than the ones still in RAM
+  if (flashCount > 0) {
+    File file = LittleFS.open(STORE_FILE, "r");
+    if (!file) return 0;
+    while (n < max && n < flashCount) {
+      uint32_t slot = (flashHead + n) % STORE_FLASH_SAMPLES;
+      file.seek(recordOffset(slot));
+      if (file.read((uint8_t*)&out[n], sizeof(TelemetrySample)) != sizeof(TelemetrySample)) break;
+      n++;
+    }
+    file.close();
+    return n;
+  }
+
+  while (n < max && n < ramCount) {
+    out[n] = ram[(ramHead + n) % STORE_RAM_SAMPLES];
+    n++;
+  }
+  return n;
+}
+
+void SampleStore::dropOldest(size_t n) {
+  if (flashCount > 0) {
+    if (n > flashCount) n = flashCount;
+    flashHead = (flashHead + n) % STORE_FLASH_SAMPLES;
+    flashCount -= n;
+    return;
+  }
+  if (n > ramCount) n = ramCount;
+  ramHead = (ramHead + n) % STORE_RAM_SAMPLES;
+  ramCount -= n;
+}
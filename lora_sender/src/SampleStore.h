@@ -0,0 +1,51 @@
+/*********
+  ESP32 LoRa Vehicle Sender - Store-and-forward sample buffer
+  Keeps samples the pitstop has not confirmed while the link is down.
+  New samples go into a RAM ring; when it fills, its oldest samples are
+  spilled in blocks to a fixed-record ring file on LittleFS. Both rings
+  drop their oldest samples when full, so the newest data always survives.
+*********/
+
+#ifndef SAMPLE_STORE_H
+#define SAMPLE_STORE_H
+
+#include <Arduino.h>
+#include <SampleCodec.h>
+
+#define STORE_RAM_SAMPLES     64
+#define STORE_SPILL_BLOCK     16      // samples moved to flash per write
+#define STORE_FLASH_SAMPLES   4096    // ~5.7 h at one sample per 5 s
+#define STORE_FILE            "/backlog.bin"
+
+class SampleStore {
+public:
+  // Mounts LittleFS and starts an empty backlog. Without flash the store
+  // still works with the RAM ring alone; returns false in that case.
+  bool begin();
+
+  void push(const TelemetrySample& sample);
+
+  // Copies up to max of the oldest samples without removing them
+  size_t peekOldest(TelemetrySample* out, size_t max);
+
+  // Removes the n oldest samples returned by peekOldest()
+  void dropOldest(size_t n);
+
+  size_t size() const { return ramCount + flashCount; }
+  size_t flashSize() const { return flashCount; }
+  uint32_t droppedSamples() const { return dropped; }
+
+private:
+  bool spillToFlash();
+
+  TelemetrySample ram[STORE_RAM_SAMPLES];
+  uint16_t ramHead = 0;
+  uint16_t ramCount = 0;
+
+  bool flashReady = false;
+  uint32_t flashHead = 0;
+  uint32_t flashCount = 0;
+  uint32_t dropped = 0;
+};
+
+#endif
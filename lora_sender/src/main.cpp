@@ -9,6 +9,16 @@
 #include <SPI.h>
 #include <LoRa.h>
 #include <ArduinoJson.h>
+#include <LoRaAirtime.h>
+#include <LoRaRegion.h>
+#include <AirtimeBudget.h>
+#include <TelemetryFec.h>
+#include <TxQueue.h>
+#include <SampleCodec.h>
+#include <LinkCrypto.h>
+#include <SimRandom.h>
+#include <Preferences.h>
+#include "SampleStore.h"
 
 // Define pins used by the LoRa transceiver module for ESP32
 #define SS    5    // NSS pin (GPIO5)
@@ -20,6 +30,125 @@
 // MISO = GPIO19
 // MOSI = GPIO23
 
+// LoRa radio settings (must match the pitstop receiver)
+#define LORA_SPREADING_FACTOR 7
+#define LORA_BANDWIDTH        125000
+#define LORA_CODING_RATE      5     // 4/5
+
+#define TELEMETRY_INTERVAL_MS 5000  // one telemetry sample every 5 seconds
+
+// A queued frame competes one priority class higher for every
+// TX_AGING_MS it waits, so bulk traffic is never starved for good
+#ifndef TX_AGING_MS
+#define TX_AGING_MS 10000
+#endif
+
+// Store-and-forward: the pitstop answers received frames with a beacon at
+// most every few seconds. Without a beacon for LINK_TIMEOUT_MS the link is
+// considered down and samples are buffered until it returns.
+#ifndef LINK_TIMEOUT_MS
+#define LINK_TIMEOUT_MS 30000
+#endif
+#define LINK_RX_WINDOW_MS   250   // listen for a beacon after each frame
+#define LINK_RECENT_SAMPLES (LINK_TIMEOUT_MS / TELEMETRY_INTERVAL_MS + 1)
+#define BACKFILL_MAX_FRAME  200   // leaves room for the FEC header
+
+// Window the regional duty cycle is averaged over (ETSI: one hour).
+// Sets the airtime bucket size: 1% of an hour = 36 s of time-on-air.
+#ifndef AIRTIME_WINDOW_MS
+#define AIRTIME_WINDOW_MS 3600000UL
+#endif
+
+// Optional packet-level FEC: one XOR parity frame per FEC_GROUP_SIZE data
+// frames, FEC_INTERLEAVE_DEPTH groups filled round-robin against burst loss.
+// FEC_GROUP_SIZE 0 sends plain JSON packets as before.
+#ifndef FEC_GROUP_SIZE
+#define FEC_GROUP_SIZE 0
+#endif
+#ifndef FEC_INTERLEAVE_DEPTH
+#define FEC_INTERLEAVE_DEPTH 2
+#endif
+
+// Frame encryption and authentication (LinkCrypto). Sequence numbers are
+// reserved in NVS in blocks, so a reboot never reuses a CTR nonce.
+#ifndef LINK_SECURE
+#define LINK_SECURE 1
+#endif
+#define LINK_SEQ_RESERVE 1024
+
+const LoRaRadioConfig radioConfig = {
+  LORA_SPREADING_FACTOR, LORA_BANDWIDTH, LORA_CODING_RATE, 8, false, false
+};
+
+#if FEC_GROUP_SIZE > 0
+FecEncoder fecEncoder;
+bool fecEnabled = false;            // FEC_GROUP_SIZE/FEC_INTERLEAVE_DEPTH accepted
+uint8_t fecFrame[FEC_MAX_FRAME];
+#endif
+#if LINK_SECURE
+const uint8_t linkKey[LINK_KEY_SIZE] = { LINK_KEY_BYTES };
+LinkSealer linkSealer;
+Preferences linkPrefs;
+uint32_t reservedSequence = 0;
+uint8_t sealedFrame[LINK_SECURE_MAX_FRAME];
+unsigned long sealCycles = 0;       // CPU cycles spent sealing frames
+unsigned long sealedFrames = 0;
+LinkOpener beaconOpener;            // pitstop beacons, downlink keys
+uint32_t bootSequence = 0;          // first sequence sealed since boot
+unsigned long rejectedBeacons = 0;  // forged, replayed or from an earlier boot
+#endif
+unsigned long dataAirtimeUs = 0;    // time-on-air spent on telemetry frames
+unsigned long parityAirtimeUs = 0;  // time-on-air spent on FEC parity frames
+
+// Airtime governor and the per-priority transmit queues
+AirtimeBudget airtimeBudget;
+TxQueue txQueue(TX_AGING_MS);
+unsigned long txDoneAt = 0;         // end of the frame currently on air
+unsigned long radioBusyUntil = 0;   // end of the beacon window after it
+unsigned long lastSampleTime = 0;
+int droppedParityFrames = 0;
+
+// Link state and the store-and-forward backlog
+SampleStore sampleStore;
+bool linkUp = false;
+unsigned long lastBeaconTime = 0;
+unsigned long linkLostTime = 0;
+TelemetrySample recentSamples[LINK_RECENT_SAMPLES];  // sent while link looked up
+int recentHead = 0;
+int recentCount = 0;
+unsigned long backfilledSamples = 0;
+
+// Vehicle faults checked on every sample. An event frame is queued when a
+// fault is raised or escalates, ahead of any periodic telemetry.
+enum FaultLevel { FAULT_NONE = 0, FAULT_ALERT, FAULT_CRITICAL };
+
+struct FaultMonitor {
+  const char* code;
+  const float* value;
+  float alertLevel;
+  float criticalLevel;
+  bool lowIsFault;     // fault when the value drops below the levels
+  FaultLevel level;
+};
+
+// Function prototypes
+void updateSensorReadings();
+void checkFaults(unsigned long now);
+void queueTelemetry(unsigned long now);
+void queueFaultEvent(const FaultMonitor& fault, unsigned long now);
+void serviceTxQueue(unsigned long now);
+TelemetrySample captureSample(unsigned long now);
+void pollDownlink(unsigned long now);
+void updateLinkState(unsigned long now);
+void serviceBackfill(unsigned long now);
+void printBacklog();
+void buildTelemetryJson(String& out, unsigned long timestamp, bool reduced);
+void printFecOverhead();
+void printAirtimeBudget();
+void printQueueStats();
+void beginLinkSecurity();
+void printLinkSecurity();
+
 // Vehicle telemetry data variables
 int packetID = 0;
 float batteryVoltage = 48.5;      // V - Batarya paketi gerilimi  
@@ -33,19 +162,32 @@ float motorRPM = 1850.0;          // RPM - Motor devir
 float energyConsumption = 156.7;  // Wh/km - Enerji tüketimi
 int motorEfficiency = 94;         // % - Motor verimliliği
 
+// Alert levels follow the pitstop alert system; critical levels and the
+// pack undervoltage limit are vehicle-side additions
+FaultMonitor faultMonitors[] = {
+  { "BATT_SOC",   &batterySOC,     20.0, 12.0, true,  FAULT_NONE },
+  { "BATT_VOLT",  &batteryVoltage, 42.0, 40.5, true,  FAULT_NONE },
+  { "BATT_TEMP",  &batteryTemp,    40.0, 50.0, false, FAULT_NONE },
+  { "MOTOR_TEMP", &motorTemp,      60.0, 75.0, false, FAULT_NONE },
+};
+const int faultMonitorCount = sizeof(faultMonitors) / sizeof(faultMonitors[0]);
+
+// Every simulated reading draws from rng; its seed is printed at boot
+SimRandom rng;
+
 // Simulated sensor reading functions
 void updateSensorReadings() {
   // Simulate real-time data changes (in real system, read from actual sensors)
-  batteryVoltage += random(-5, 5) / 10.0;
-  batteryCurrent += random(-20, 20) / 10.0; 
+  batteryVoltage += rng.range(-5, 5) / 10.0;
+  batteryCurrent += rng.range(-20, 20) / 10.0; 
   batterySOC -= 0.1; // Gradually decrease
-  batteryTemp += random(-2, 3) / 10.0;
-  motorTemp += random(-3, 4) / 10.0;
-  motorCurrent += random(-15, 15) / 10.0;
-  vehicleSpeed += random(-50, 50) / 10.0;
-  motorRPM += random(-100, 100);
-  energyConsumption += random(-10, 10) / 10.0;
-  motorEfficiency += random(-2, 2);
+  batteryTemp += rng.range(-2, 3) / 10.0;
+  motorTemp += rng.range(-3, 4) / 10.0;
+  motorCurrent += rng.range(-15, 15) / 10.0;
+  vehicleSpeed += rng.range(-50, 50) / 10.0;
+  motorRPM += rng.range(-100, 100);
+  energyConsumption += rng.range(-10, 10) / 10.0;
+  motorEfficiency += rng.range(-2, 2);
   
   // Keep values in realistic ranges
   if (batteryVoltage < 40.0) batteryVoltage = 40.0;
@@ -58,91 +200,518 @@ void updateSensorReadings() {
   if (motorEfficiency > 98) motorEfficiency = 98;
 }
 
-void setup() {
-  // Initialize Serial Monitor
-  Serial.begin(115200);
-  while (!Serial);
-  Serial.println("EC Vehicle Telemetry System - VEHICLE SIDE");
-  Serial.println("ESP32 LoRa Transmitter");
-  Serial.println("Sending vehicle data to pitstop...");
+// Raises or clears fault monitors for the current readings. Only a raise
+// or an escalation queues an event; a fault easing or clearing goes out
+// with the next periodic sample. The level follows the reading down, so a
+// fault that eases and escalates again raises another event.
+void checkFaults(unsigned long now) {
+  for (int i = 0; i < faultMonitorCount; i++) {
+    FaultMonitor& fault = faultMonitors[i];
+    float value = *fault.value;
+    bool critical = fault.lowIsFault ? value < fault.criticalLevel : value > fault.criticalLevel;
+    bool alert = fault.lowIsFault ? value < fault.alertLevel : value > fault.alertLevel;
+    FaultLevel level = critical ? FAULT_CRITICAL : (alert ? FAULT_ALERT : FAULT_NONE);
 
-  // Initialize random seed
-  randomSeed(esp_random());
+    if (level > fault.level) {
+      fault.level = level;
+      queueFaultEvent(fault, now);
+    } else if (level < fault.level) {
+      fault.level = level;
+    }
+  }
+}
 
-  // Setup LoRa transceiver module
-  LoRa.setPins(SS, RST, DIO0);
-  
-  // 868MHz for Europe (as per EC requirements)
-  while (!LoRa.begin(433E6)) {
-    Serial.println("LoRa init failed, retrying...");
-    delay(500);
+void queueFaultEvent(const FaultMonitor& fault, unsigned long now) {
+  StaticJsonDocument<192> eventData;
+  eventData["id"] = packetID++;
+  eventData["timestamp"] = now;
+  eventData["vehicle_id"] = "AKS-2025-001";
+  JsonObject event = eventData.createNestedObject("event");
+  event["code"] = fault.code;
+  event["level"] = fault.level == FAULT_CRITICAL ? "critical" : "alert";
+  event["value"] = round(*fault.value * 10) / 10.0;
+
+  uint8_t frame[TXQ_MAX_FRAME];
+  size_t length = serializeJson(eventData, (char*)frame, sizeof(frame));
+  FramePriority priority = fault.level == FAULT_CRITICAL ? PRIORITY_CRITICAL : PRIORITY_ALERT;
+  txQueue.push(priority, frame, length, now);
+
+  Serial.print("FAULT ");
+  Serial.print(fault.code);
+  Serial.print(" ");
+  Serial.print(event["level"].as<const char*>());
+  Serial.print(" (");
+  Serial.print(*fault.value, 1);
+  Serial.println("), event queued");
+}
+
+void queueTelemetry(unsigned long now) {
+  String telemetry;
+  buildTelemetryJson(telemetry, now, airtimeBudget.isLow());
+  if (!txQueue.push(PRIORITY_PERIODIC, (const uint8_t*)telemetry.c_str(), telemetry.length(), now)) {
+    Serial.println("Telemetry frame too long, not queued");
+    return;
   }
-  
-  // EC telemetry sync word 
-  LoRa.setSyncWord(0xEC); // 'E'fficiency 'C'hallenge
-  LoRa.setTxPower(20); // Max power for better range
-  LoRa.setSpreadingFactor(7); // Balance between range and data rate
-  
-  Serial.println("LoRa Vehicle Transmitter Ready!");
-  Serial.println("Vehicle ID: AKS-2025-001");
-  Serial.println("================================");
+  packetID++;
 }
 
-void loop() {
-  // Update sensor readings
-  updateSensorReadings();
-  
-  // Create JSON telemetry packet
+// Puts the highest-priority queued frame on air once the radio is idle and
+// the airtime budget admits it. Transmission is asynchronous so faults
+// keep being sampled while a frame is on air.
+void serviceTxQueue(unsigned long now) {
+  if ((long)(now - radioBusyUntil) < 0) return;
+
+  TxFrame* frame = txQueue.peek(now);
+  if (!frame) return;
+
+  const uint8_t* payload = frame->data;
+  size_t length = frame->length;
+  bool isParity = payload[0] == LINK_FRAME_FEC;
+  size_t airLength = length;
+
+  // Frames are sealed first and then FEC-wrapped, so parity built from
+  // sealed frames needs no sealing of its own
+#if LINK_SECURE
+  if (!isParity) {
+    if (length > LINK_SECURE_MAX_PAYLOAD) {
+      Serial.println("Frame too long to seal, dropped");
+      txQueue.discard(frame);
+      return;
+    }
+    airLength += LINK_SECURE_OVERHEAD;
+  }
+#endif
+#if FEC_GROUP_SIZE > 0
+  bool wrapFec = fecEnabled && !isParity && airLength <= FEC_MAX_PAYLOAD;
+  if (wrapFec) airLength += FEC_HEADER_SIZE;
+#endif
+
+  uint32_t airtimeUs = loraTimeOnAirUs(radioConfig, airLength);
+  if (!airtimeBudget.admit(airtimeUs, frame->priority)) {
+    txQueue.defer(frame);
+    return;
+  }
+  if (!LoRa.beginPacket()) return;  // previous frame still on air
+
+#if LINK_SECURE
+  if (!isParity) {
+    uint32_t start = ESP.getCycleCount();
+    length = linkSealer.seal(payload, length, sealedFrame);
+    sealCycles += ESP.getCycleCount() - start;
+    sealedFrames++;
+    payload = sealedFrame;
+
+    if (linkSealer.nextSequence() >= reservedSequence) {
+      reservedSequence += LINK_SEQ_RESERVE;
+      linkPrefs.putUInt("seq", reservedSequence);
+    }
+  }
+#endif
+#if FEC_GROUP_SIZE > 0
+  if (wrapFec) {
+    // Should the encoder refuse the frame, it goes out unwrapped
+    size_t fecLength = fecEncoder.encode(payload, length, fecFrame);
+    if (fecLength > 0) {
+      length = fecLength;
+      payload = fecFrame;
+    }
+  }
+#endif
+  LoRa.write(payload, length);
+  LoRa.endPacket(true);
+  airtimeBudget.consume(airtimeUs);
+  txDoneAt = now + airtimeUs / 1000 + 2;
+  radioBusyUntil = txDoneAt + LINK_RX_WINDOW_MS;
+  if (isParity) {
+    parityAirtimeUs += airtimeUs;
+  } else {
+    dataAirtimeUs += airtimeUs;
+  }
+
+  FramePriority priority = frame->priority;
+  unsigned long waited = now - frame->enqueuedMs;
+  txQueue.pop(frame, now);
+
+  Serial.print("Sent ");
+  Serial.print(isParity ? "parity" : "frame");
+  Serial.print(" (");
+  Serial.print(length);
+  Serial.print(" bytes, class ");
+  Serial.print(priority);
+  Serial.print(", waited ");
+  Serial.print(waited);
+  Serial.println(" ms)");
+
+#if FEC_GROUP_SIZE > 0
+  // Parity is optional: it is the first thing dropped when budget is low
+  size_t parityLength = fecEncoder.takeParity(fecFrame);
+  if (parityLength > 0) {
+    if (!airtimeBudget.isLow()) {
+      txQueue.push(PRIORITY_BULK, fecFrame, parityLength, now);
+    } else {
+      droppedParityFrames++;
+    }
+  }
+  if (isParity) printFecOverhead();
+#endif
+}
+
+// Fixed-point snapshot of the current readings for the backlog
+TelemetrySample captureSample(unsigned long now) {
+  TelemetrySample sample;
+  sample.timestampMs = now;
+  sample.batteryVoltage = (uint16_t)lroundf(batteryVoltage * 10);
+  sample.batteryCurrent = (int16_t)lroundf(batteryCurrent * 10);
+  sample.batterySoc = (uint16_t)lroundf(batterySOC * 10);
+  sample.batteryTemp = (int16_t)lroundf(batteryTemp * 10);
+  sample.motorTemp = (int16_t)lroundf(motorTemp * 10);
+  sample.motorCurrent = (int16_t)lroundf(motorCurrent * 10);
+  sample.vehicleSpeed = (uint16_t)lroundf(vehicleSpeed * 10);
+  sample.motorRpm = (uint16_t)lroundf(motorRPM);
+  sample.energyConsumption = (uint16_t)lroundf(energyConsumption * 10);
+  sample.motorEfficiency = (uint8_t)motorEfficiency;
+  return sample;
+}
+
+// Listens for pitstop beacons between transmissions
+void pollDownlink(unsigned long now) {
+  if ((long)(now - txDoneAt) < 0) return;  // never switch to RX mid-frame
+
+  int packetSize = LoRa.parsePacket();
+  if (!packetSize) return;
+
+  uint8_t frame[16];
+  size_t length = 0;
+  while (LoRa.available()) {
+    uint8_t b = LoRa.read();
+    if (length < sizeof(frame)) frame[length++] = b;
+  }
+#if LINK_SECURE
+  // A beacon is sealed under the sequence of the frame it answers. One
+  // that does not answer a frame sent since boot is a replay.
+  uint8_t plain[sizeof(frame)];
+  if (length == 0 || frame[0] != LINK_FRAME_SECURE) return;
+  length = beaconOpener.open(frame, length, plain);
+  uint32_t answered = beaconOpener.lastSequence();
+  if (length == 0 || answered < bootSequence || answered >= linkSealer.nextSequence()) {
+    rejectedBeacons++;
+    return;
+  }
+  const uint8_t* beacon = plain;
+#else
+  const uint8_t* beacon = frame;
+#endif
+  if (length < 3 || beacon[0] != LINK_FRAME_BEACON) return;
+
+  lastBeaconTime = now;
+  if (!linkUp) {
+    linkUp = true;
+    Serial.print("Link restored after ");
+    Serial.print(linkLostTime > 0 ? (now - linkLostTime) / 1000 : 0);
+    Serial.print(" s (last ID at pitstop: ");
+    Serial.print(beacon[1] | (beacon[2] << 8));
+    Serial.print("), backlog ");
+    Serial.print(sampleStore.size());
+    Serial.println(" samples");
+  }
+}
+
+// Declares the link down once beacons stop. Samples sent after the last
+// beacon may have been lost too, so they join the backlog; duplicates are
+// merged away on the pitstop.
+void updateLinkState(unsigned long now) {
+  if (!linkUp || now - lastBeaconTime <= LINK_TIMEOUT_MS) return;
+
+  linkUp = false;
+  linkLostTime = now;
+  for (int i = 0; i < recentCount; i++) {
+    const TelemetrySample& sample = recentSamples[(recentHead + i) % LINK_RECENT_SAMPLES];
+    if ((long)(sample.timestampMs - lastBeaconTime) > 0) sampleStore.push(sample);
+  }
+  recentCount = 0;
+  Serial.println("Link lost, buffering samples for backfill");
+}
+
+// Sends the backlog oldest first in delta-coded batches. Batches queue one
+// at a time at bulk priority, so live frames always go first.
+void serviceBackfill(unsigned long now) {
+  if (!linkUp || sampleStore.size() == 0) return;
+  if (txQueue.size(PRIORITY_BULK) > 0 || airtimeBudget.isLow()) return;
+
+  TelemetrySample batch[SAMPLE_BATCH_MAX];
+  size_t count = sampleStore.peekOldest(batch, SAMPLE_BATCH_MAX);
+  if (count == 0) return;
+
+  uint8_t frame[BACKFILL_MAX_FRAME];
+  size_t encoded = 0;
+  size_t length = encodeSampleBatch(batch, count, frame, sizeof(frame), &encoded);
+  if (length == 0 || !txQueue.push(PRIORITY_BULK, frame, length, now)) return;
+
+  sampleStore.dropOldest(encoded);
+  backfilledSamples += encoded;
+  Serial.print("Backfill batch queued: ");
+  Serial.print(encoded);
+  Serial.print(" samples in ");
+  Serial.print(length);
+  Serial.print(" bytes, ");
+  Serial.print(sampleStore.size());
+  Serial.println(" left");
+}
+
+// Builds the telemetry JSON for the current readings. A reduced frame
+// keeps only the fields the pitstop alerts on, to save airtime.
+void buildTelemetryJson(String& out, unsigned long timestamp, bool reduced) {
   StaticJsonDocument<512> telemetryData;
-  telemetryData["id"] = packetID++;
-  telemetryData["timestamp"] = millis();
+  telemetryData["id"] = packetID;
+  telemetryData["timestamp"] = timestamp;
   telemetryData["vehicle_id"] = "AKS-2025-001";
+  telemetryData["airtime"] = airtimeBudget.remainingPercent();
+  if (reduced) telemetryData["reduced"] = true;
   
   // Battery Management System data
   JsonObject battery = telemetryData.createNestedObject("battery");
   battery["voltage"] = round(batteryVoltage * 10) / 10.0;
-  battery["current"] = round(batteryCurrent * 10) / 10.0; 
+  if (!reduced) battery["current"] = round(batteryCurrent * 10) / 10.0;
   battery["soc"] = round(batterySOC * 10) / 10.0;
   battery["temp"] = round(batteryTemp * 10) / 10.0;
   
   // Motor Control System data  
   JsonObject motor = telemetryData.createNestedObject("motor");
   motor["temp"] = round(motorTemp * 10) / 10.0;
-  motor["current"] = round(motorCurrent * 10) / 10.0;
-  motor["rpm"] = (int)motorRPM;
-  motor["efficiency"] = motorEfficiency;
+  if (!reduced) {
+    motor["current"] = round(motorCurrent * 10) / 10.0;
+    motor["rpm"] = (int)motorRPM;
+    motor["efficiency"] = motorEfficiency;
+  }
   
   // Vehicle Control System data
   JsonObject vehicle = telemetryData.createNestedObject("vehicle");
   vehicle["speed"] = round(vehicleSpeed * 10) / 10.0;
-  vehicle["energy_consumption"] = round(energyConsumption * 10) / 10.0;
+  if (!reduced) vehicle["energy_consumption"] = round(energyConsumption * 10) / 10.0;
   
   // Serialize JSON to string
-  String telemetryJson;
-  serializeJson(telemetryData, telemetryJson);
+  out = "";
+  serializeJson(telemetryData, out);
+}
+
+#if FEC_GROUP_SIZE > 0
+void printFecOverhead() {
+  Serial.print("FEC parity sent (K=");
+  Serial.print(FEC_GROUP_SIZE);
+  Serial.print(", D=");
+  Serial.print(FEC_INTERLEAVE_DEPTH);
+  Serial.print(") | Airtime data: ");
+  Serial.print(dataAirtimeUs / 1000);
+  Serial.print(" ms, parity: ");
+  Serial.print(parityAirtimeUs / 1000);
+  Serial.print(" ms, overhead: ");
+  Serial.print(dataAirtimeUs > 0 ? parityAirtimeUs * 100.0 / dataAirtimeUs : 0.0, 1);
+  Serial.println("%");
+}
+#endif
+
+void printBacklog() {
+  Serial.print("Link: ");
+  Serial.print(linkUp ? "up" : "DOWN");
+  Serial.print(" | Backlog: ");
+  Serial.print(sampleStore.size());
+  Serial.print(" samples (");
+  Serial.print(sampleStore.flashSize());
+  Serial.print(" in flash) | Backfilled: ");
+  Serial.print(backfilledSamples);
+  Serial.print(" | Overwritten: ");
+  Serial.println(sampleStore.droppedSamples());
+}
+
+// Starts sealing at the first sequence number not reserved by an earlier
+// boot and reserves the next block before anything is sent
+void beginLinkSecurity() {
+#if LINK_SECURE
+  linkPrefs.begin("link", false);
+  uint32_t firstSequence = linkPrefs.getUInt("seq", 0);
+  reservedSequence = firstSequence + LINK_SEQ_RESERVE;
+  linkPrefs.putUInt("seq", reservedSequence);
+  linkSealer.begin(linkKey, firstSequence);
+  beaconOpener.begin(linkKey, LINK_DOWNLINK);
+  bootSequence = firstSequence;
+
+  Serial.print("Link security: AES-128-CTR + ");
+  Serial.print(LINK_TAG_SIZE * 8);
+  Serial.print("-bit CMAC, ");
+  Serial.print(LINK_SECURE_OVERHEAD);
+  Serial.print(" bytes per frame, sequence from ");
+  Serial.println(firstSequence);
+#ifdef LINK_KEY_IS_DEFAULT
+  Serial.println("WARNING: default link key in use, set LINK_KEY_BYTES");
+#endif
+#else
+  Serial.println("Link security disabled (LINK_SECURE=0)");
+#endif
+}
+
+void printLinkSecurity() {
+#if LINK_SECURE
+  Serial.print("Sealed frames: ");
+  Serial.print(sealedFrames);
+  Serial.print(" | Avg seal: ");
+  Serial.print(sealedFrames > 0 ? sealCycles / sealedFrames : 0);
+  Serial.print(" cycles (");
+  Serial.print(sealedFrames > 0 ? sealCycles / sealedFrames / (float)ESP.getCpuFreqMHz() : 0.0, 1);
+  Serial.print(" us) | Next sequence: ");
+  Serial.print(linkSealer.nextSequence());
+  Serial.print(" | Rejected beacons: ");
+  Serial.println(rejectedBeacons);
+#endif
+}
+
+void printAirtimeBudget() {
+  Serial.print("Airtime budget (");
+  Serial.print(LORA_REGION_NAME);
+  Serial.print(", ");
+  Serial.print(LORA_DUTY_CYCLE_PERMILLE / 10.0, 1);
+  Serial.print("% duty): ");
+  Serial.print(airtimeBudget.remainingUs() / 1000);
+  Serial.print(" / ");
+  Serial.print(airtimeBudget.capacityUs() / 1000);
+  Serial.print(" ms (");
+  Serial.print(airtimeBudget.remainingPercent());
+  Serial.print("%) | Parity dropped: ");
+  Serial.println(droppedParityFrames);
+}
+
+// Queueing delay per priority class: frames sent, average and worst wait,
+// frames that waited for budget and frames pushed out of a full queue
+void printQueueStats() {
+  static const char* const classNames[PRIORITY_COUNT] = { "critical", "alert", "periodic", "bulk" };
+  for (uint8_t p = 0; p < PRIORITY_COUNT; p++) {
+    const TxClassStats& stats = txQueue.stats((FramePriority)p);
+    Serial.print("  ");
+    Serial.print(classNames[p]);
+    Serial.print(": sent ");
+    Serial.print(stats.sent);
+    Serial.print(", avg wait ");
+    Serial.print(stats.sent > 0 ? stats.totalDelayMs / stats.sent : 0);
+    Serial.print(" ms, max ");
+    Serial.print(stats.maxDelayMs);
+    Serial.print(" ms, deferred ");
+    Serial.print(stats.deferred);
+    Serial.print(", dropped ");
+    Serial.println(stats.dropped);
+  }
+}
+
+void setup() {
+  // Initialize Serial Monitor
+  Serial.begin(115200);
+  while (!Serial);
+  Serial.println("EC Vehicle Telemetry System - VEHICLE SIDE");
+  Serial.println("ESP32 LoRa Transmitter");
+  Serial.println("Sending vehicle data to pitstop...");
+
+  // Seed the simulation; build with -D SIM_SEED=<printed seed> to replay
+  rng.reseed(SIM_BOOT_SEED(esp_random()));
+  Serial.print("Simulation seed: 0x");
+  Serial.println(rng.seed(), HEX);
+
+  // Setup LoRa transceiver module
+  LoRa.setPins(SS, RST, DIO0);
   
-  // Send LoRa packet to pitstop
-  Serial.print("Sending telemetry packet #");
-  Serial.print(packetID - 1);
-  Serial.print(" (");
-  Serial.print(telemetryJson.length());
-  Serial.println(" bytes)");
+  // Band comes from the build-time region (EU868 as per EC requirements)
+  while (!LoRa.begin(LORA_FREQUENCY)) {
+    Serial.println("LoRa init failed, retrying...");
+    delay(500);
+  }
   
-  LoRa.beginPacket();
-  LoRa.print(telemetryJson);
-  LoRa.endPacket();
+  // EC telemetry sync word 
+  LoRa.setSyncWord(0xEC); // 'E'fficiency 'C'hallenge
+  LoRa.setTxPower(LORA_MAX_TX_POWER); // Max regional power for better range
+  LoRa.setSpreadingFactor(LORA_SPREADING_FACTOR); // Balance between range and data rate
+  LoRa.setSignalBandwidth(LORA_BANDWIDTH);
+  LoRa.setCodingRate4(LORA_CODING_RATE);
+
+#if FEC_GROUP_SIZE > 0
+  fecEnabled = fecEncoder.begin(FEC_GROUP_SIZE, FEC_INTERLEAVE_DEPTH);
+  if (fecEnabled) {
+    Serial.print("FEC enabled: K=");
+    Serial.print(FEC_GROUP_SIZE);
+    Serial.print(" data frames per parity, interleave depth ");
+    Serial.println(FEC_INTERLEAVE_DEPTH);
+  } else {
+    Serial.println("FEC configuration invalid, sending without parity");
+  }
+#endif
+
+  airtimeBudget.begin(LORA_DUTY_CYCLE_PERMILLE, AIRTIME_WINDOW_MS, millis());
+
+  beginLinkSecurity();
+
+  if (!sampleStore.begin()) {
+    Serial.println("LittleFS unavailable, backlog limited to RAM");
+  }
   
-  // Print summary to serial
-  Serial.print("Battery: ");
-  Serial.print(batteryVoltage);
-  Serial.print("V, ");
-  Serial.print(batterySOC);
-  Serial.print("% | Speed: ");
-  Serial.print(vehicleSpeed);
-  Serial.print(" km/h | Motor: ");
-  Serial.print(motorTemp);
-  Serial.println("°C");
-  Serial.println("------------------------");
+  Serial.println("LoRa Vehicle Transmitter Ready!");
+  Serial.print("Region: ");
+  Serial.print(LORA_REGION_NAME);
+  Serial.print(" @ ");
+  Serial.print(LORA_FREQUENCY / 1000000.0, 3);
+  Serial.println(" MHz");
+  Serial.println("Vehicle ID: AKS-2025-001");
+  Serial.println("================================");
+}
+
+void loop() {
+  unsigned long now = millis();
+  airtimeBudget.update(now);
+
+  // Take a new sample every TELEMETRY_INTERVAL_MS. Fault events are queued
+  // ahead of the sample so they take the next free air slot.
+  if (lastSampleTime == 0 || now - lastSampleTime >= TELEMETRY_INTERVAL_MS) {
+    lastSampleTime = now;
+    updateSensorReadings();
+    checkFaults(now);
+
+    // Live frames keep going out while the link is down so the pitstop
+    // can answer the first one that gets through
+    TelemetrySample sample = captureSample(now);
+    if (linkUp) {
+      recentSamples[(recentHead + recentCount) % LINK_RECENT_SAMPLES] = sample;
+      if (recentCount < LINK_RECENT_SAMPLES) {
+        recentCount++;
+      } else {
+        recentHead = (recentHead + 1) % LINK_RECENT_SAMPLES;
+      }
+    } else {
+      sampleStore.push(sample);
+    }
+    queueTelemetry(now);
+    
+    // Print summary to serial
+    Serial.print("Battery: ");
+    Serial.print(batteryVoltage);
+    Serial.print("V, ");
+    Serial.print(batterySOC);
+    Serial.print("% | Speed: ");
+    Serial.print(vehicleSpeed);
+    Serial.print(" km/h | Motor: ");
+    Serial.print(motorTemp);
+    Serial.print("°C | Queued: ");
+    Serial.println(txQueue.size());
+
+    // Link report every 6 samples
+    static int sampleCount = 0;
+    if (++sampleCount % 6 == 0) {
+      printAirtimeBudget();
+      printBacklog();
+      printLinkSecurity();
+      printQueueStats();
+      Serial.println("------------------------");
+    }
+  }
+
+  pollDownlink(now);
+  updateLinkState(now);
+  serviceBackfill(now);
+  serviceTxQueue(now);
   
-  delay(5000); // Send every 5 seconds for real-time monitoring
-}
\ No newline at end of file
+  delay(10);
+}
@@ -0,0 +1,208 @@
+/*
+ * AKS Data Generator - host bulk dataset generator
+ * Runs VehicleSimulator, the same code the STM32 generator runs, for many
+ * independent vehicles across all cores and streams the sampled
+ * AKS_TelemetryData to an AksDataset file or CSV.
+ *
+ * Vehicles are handed out in index order and written back in index order,
+ * so a file depends only on the options and seed, never on the thread
+ * count or scheduling.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <AksDataset.h>
+#include <VehicleSimulator.h>
+
+struct Options {
+    uint32_t vehicles = 64;
+    uint32_t durationS = 3600;
+    uint32_t intervalMs = 1000;
+    uint32_t physicsHz = 100;
+    uint32_t seed = 1;
+    uint8_t mode = 0;             // 0 = cycle normal/fault/charging
+    unsigned threads = 0;         // 0 = all cores
+    bool csv = false;
+    const char *out = "dataset.bin";
+};
+
+static void usage() {
+    fprintf(stderr,
+        "usage: dataset_gen [options]\n"
+        "  --vehicles N     independent vehicles (default 64)\n"
+        "  --duration S     simulated seconds per vehicle (default 3600)\n"
+        "  --interval MS    sample interval (default 1000)\n"
+        "  --physics HZ     physics rate (default 100)\n"
+        "  --seed X         base seed, decimal or 0x hex (default 1)\n"
+        "  --mode M         cycle|normal|fault|charging|scenario (default cycle)\n"
+        "  --threads T      worker threads (default: all cores)\n"
+        "  --format F       bin|csv (default bin)\n"
+        "  --out PATH       output file, - for stdout (default dataset.bin)\n");
+}
+
+static bool parseMode(const char *name, uint8_t &mode) {
+    static const struct { const char *name; uint8_t mode; } MODES[] = {
+        { "cycle", 0 }, { "normal", AKS_MODE_NORMAL }, { "fault", AKS_MODE_FAULT },
+        { "charging", AKS_MODE_CHARGING }, { "scenario", AKS_MODE_SCENARIO },
+    };
+    for (const auto &m : MODES) {
+        if (strcmp(name, m.name) == 0) {
+            mode = m.mode;
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool parseOptions(int argc, char **argv, Options &opt) {
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *value = i + 1 < argc ? argv[i + 1] : NULL;
+        if (!value) return false;
+        i++;
+        if (!strcmp(arg, "--vehicles")) opt.vehicles = strtoul(value, NULL, 0);
+        else if (!strcmp(arg, "--duration")) opt.durationS = strtoul(value, NULL, 0);
+        else if (!strcmp(arg, "--interval")) opt.intervalMs = strtoul(value, NULL, 0);
+        else if (!strcmp(arg, "--physics")) opt.physicsHz = strtoul(value, NULL, 0);
+        else if (!strcmp(arg, "--seed")) opt.seed = strtoul(value, NULL, 0);
+        else if (!strcmp(arg, "--threads")) opt.threads = strtoul(value, NULL, 0);
+        else if (!strcmp(arg, "--out")) opt.out = value;
+        else if (!strcmp(arg, "--mode")) { if (!parseMode(value, opt.mode)) return false; }
+        else if (!strcmp(arg, "--format")) {
+            if (!strcmp(value, "csv")) opt.csv = true;
+            else if (strcmp(value, "bin")) return false;
+        }
+        else return false;
+    }
+    if (opt.vehicles == 0 || opt.intervalMs == 0 || opt.physicsHz == 0) return false;
+    // Samples must fall on physics steps
+    if ((uint64_t)opt.intervalMs * opt.physicsHz % 1000 != 0) {
+        fprintf(stderr, "interval must be a whole number of physics steps\n");
+        return false;
+    }
+    return true;
+}
+
+static void appendCsv(std::string &out, uint32_t vehicle, const AKS_TelemetryData &s) {
+    char line[160];
+    int n = snprintf(line, sizeof(line), "%u,%u,%.2f,%.2f,%.2f,%.0f,%.2f,%.2f,%u,%u\n",
+                     vehicle, s.timestamp_ms, s.vehicle_speed_kmh, s.battery_temp_C,
+                     s.battery_voltage_V, s.remaining_energy_Wh, s.motor_temp_C,
+                     s.brake_pressure_bar, s.system_status, s.fault_codes);
+    out.append(line, n);
+}
+
+// Simulates one vehicle into a ready-to-write buffer
+static void simulateVehicle(const Options &opt, uint32_t vehicle, uint32_t samples, std::string &out) {
+    VehicleSimulator sim;
+    uint8_t mode = opt.mode ? opt.mode : AKS_MODE_NORMAL;
+    sim.begin(aksDatasetSeed(opt.seed, vehicle), mode, opt.mode == 0);
+
+    const uint32_t stepsPerSample = opt.intervalMs * opt.physicsHz / 1000;
+    uint32_t step = 0;          // within the current simulated second
+    out.clear();
+    out.reserve(opt.csv ? samples * 64 : samples * sizeof(AksDatasetRecord));
+
+    AksDatasetRecord record;
+    record.vehicle = vehicle;
+    for (uint32_t i = 0; i < samples; i++) {
+        for (uint32_t k = 0; k < stepsPerSample; k++) {
+            sim.step(q16StepDt(step, opt.physicsHz));
+            step = (step + 1) % opt.physicsHz;
+        }
+        sim.sample(record.sample, (i + 1) * opt.intervalMs);
+        if (opt.csv) {
+            appendCsv(out, vehicle, record.sample);
+        } else {
+            out.append((const char *)&record, sizeof(record));
+        }
+    }
+}
+
+int main(int argc, char **argv) {
+    Options opt;
+    if (!parseOptions(argc, argv, opt)) {
+        usage();
+        return 2;
+    }
+    unsigned threads = opt.threads ? opt.threads : std::thread::hardware_concurrency();
+    if (threads == 0) threads = 1;
+    if (threads > opt.vehicles) threads = opt.vehicles;
+    const uint32_t samples = (uint32_t)((uint64_t)opt.durationS * 1000 / opt.intervalMs);
+
+    FILE *file = strcmp(opt.out, "-") == 0 ? stdout : fopen(opt.out, "wb");
+    if (!file) {
+        perror(opt.out);
+        return 1;
+    }
+    static char fileBuffer[1 << 20];
+    setvbuf(file, fileBuffer, _IOFBF, sizeof(fileBuffer));
+
+    if (opt.csv) {
+        fputs("vehicle,timestamp_ms,speed_kmh,battery_temp_C,battery_voltage_V,"
+              "remaining_energy_Wh,motor_temp_C,brake_pressure_bar,system_status,fault_codes\n", file);
+    } else {
+        AksDatasetHeader header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, AKS_DATASET_MAGIC, 4);
+        header.version = AKS_DATASET_VERSION;
+        header.record_size = sizeof(AksDatasetRecord);
+        header.vehicles = opt.vehicles;
+        header.samples_per_vehicle = samples;
+        header.sample_interval_ms = opt.intervalMs;
+        header.seed = opt.seed;
+        header.simulation_mode = opt.mode;
+        fwrite(&header, sizeof(header), 1, file);
+    }
+
+    // Work queue in vehicle order; results are committed in the same order
+    std::atomic<uint32_t> nextVehicle(0);
+    uint32_t nextToWrite = 0;
+    uint64_t bytesWritten = 0;
+    bool writeFailed = false;
+    std::mutex writeLock;
+    std::condition_variable writeTurn;
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; t++) {
+        workers.emplace_back([&]() {
+            std::string buffer;
+            for (;;) {
+                uint32_t vehicle = nextVehicle++;
+                if (vehicle >= opt.vehicles) break;
+                simulateVehicle(opt, vehicle, samples, buffer);
+
+                std::unique_lock<std::mutex> lock(writeLock);
+                writeTurn.wait(lock, [&]() { return nextToWrite == vehicle; });
+                if (fwrite(buffer.data(), 1, buffer.size(), file) != buffer.size()) writeFailed = true;
+                bytesWritten += buffer.size();
+                nextToWrite++;
+                writeTurn.notify_all();
+            }
+        });
+    }
+    for (auto &worker : workers) worker.join();
+    if (fflush(file) != 0) writeFailed = true;
+    if (file != stdout) fclose(file);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (writeFailed) {
+        fprintf(stderr, "write to %s failed\n", opt.out);
+        return 1;
+    }
+    uint64_t total = (uint64_t)samples * opt.vehicles;
+    fprintf(stderr, "%u vehicles x %u samples = %llu samples, %u threads, seed 0x%08X\n",
+            opt.vehicles, samples, (unsigned long long)total, threads, opt.seed);
+    fprintf(stderr, "%.2f s, %.0f samples/s, %.1f MB/s\n", seconds, total / seconds,
+            bytesWritten / seconds / 1e6);
+    return 0;
+}
@@ -0,0 +1,31 @@
+"""
+Pre-build hook: the three font variants the benchmark links, each with its
+own symbol suffix. Regenerated when a font, a screen file or the tool is
+newer than the output.
+"""
+
+import glob
+import os
+import subprocess
+
+Import("env")
+
+project = env.subst("$PROJECT_DIR")
+tool = os.path.normpath(os.path.join(project, "..", "font_subset", "font_subset.py"))
+src = os.path.normpath(os.path.join(project, "..", "..", "AKS_SCREEN", "temp_ui"))
+VARIANTS = [
+    ("fonts_full", "_full", ["--all"]),
+    ("fonts_subset", "_subset", []),
+    ("fonts_rle", "_rle", ["--compress"]),
+]
+
+inputs = glob.glob(os.path.join(src, "fonts", "ui_font_*.c")) + glob.glob(os.path.join(src, "ui*.c")) + [tool]
+newest = max(os.path.getmtime(p) for p in inputs)
+for directory, suffix, options in VARIANTS:
+    out = os.path.join(project, ".pio", directory)
+    stamp = os.path.join(out, "font_subset_fonts%s.c" % suffix)
+    if os.path.exists(stamp) and os.path.getmtime(stamp) >= newest:
+        continue
+    print("Generating %s" % directory)
+    subprocess.check_call([env.subst("$PYTHONEXE"), tool, "--in", src, "--out", out,
+                           "--suffix", suffix, "--check"] + options)
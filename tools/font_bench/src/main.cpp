@@ -0,0 +1,164 @@
+/*
+ * AKS Screen - glyph render benchmark
+ * Weighs what subsetting and compressing the dashboard fonts saves in
+ * flash against what it costs per glyph drawn. Every font is linked in
+ * three variants (see platformio.ini) and each variant draws the same
+ * text, the characters the dashboard shows, into a memory frame buffer
+ * (AKS_SCREEN's MemoryBackend):
+ *
+ *   draw    time for LVGL to render the text once, per glyph, with the
+ *           whole label redrawn in one pass
+ *   fetch   time to get one glyph bitmap from the font: a lookup for
+ *           plain bitmaps, a full decompression for compressed ones
+ *
+ * The frames of the three variants are compared pixel for pixel; the tool
+ * exits non-zero if a subset font draws the dashboard's text differently.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <vector>
+#include <lvgl.h>
+#include <MemoryBackend.h>
+#include "font_subset.h"
+
+extern "C" {
+extern const font_subset_font_t font_subset_fonts_full[];
+extern const uint16_t font_subset_font_count_full;
+extern const font_subset_font_t font_subset_fonts_subset[];
+extern const uint16_t font_subset_font_count_subset;
+extern const font_subset_font_t font_subset_fonts_rle[];
+extern const uint16_t font_subset_font_count_rle;
+}
+
+struct Variant {
+    const char *name;
+    const font_subset_font_t *fonts;
+    const uint16_t *count;
+};
+
+static const Variant VARIANTS[] = {
+    { "full", font_subset_fonts_full, &font_subset_font_count_full },
+    { "subset", font_subset_fonts_subset, &font_subset_font_count_subset },
+    { "subset+rle", font_subset_fonts_rle, &font_subset_font_count_rle },
+};
+
+static const uint16_t WIDTH = 800;
+static const uint16_t HEIGHT = 480;
+
+static MemoryBackend *panel;
+
+static void flushCb(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *color_p) {
+    uint32_t w = area->x2 - area->x1 + 1;
+    panel->flush(area->x1, area->y1, w, area->y2 - area->y1 + 1, color_p, w);
+    lv_disp_flush_ready(drv);
+}
+
+static double elapsedUs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+}
+
+static uint32_t glyphCount(const char *text) {
+    uint32_t count = 0;
+    for (uint32_t i = 0; _lv_txt_encoded_next(text, &i) != 0;) count++;
+    return count;
+}
+
+// Draws text with font rounds times; microseconds per glyph
+static double drawUs(lv_obj_t *label, const lv_font_t *font, const char *text, uint32_t rounds) {
+    lv_obj_set_style_text_font(label, font, 0);
+    lv_label_set_text_static(label, text);
+    lv_refr_now(NULL);
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t r = 0; r < rounds; r++) {
+        lv_obj_invalidate(label);
+        lv_refr_now(NULL);
+    }
+    return elapsedUs(start) / rounds / glyphCount(text);
+}
+
+// Fetches every glyph bitmap of text rounds times; microseconds per glyph
+static double fetchUs(const lv_font_t *font, const char *text, uint32_t rounds) {
+    auto start = std::chrono::steady_clock::now();
+    uint32_t sum = 0;
+    for (uint32_t r = 0; r < rounds; r++) {
+        for (uint32_t i = 0;;) {
+            uint32_t letter = _lv_txt_encoded_next(text, &i);
+            if (!letter) break;
+            const uint8_t *bitmap = lv_font_get_glyph_bitmap(font, letter);
+            if (bitmap) sum += bitmap[0];
+        }
+    }
+    double us = elapsedUs(start) / rounds / glyphCount(text);
+    return sum == 0xFFFFFFFF ? 0 : us;     // keeps the loop from being dropped
+}
+
+int main(int argc, char **argv) {
+    uint32_t rounds = 200;
+    if (argc == 3 && !strcmp(argv[1], "--rounds")) {
+        rounds = strtoul(argv[2], NULL, 0);
+    } else if (argc != 1 || rounds == 0) {
+        fprintf(stderr, "usage: font_bench [--rounds N]\n");
+        return 2;
+    }
+
+    MemoryBackend memory(WIDTH, HEIGHT);
+    if (!memory.begin()) return 1;
+    panel = &memory;
+    std::vector<lv_color_t> drawBuffer((size_t)WIDTH * HEIGHT);
+
+    lv_init();
+    static lv_disp_draw_buf_t drawBuf;
+    lv_disp_draw_buf_init(&drawBuf, drawBuffer.data(), NULL, drawBuffer.size());
+    static lv_disp_drv_t drv;
+    lv_disp_drv_init(&drv);
+    drv.hor_res = WIDTH;
+    drv.ver_res = HEIGHT;
+    drv.flush_cb = flushCb;
+    drv.draw_buf = &drawBuf;
+    lv_disp_drv_register(&drv);
+
+    lv_obj_t *label = lv_label_create(lv_scr_act());
+    lv_obj_set_width(label, WIDTH);
+    lv_label_set_long_mode(label, LV_LABEL_LONG_WRAP);
+
+    printf("%u rounds, %ux%u frame\n\n", rounds, WIDTH, HEIGHT);
+    printf("%-16s %-11s %6s %9s %9s %9s %9s  %s\n", "font", "variant", "glyphs", "bitmap", "flash",
+           "draw us", "fetch us", "pixels");
+
+    bool same = true;
+    uint32_t flash[3] = {};
+    const size_t framePixels = (size_t)WIDTH * HEIGHT;
+    for (uint16_t f = 0; f < *VARIANTS[0].count; f++) {
+        // The dashboard's characters, from the subset table
+        const char *text = VARIANTS[1].fonts[f].glyphs;
+        std::vector<lv_color_t> reference;
+        for (int v = 0; v < 3; v++) {
+            const font_subset_font_t &font = VARIANTS[v].fonts[f];
+            double draw = drawUs(label, font.font, text, rounds);
+            double fetch = fetchUs(font.font, text, rounds * 10);
+            const char *pixels = "reference";
+            if (v == 0) {
+                reference.assign(memory.pixels(), memory.pixels() + framePixels);
+            } else if (memcmp(reference.data(), memory.pixels(), framePixels * sizeof(lv_color_t)) == 0) {
+                pixels = "same";
+            } else {
+                pixels = "DIFFERENT";
+                same = false;
+            }
+            flash[v] += font.flash_bytes;
+            printf("%-16s %-11s %6u %9u %9u %9.3f %9.3f  %s\n", v == 0 ? font.name : "", VARIANTS[v].name,
+                   font.glyph_count, font.bitmap_bytes, font.flash_bytes, draw, fetch, pixels);
+        }
+    }
+
+    printf("\nfont data in flash: full %u, subset %u (%.1f%%), subset+rle %u (%.1f%%) bytes\n", flash[0],
+           flash[1], 100.0 * flash[1] / flash[0], flash[2], 100.0 * flash[2] / flash[0]);
+    if (!same) {
+        printf("FAIL: a subset font draws the dashboard's text differently\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,521 @@
+#!/usr/bin/env python3
+"""
+AKS Screen font subsetter
+Cuts the SquareLine fonts (AKS_SCREEN/temp_ui/fonts/ui_font_*.c) down to
+the characters the dashboard can show, keeping every symbol name so the
+screens build unchanged. SquareLine exports each font with a whole range
+(0x20-0xFF for the Montserrat sizes) although the dashboard shows a few
+dozen characters.
+
+The characters come from the text the screen files set (lv_label_set_text,
+roller and dropdown options, slider labels) plus --keep for text written at
+runtime: the telemetry labels show digits, sign, point, colon and percent.
+The glyphs are taken from the generated arrays rather than re-rendered, so
+no font files or lv_font_conv are needed and the kept glyphs stay
+pixel-identical. Kerning classes are carried over for the kept glyphs.
+
+With --compress the bitmaps are stored in lv_font_conv's compressed
+format (run-length coding on XOR-prefiltered rows), decoded by LVGL on
+every draw of a glyph; the firmware then needs LV_USE_FONT_COMPRESSED=1.
+
+font_subset_fonts.c lists every font with its glyph count and sizes, for
+tools/font_bench.
+
+Usage: font_subset.py --in AKS_SCREEN/temp_ui --out build/fonts [--compress] [--all] [--check]
+"""
+
+import argparse
+import glob
+import os
+import re
+import sys
+
+KEEP = " 0123456789+-.:%"           # written by TelemetryBinding and the slider labels
+DENSE_RUN = 8                       # consecutive code points worth a range of their own
+GLYPH_DSC_BYTES = 8                 # lv_font_fmt_txt_glyph_dsc_t
+CMAP_BYTES = 20                     # lv_font_fmt_txt_cmap_t on a 32-bit target
+
+TEXT_CALL_RE = re.compile(r"\b(lv_label_set_text|lv_label_set_text_static|lv_roller_set_options|"
+                          r"lv_dropdown_set_options|lv_dropdown_set_text|lv_textarea_set_text|"
+                          r"lv_textarea_set_placeholder_text|_ui_slider_set_text_value|"
+                          r"_ui_label_set_property|_ui_checked_set_text_value)\s*\(")
+STRING_RE = re.compile(r'"((?:[^"\\\n]|\\.)*)"')
+BITMAP_RE = re.compile(r"glyph_bitmap\[\]\s*=\s*\{(.*?)\};", re.S)
+GLYPH_RE = re.compile(r"\{\.bitmap_index = (\d+), \.adv_w = (\d+), \.box_w = (\d+), \.box_h = (\d+), "
+                      r"\.ofs_x = (-?\d+), \.ofs_y = (-?\d+)\}")
+CMAP_RE = re.compile(r"\.range_start = (\d+), \.range_length = (\d+), \.glyph_id_start = (\d+),\s*"
+                     r"\.unicode_list = (\w+), \.glyph_id_ofs_list = (\w+), \.list_length = (\d+), "
+                     r"\.type = (\w+)")
+ARRAY_RE = r"\b%s\[\]\s*=\s*\{(.*?)\};"
+FIELD_RE = re.compile(r"\.(line_height|base_line|underline_position|underline_thickness|kern_scale|"
+                      r"bpp|bitmap_format|left_class_cnt|right_class_cnt|subpx)\s*=\s*(-?\w+)")
+NAME_RE = re.compile(r"lv_font_t\s+(\w+)\s*=\s*\{")
+GUARD_RE = re.compile(r"#ifndef\s+(UI_FONT_\w+)")
+OPTS_RE = re.compile(r"^ \* (Size|Bpp|Opts): (.*)$", re.M)
+
+
+def numbers(text):
+    """The integers in an array body, comments skipped."""
+    text = re.sub(r"/\*.*?\*/", "", text, flags=re.S)
+    return [int(v, 0) for v in re.findall(r"-?(?:0x[0-9A-Fa-f]+|\d+)", text)]
+
+
+def c_unescape(literal):
+    out = []
+    i = 0
+    while i < len(literal):
+        c = literal[i]
+        if c != "\\":
+            out.append(c)
+            i += 1
+            continue
+        nxt = literal[i + 1]
+        if nxt == "x":
+            m = re.match(r"[0-9A-Fa-f]+", literal[i + 2:])
+            out.append(chr(int(m.group(0), 16)))
+            i += 2 + len(m.group(0))
+        else:
+            out.append({"n": "\n", "t": "\t", "r": "\r", "0": "\0"}.get(nxt, nxt))
+            i += 2
+    return "".join(out)
+
+
+def ui_characters(src):
+    """Every printable character in the text the screen and component
+    files set."""
+    chars = set()
+    for path in sorted(glob.glob(os.path.join(src, "ui*.c"))):
+        base = os.path.basename(path)
+        if base.startswith("ui_img_") or base == "ui_helpers.c":
+            continue
+        with open(path, encoding="utf-8") as f:
+            text = f.read()
+        for call in TEXT_CALL_RE.finditer(text):
+            end = text.index(");", call.end())
+            for literal in STRING_RE.findall(text, call.end(), end):
+                chars.update(c for c in c_unescape(literal) if c.isprintable())
+    return chars
+
+
+def read_bits(data, pos, length):
+    """length bits at bit position pos, most significant first."""
+    value = 0
+    for _ in range(length):
+        value = (value << 1) | ((data[pos >> 3] >> (7 - (pos & 7))) & 1)
+        pos += 1
+    return value
+
+
+class BitWriter:
+    def __init__(self):
+        self.out = bytearray()
+        self.acc = 0
+        self.count = 0
+
+    def write(self, value, length):
+        for shift in range(length - 1, -1, -1):
+            self.acc = (self.acc << 1) | ((value >> shift) & 1)
+            self.count += 1
+            if self.count == 8:
+                self.out.append(self.acc)
+                self.acc = self.count = 0
+
+    def getvalue(self):
+        """The bits so far, padded to a byte."""
+        if self.count:
+            return bytes(self.out) + bytes([self.acc << (8 - self.count)])
+        return bytes(self.out)
+
+
+def parse_font(path):
+    with open(path, encoding="utf-8") as f:
+        text = f.read()
+    fields = dict(FIELD_RE.findall(text))
+    if fields.get("bitmap_format", "0") not in ("0", "LV_FONT_FMT_TXT_PLAIN"):
+        sys.exit("%s: only uncompressed fonts can be subset" % path)
+    if "kern_pair_glyph_ids" in text:
+        sys.exit("%s: kerning pairs are not supported, only classes" % path)
+    bpp = int(fields["bpp"])
+    bitmap = bytes(numbers(BITMAP_RE.search(text).group(1)))
+    dscs = [tuple(int(v) for v in g) for g in GLYPH_RE.findall(text)]
+
+    # glyph id -> code point, from the character maps
+    codes = {}
+    for start, length, gid, ulist, olist, list_len, kind in CMAP_RE.findall(text):
+        start, length, gid, list_len = int(start), int(length), int(gid), int(list_len)
+        offsets = numbers(re.search(ARRAY_RE % olist, text, re.S).group(1)) if olist != "NULL" else None
+        if kind.endswith("FORMAT0_TINY"):
+            pairs = [(start + i, gid + i) for i in range(length)]
+        elif kind.endswith("FORMAT0_FULL"):
+            pairs = [(start + i, gid + offsets[i]) for i in range(length) if offsets[i]]
+        else:
+            unicodes = numbers(re.search(ARRAY_RE % ulist, text, re.S).group(1))
+            ids = offsets if kind.endswith("SPARSE_FULL") else range(list_len)
+            pairs = [(start + u, gid + o) for u, o in zip(unicodes, ids)]
+        for code, glyph_id in pairs:
+            codes[glyph_id] = code
+
+    glyphs = []
+    for glyph_id in sorted(codes):
+        index, adv_w, box_w, box_h, ofs_x, ofs_y = dscs[glyph_id]
+        pixels = [read_bits(bitmap, index * 8 + i * bpp, bpp) for i in range(box_w * box_h)]
+        glyphs.append({"id": glyph_id, "code": codes[glyph_id], "adv_w": adv_w, "box_w": box_w,
+                       "box_h": box_h, "ofs_x": ofs_x, "ofs_y": ofs_y, "pixels": pixels})
+
+    kern = None
+    if "kern_left_class_mapping" in text:
+        kern = {
+            "left": numbers(re.search(ARRAY_RE % "kern_left_class_mapping", text, re.S).group(1)),
+            "right": numbers(re.search(ARRAY_RE % "kern_right_class_mapping", text, re.S).group(1)),
+            "values": numbers(re.search(ARRAY_RE % "kern_class_values", text, re.S).group(1)),
+            "left_cnt": int(fields["left_class_cnt"]),
+            "right_cnt": int(fields["right_class_cnt"]),
+        }
+
+    return {
+        "name": NAME_RE.search(text).group(1),
+        "guard": GUARD_RE.search(text).group(1),
+        "opts": OPTS_RE.findall(text),
+        "bpp": bpp,
+        "glyphs": glyphs,
+        "kern": kern,
+        "kern_scale": int(fields.get("kern_scale", "0")),
+        "line_height": int(fields["line_height"]),
+        "base_line": int(fields["base_line"]),
+        "underline_position": int(fields.get("underline_position", "0")),
+        "underline_thickness": int(fields.get("underline_thickness", "0")),
+        "source_bitmap": len(bitmap),
+    }
+
+
+def prefilter(glyph):
+    """Rows XORed with the row above, as LVGL undoes it."""
+    w, px = glyph["box_w"], glyph["pixels"]
+    return px[:w] + [px[i] ^ px[i - w] for i in range(w, len(px))]
+
+
+def rle_encode(values, bpp):
+    """Codes values so that rle_next() in LVGL's lv_font_fmt_txt.c reads
+    them back: a value repeated right after itself switches to 1-bit
+    "same again" flags, 0 plus a value leaves; the 11th flag in a row is
+    followed by a 6-bit count of further repeats."""
+    out = BitWriter()
+    repeating = False
+    prev = None
+    flags = 0
+    i, n = 0, len(values)
+    while i < n:
+        v = values[i]
+        if not repeating:
+            out.write(v, bpp)
+            repeating = v == prev
+            flags = 0
+            prev = v
+            i += 1
+        elif v != prev:
+            out.write(0, 1)
+            out.write(v, bpp)
+            repeating = False
+            prev = v
+            i += 1
+        elif flags < 10:
+            out.write(1, 1)
+            flags += 1
+            i += 1
+        else:
+            out.write(1, 1)
+            run = 0
+            while run < 62 and i + 1 + run < n and values[i + 1 + run] == prev:
+                run += 1
+            out.write(run + 1, 6)
+            i += 1 + run
+            # The decoder reads the value after the run without a flag
+            if i < n:
+                out.write(values[i], bpp)
+                prev = values[i]
+                i += 1
+            repeating = False
+    return out.getvalue()
+
+
+def rle_decode(data, count, bpp):
+    """Python copy of LVGL's rle_next() state machine, for --check."""
+    out = []
+    pos = 0
+    state, prev, cnt = "single", 0, 0
+    for _ in range(count):
+        if state == "single":
+            ret = read_bits(data, pos, bpp)
+            if pos != 0 and prev == ret:
+                cnt, state = 0, "repeat"
+            prev = ret
+            pos += bpp
+        elif state == "repeat":
+            v = read_bits(data, pos, 1)
+            cnt += 1
+            pos += 1
+            if v == 1:
+                ret = prev
+                if cnt == 11:
+                    cnt = read_bits(data, pos, 6)
+                    pos += 6
+                    if cnt != 0:
+                        state = "counter"
+                    else:
+                        ret = prev = read_bits(data, pos, bpp)
+                        pos += bpp
+                        state = "single"
+            else:
+                ret = prev = read_bits(data, pos, bpp)
+                pos += bpp
+                state = "single"
+        else:
+            ret = prev
+            cnt -= 1
+            if cnt == 0:
+                ret = prev = read_bits(data, pos, bpp)
+                pos += bpp
+                state = "single"
+        out.append(ret)
+    return out
+
+
+def unfilter(values, w):
+    out = list(values[:w])
+    for i in range(w, len(values)):
+        out.append(values[i] ^ out[i - w])
+    return out
+
+
+def pack_plain(values, bpp):
+    out = BitWriter()
+    for v in values:
+        out.write(v, bpp)
+    return out.getvalue()
+
+
+def cmap_segments(codes):
+    """Splits the sorted code points into (first index, last index, dense)
+    segments: runs of DENSE_RUN or more become ranges, the rest lists."""
+    runs = []
+    start = 0
+    for i in range(1, len(codes) + 1):
+        if i == len(codes) or codes[i] != codes[i - 1] + 1:
+            runs.append((start, i - 1))
+            start = i
+    segments = []
+    for first, last in runs:
+        dense = last - first + 1 >= DENSE_RUN
+        if not dense and segments and not segments[-1][2]:
+            segments[-1] = (segments[-1][0], last, False)
+        else:
+            segments.append((first, last, dense))
+    return segments
+
+
+def c_list(values, per_line=16, fmt="%d"):
+    lines = []
+    for i in range(0, len(values), per_line):
+        lines.append("    " + ", ".join(fmt % v for v in values[i:i + per_line]))
+    return ",\n".join(lines)
+
+
+def subset_kern(kern, glyphs):
+    """Class mappings for the kept glyphs, renumbered to the classes they
+    still use, and the class pair table cut down to those classes."""
+    def renumber(mapping):
+        used = sorted({mapping[g["id"]] for g in glyphs} - {0})
+        new = {c: i + 1 for i, c in enumerate(used)}
+        return [new.get(mapping[g["id"]], 0) for g in glyphs], used
+
+    left, left_used = renumber(kern["left"])
+    right, right_used = renumber(kern["right"])
+    values = [kern["values"][(l - 1) * kern["right_cnt"] + (r - 1)] for l in left_used for r in right_used]
+    return left, right, values
+
+
+def write_font(path, font, glyphs, compress, suffix, source, check):
+    name = font["name"] + suffix
+    bpp = font["bpp"]
+    bitmap = bytearray()
+    dscs = []
+    for g in glyphs:
+        if compress:
+            blob = rle_encode(prefilter(g), bpp)
+            if check and unfilter(rle_decode(blob, len(g["pixels"]), bpp), g["box_w"]) != g["pixels"]:
+                sys.exit("%s: U+%04X does not decode to the original" % (font["name"], g["code"]))
+        else:
+            blob = pack_plain(g["pixels"], bpp)
+        dscs.append((len(bitmap), g))
+        bitmap += blob
+    if compress:
+        bitmap.append(0)            # the bit reader may look one byte ahead
+    if len(bitmap) >= 1 << 20:
+        sys.exit("%s: bitmap too large for a 20-bit index" % name)
+
+    codes = [g["code"] for g in glyphs]
+    segments = cmap_segments(codes)
+    kern = font["kern"]
+    size = len(bitmap) + GLYPH_DSC_BYTES * (len(glyphs) + 1) + CMAP_BYTES * len(segments)
+
+    with open(path, "w", encoding="utf-8") as f:
+        f.write("/*******************************************************************************\n")
+        f.write(" * Generated by tools/font_subset/font_subset.py from %s, do not edit\n" % source)
+        for key, value in font["opts"]:
+            f.write(" * Source %s: %s\n" % (key, value))
+        shown = "".join(chr(c) if c > 0x20 else "\\x%02x" % c for c in codes)
+        f.write(" * Glyphs: %s\n" % shown.replace("*/", "*\\/"))
+        f.write(" ******************************************************************************/\n\n")
+        f.write("#include <lvgl.h>\n\n")
+        f.write("#ifndef %s\n#define %s 1\n#endif\n\n#if %s\n\n" % (font["guard"], font["guard"], font["guard"]))
+        if compress:
+            f.write("#if !LV_USE_FONT_COMPRESSED\n")
+            f.write("#error \"%s has compressed bitmaps: set LV_USE_FONT_COMPRESSED=1\"\n#endif\n\n" % name)
+
+        f.write("static LV_ATTRIBUTE_LARGE_CONST const uint8_t glyph_bitmap[] = {\n")
+        f.write(c_list(list(bitmap), 16, "0x%02x") + "\n};\n\n")
+
+        f.write("static const lv_font_fmt_txt_glyph_dsc_t glyph_dsc[] = {\n")
+        f.write("    {.bitmap_index = 0, .adv_w = 0, .box_w = 0, .box_h = 0, .ofs_x = 0, .ofs_y = 0} /* id = 0 reserved */")
+        for index, g in dscs:
+            f.write(",\n    {.bitmap_index = %d, .adv_w = %d, .box_w = %d, .box_h = %d, .ofs_x = %d, .ofs_y = %d}"
+                    % (index, g["adv_w"], g["box_w"], g["box_h"], g["ofs_x"], g["ofs_y"]))
+        f.write("\n};\n\n")
+
+        for n, (first, last, dense) in enumerate(segments):
+            if not dense:
+                offsets = [c - codes[first] for c in codes[first:last + 1]]
+                size += 2 * len(offsets)
+                f.write("static const uint16_t unicode_list_%d[] = {\n%s\n};\n\n"
+                        % (n, c_list(offsets, 12, "0x%x")))
+        f.write("static const lv_font_fmt_txt_cmap_t cmaps[] = {\n")
+        entries = []
+        for n, (first, last, dense) in enumerate(segments):
+            start = codes[first]
+            if dense:
+                entries.append("    {\n        .range_start = %d, .range_length = %d, .glyph_id_start = %d,\n"
+                               "        .unicode_list = NULL, .glyph_id_ofs_list = NULL, .list_length = 0, "
+                               ".type = LV_FONT_FMT_TXT_CMAP_FORMAT0_TINY\n    }"
+                               % (start, last - first + 1, first + 1))
+            else:
+                entries.append("    {\n        .range_start = %d, .range_length = %d, .glyph_id_start = %d,\n"
+                               "        .unicode_list = unicode_list_%d, .glyph_id_ofs_list = NULL, .list_length = %d, "
+                               ".type = LV_FONT_FMT_TXT_CMAP_SPARSE_TINY\n    }"
+                               % (start, codes[last] - start + 1, first + 1, n, last - first + 1))
+        f.write(",\n".join(entries) + "\n};\n\n")
+
+        if kern:
+            left, right, values = subset_kern(kern, glyphs)
+            size += 2 * len(left) + len(values)
+            f.write("static const uint8_t kern_left_class_mapping[] = {\n%s\n};\n\n" % c_list([0] + left))
+            f.write("static const uint8_t kern_right_class_mapping[] = {\n%s\n};\n\n" % c_list([0] + right))
+            f.write("static const int8_t kern_class_values[] = {\n%s\n};\n\n" % c_list(values))
+            f.write("static const lv_font_fmt_txt_kern_classes_t kern_classes = {\n"
+                    "    .class_pair_values   = kern_class_values,\n"
+                    "    .left_class_mapping  = kern_left_class_mapping,\n"
+                    "    .right_class_mapping = kern_right_class_mapping,\n"
+                    "    .left_class_cnt      = %d,\n"
+                    "    .right_class_cnt     = %d,\n};\n\n" % (max(left), max(right)))
+
+        f.write("static lv_font_fmt_txt_glyph_cache_t cache;\n")
+        f.write("static const lv_font_fmt_txt_dsc_t font_dsc = {\n")
+        f.write("    .glyph_bitmap = glyph_bitmap,\n    .glyph_dsc = glyph_dsc,\n    .cmaps = cmaps,\n")
+        f.write("    .kern_dsc = %s,\n" % ("&kern_classes" if kern else "NULL"))
+        f.write("    .kern_scale = %d,\n    .cmap_num = %d,\n    .bpp = %d,\n"
+                % (font["kern_scale"], len(segments), bpp))
+        f.write("    .kern_classes = %d,\n" % (1 if kern else 0))
+        f.write("    .bitmap_format = %s,\n" % ("LV_FONT_FMT_TXT_COMPRESSED" if compress else "LV_FONT_FMT_TXT_PLAIN"))
+        f.write("    .cache = &cache\n};\n\n")
+
+        f.write("const lv_font_t %s = {\n" % name)
+        f.write("    .get_glyph_dsc = lv_font_get_glyph_dsc_fmt_txt,\n")
+        f.write("    .get_glyph_bitmap = lv_font_get_bitmap_fmt_txt,\n")
+        f.write("    .line_height = %d,\n    .base_line = %d,\n" % (font["line_height"], font["base_line"]))
+        f.write("    .subpx = LV_FONT_SUBPX_NONE,\n")
+        f.write("    .underline_position = %d,\n    .underline_thickness = %d,\n"
+                % (font["underline_position"], font["underline_thickness"]))
+        f.write("    .dsc = &font_dsc\n};\n\n#endif /*#if %s*/\n" % font["guard"])
+    return len(bitmap), size
+
+
+def write_header(path):
+    with open(path, "w") as f:
+        f.write("// Generated by tools/font_subset/font_subset.py, do not edit\n\n")
+        f.write("#ifndef FONT_SUBSET_H\n#define FONT_SUBSET_H\n\n#include <lvgl.h>\n\n")
+        f.write("typedef struct {\n")
+        f.write("    const char *name;\n")
+        f.write("    const lv_font_t *font;\n")
+        f.write("    const char *glyphs;            /* UTF-8, every glyph in the font */\n")
+        f.write("    uint16_t glyph_count;\n")
+        f.write("    uint8_t compressed;\n")
+        f.write("    uint32_t bitmap_bytes;\n")
+        f.write("    uint32_t flash_bytes;          /* bitmaps, descriptors, maps and kerning */\n")
+        f.write("} font_subset_font_t;\n\n#endif\n")
+
+
+def c_string(text):
+    out = []
+    for c in text:
+        if c in '"\\':
+            out.append("\\" + c)
+        elif ord(c) < 0x80:
+            out.append(c)
+        else:
+            out.append("".join("\\x%02x" % b for b in c.encode("utf-8")) + '""')
+    return '"%s"' % "".join(out)
+
+
+def write_table(path, fonts, suffix):
+    with open(path, "w") as f:
+        f.write("// Generated by tools/font_subset/font_subset.py, do not edit\n\n")
+        f.write('#include "font_subset.h"\n\n')
+        for name, _, _, _, _ in fonts:
+            f.write("LV_FONT_DECLARE(%s%s);\n" % (name, suffix))
+        f.write("\nconst font_subset_font_t font_subset_fonts%s[] = {\n" % suffix)
+        for name, codes, compress, bitmap, size in fonts:
+            f.write('    { "%s", &%s%s, %s, %d, %d, %d, %d },\n'
+                    % (name, name, suffix, c_string("".join(chr(c) for c in codes)), len(codes),
+                       1 if compress else 0, bitmap, size))
+        f.write("};\n")
+        f.write("const uint16_t font_subset_font_count%s = %d;\n" % (suffix, len(fonts)))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Subset the SquareLine fonts to the characters the UI shows")
+    parser.add_argument("--in", dest="src", required=True, help="SquareLine export, with fonts/ui_font_*.c")
+    parser.add_argument("--out", required=True, help="output directory")
+    parser.add_argument("--keep", default=KEEP, help="characters kept in every font (default %r)" % KEEP.replace("%", "%%"))
+    parser.add_argument("--all", action="store_true", help="keep every glyph (for comparisons)")
+    parser.add_argument("--compress", action="store_true", help="compressed bitmaps (LV_USE_FONT_COMPRESSED)")
+    parser.add_argument("--suffix", default="", help="appended to every symbol, to link variants together")
+    parser.add_argument("--check", action="store_true", help="decode every compressed glyph and compare")
+    args = parser.parse_args()
+
+    os.makedirs(args.out, exist_ok=True)
+    for old in glob.glob(os.path.join(args.out, "ui_font_*.c")):
+        os.remove(old)
+
+    wanted = {ord(c) for c in ui_characters(args.src) | set(args.keep)}
+    fonts = []
+    total_src = total_out = 0
+    print("%-16s %7s %7s %10s %10s %6s" % ("font", "glyphs", "kept", "bitmap", "subset", "ratio"))
+    for path in sorted(glob.glob(os.path.join(args.src, "fonts", "ui_font_*.c"))):
+        font = parse_font(path)
+        glyphs = [g for g in font["glyphs"] if args.all or g["code"] in wanted]
+        out_path = os.path.join(args.out, os.path.basename(path))
+        bitmap, size = write_font(out_path, font, glyphs, args.compress, args.suffix,
+                                  os.path.relpath(path, args.out), args.check)
+        fonts.append((font["name"], [g["code"] for g in glyphs], args.compress, bitmap, size))
+        total_src += font["source_bitmap"]
+        total_out += bitmap
+        print("%-16s %7d %7d %10d %10d %5.1f%%" % (font["name"], len(font["glyphs"]), len(glyphs),
+                                                  font["source_bitmap"], bitmap,
+                                                  100.0 * bitmap / max(font["source_bitmap"], 1)))
+
+    write_header(os.path.join(args.out, "font_subset.h"))
+    write_table(os.path.join(args.out, "font_subset_fonts%s.c" % args.suffix), fonts, args.suffix)
+    print("%-32s %10d %10d %5.1f%%" % ("total", total_src, total_out, 100.0 * total_out / max(total_src, 1)))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,41 @@
+"""
+PlatformIO pre-build hook for font_subset.py. Regenerates the fonts when a
+font, a screen file, the tool or the options changed. Paths come from the
+environment, relative to the project:
+
+  custom_font_subset_tool      font_subset.py
+  custom_font_subset_src       the SquareLine export (fonts/ and ui_*.c)
+  custom_font_subset_out       generated sources, added with build_src_filter
+  custom_font_subset_compress  optional: yes for compressed bitmaps; also
+                               sets LV_USE_FONT_COMPRESSED=1 for the build
+"""
+
+import glob
+import os
+import subprocess
+
+Import("env")
+
+project = env.subst("$PROJECT_DIR")
+tool = os.path.normpath(os.path.join(project, env.GetProjectOption("custom_font_subset_tool")))
+src = os.path.normpath(os.path.join(project, env.GetProjectOption("custom_font_subset_src")))
+out = os.path.normpath(os.path.join(project, env.GetProjectOption("custom_font_subset_out")))
+compress = env.GetProjectOption("custom_font_subset_compress", "no").lower() in ("yes", "true", "1")
+
+command = [env.subst("$PYTHONEXE"), tool, "--in", src, "--out", out]
+if compress:
+    command.append("--compress")
+    env.Append(CPPDEFINES=[("LV_USE_FONT_COMPRESSED", 1)])
+
+# The options are an input too: switching compression must regenerate
+stamp = os.path.join(out, "font_subset_fonts.c")
+args_file = os.path.join(out, "font_subset.args")
+args = " ".join(command[2:])
+previous = open(args_file).read() if os.path.exists(args_file) else None
+inputs = glob.glob(os.path.join(src, "fonts", "ui_font_*.c")) + glob.glob(os.path.join(src, "ui*.c")) + [tool]
+if (previous != args or not os.path.exists(stamp)
+        or max(os.path.getmtime(p) for p in inputs) > os.path.getmtime(stamp)):
+    print("Subsetting fonts from %s" % src)
+    subprocess.check_call(command)
+    with open(args_file, "w") as f:
+        f.write(args)
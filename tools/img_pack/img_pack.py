@@ -0,0 +1,308 @@
+#!/usr/bin/env python3
+"""
+AKS Screen image packer
+Converts the SquareLine image arrays (AKS_SCREEN/temp_ui/ui_img_*.c) into
+the packed format decoded by AKS_SCREEN/src/ImagePack.cpp, keeping every
+symbol name so ui_Home.c and ui_Settings.c build unchanged.
+
+Each image is packed with the smaller of two lossless encodings:
+  palette  up to 256 distinct pixels, rows of run-length coded 1-byte indices
+  rle      rows of run-length coded pixels
+and kept as the original array when neither saves at least 10%.
+
+With --fs DIR the packed images go to DIR/img/<name>.akp for the LittleFS
+partition instead, always packed, and each symbol becomes a small
+img_pack_file_ref_t that names its file; ImagePack.cpp reads the file
+through the lv_fs driver in src/AssetFs.cpp the first time the image is
+drawn.
+
+Either way img_pack_assets.c also lists the images each screen file
+(ui_<Screen>.c) uses, for prefetching the screen about to be shown.
+
+Usage: img_pack.py --in AKS_SCREEN/temp_ui --out build/img_pack [--fs data] [--check]
+"""
+
+import argparse
+import glob
+import os
+import re
+import struct
+import sys
+
+MAGIC = b"AKP1"
+FILE_MAGIC = b"AKF1"
+ENC_RLE = 1
+ENC_PALETTE = 2
+HEADER = struct.Struct("<4sHBBHHHH")    # img_pack_header_t, 16 bytes
+FILE_REF = struct.Struct("<4sHHI")      # img_pack_file_ref_t, 12 bytes + path
+MIN_SAVING = 0.9                        # packed must be below 90% of raw
+
+CF_PIXEL_SIZE = {"LV_IMG_CF_TRUE_COLOR": 2, "LV_IMG_CF_TRUE_COLOR_ALPHA": 3}
+CF_PACKED = {"LV_IMG_CF_TRUE_COLOR": "LV_IMG_CF_RAW", "LV_IMG_CF_TRUE_COLOR_ALPHA": "LV_IMG_CF_RAW_ALPHA"}
+
+DATA_RE = re.compile(r"uint8_t\s+(\w+)_data\[\]\s*=\s*\{(.*?)\};", re.S)
+SCREEN_RE = re.compile(r"void\s+ui_(\w+)_screen_init\s*\(\s*void\s*\)\s*\{")
+IMG_REF_RE = re.compile(r"&(ui_img_\w+)")
+FIELD_RE = re.compile(r"\.header\.(w|h|cf)\s*=\s*(\w+)")
+
+
+def parse_image(path):
+    """Returns (name, w, h, cf, data) or None if the file is not a plain array."""
+    with open(path) as f:
+        text = f.read()
+    match = DATA_RE.search(text)
+    if not match:
+        return None
+    fields = dict(FIELD_RE.findall(text))
+    try:
+        w, h = int(fields["w"]), int(fields["h"])
+    except (KeyError, ValueError):
+        return None                     # sizes from macros, e.g. the map tile
+    cf = fields.get("cf")
+    if cf not in CF_PIXEL_SIZE:
+        return None
+    data = bytes(int(v, 16) for v in re.findall(r"0x([0-9A-Fa-f]{2})", match.group(2)))
+    if len(data) != w * h * CF_PIXEL_SIZE[cf]:
+        return None
+    return match.group(1), w, h, cf, data
+
+
+def rle_row(units, unit_size):
+    """Run-length codes one row of units (bytes objects of unit_size).
+    Control byte c: c < 0x80 is a literal of c+1 units, otherwise a run of
+    (c & 0x7F) + 1 copies of the unit that follows."""
+    min_run = 2 if unit_size > 1 else 3
+    out = bytearray()
+    literal = []
+    i, n = 0, len(units)
+
+    def flush_literal():
+        for k in range(0, len(literal), 128):
+            chunk = literal[k:k + 128]
+            out.append(len(chunk) - 1)
+            for u in chunk:
+                out.extend(u)
+        literal.clear()
+
+    while i < n:
+        run = 1
+        while i + run < n and run < 128 and units[i + run] == units[i]:
+            run += 1
+        if run >= min_run:
+            flush_literal()
+            out.append(0x80 | (run - 1))
+            out += units[i]
+            i += run
+        else:
+            literal.append(units[i])
+            i += 1
+    flush_literal()
+    return bytes(out)
+
+
+def unrle_row(data, pos, count, unit_size):
+    units = []
+    while len(units) < count:
+        c = data[pos]
+        pos += 1
+        if c & 0x80:
+            units += [data[pos:pos + unit_size]] * ((c & 0x7F) + 1)
+            pos += unit_size
+        else:
+            for _ in range(c + 1):
+                units.append(data[pos:pos + unit_size])
+                pos += unit_size
+    return units
+
+
+def pack(image_id, w, h, pixel_size, data, min_saving=MIN_SAVING):
+    """Returns the packed blob with the smaller encoding, or None if it is
+    not below min_saving of the raw size (min_saving None: always the blob)."""
+    rows = [[data[(y * w + x) * pixel_size:(y * w + x + 1) * pixel_size] for x in range(w)]
+            for y in range(h)]
+
+    candidates = [(ENC_RLE, b"", [rle_row(r, pixel_size) for r in rows])]
+    palette = sorted(set(data[i:i + pixel_size] for i in range(0, len(data), pixel_size)))
+    if len(palette) <= 256:
+        index = {p: bytes([i]) for i, p in enumerate(palette)}
+        candidates.append((ENC_PALETTE, b"".join(palette),
+                           [rle_row([index[p] for p in r], 1) for r in rows]))
+
+    best = None
+    for encoding, pal, coded in candidates:
+        offsets, pos = [], 0
+        for row in coded:
+            offsets.append(pos)
+            pos += len(row)
+        blob = (HEADER.pack(MAGIC, image_id, encoding, pixel_size, w, h,
+                            len(pal) // pixel_size if pal else 0, 0)
+                + pal + struct.pack("<%dI" % h, *offsets) + b"".join(coded))
+        if best is None or len(blob) < len(best):
+            best = blob
+    if min_saving is not None and len(best) >= len(data) * min_saving:
+        return None
+    return best
+
+
+def unpack(blob):
+    """Reference decoder for --check, mirrors ImagePack.cpp."""
+    magic, _, encoding, pixel_size, w, h, palette_size, _ = HEADER.unpack_from(blob)
+    assert magic == MAGIC
+    pos = HEADER.size
+    palette = [blob[pos + i * pixel_size:pos + (i + 1) * pixel_size] for i in range(palette_size)]
+    pos += palette_size * pixel_size
+    offsets = struct.unpack_from("<%dI" % h, blob, pos)
+    rows_at = pos + 4 * h
+    out = bytearray()
+    for y in range(h):
+        if encoding == ENC_PALETTE:
+            out += b"".join(palette[u[0]] for u in unrle_row(blob, rows_at + offsets[y], w, 1))
+        else:
+            out += b"".join(unrle_row(blob, rows_at + offsets[y], w, pixel_size))
+    return bytes(out)
+
+
+def c_array(data):
+    lines = []
+    for i in range(0, len(data), 32):
+        lines.append("    " + ",".join("0x%02X" % b for b in data[i:i + 32]) + ",")
+    return "\n".join(lines)
+
+
+def write_packed(path, name, w, h, cf, blob, source):
+    with open(path, "w") as f:
+        f.write("// Generated by tools/img_pack/img_pack.py from %s, do not edit\n\n" % source)
+        f.write('#include "ui.h"\n\n')
+        f.write("#ifndef LV_ATTRIBUTE_MEM_ALIGN\n    #define LV_ATTRIBUTE_MEM_ALIGN\n#endif\n\n")
+        f.write("const LV_ATTRIBUTE_MEM_ALIGN uint8_t %s_data[] = {\n%s\n};\n" % (name, c_array(blob)))
+        f.write("const lv_img_dsc_t %s = {\n" % name)
+        f.write("    .header.always_zero = 0,\n")
+        f.write("    .header.w = %d,\n    .header.h = %d,\n" % (w, h))
+        f.write("    .data_size = sizeof(%s_data),\n" % name)
+        f.write("    .header.cf = %s,\n" % CF_PACKED[cf])
+        f.write("    .data = %s_data\n};\n" % name)
+
+
+def write_file_ref(path, name, w, h, cf, image_id, file_size, fs_path, source):
+    """Descriptor whose data names the file holding the packed image."""
+    ref = FILE_REF.pack(FILE_MAGIC, image_id, len(fs_path), file_size) + fs_path.encode() + b"\0"
+    with open(path, "w") as f:
+        f.write("// Generated by tools/img_pack/img_pack.py from %s, do not edit\n" % source)
+        f.write("// Pixels in %s\n\n" % fs_path)
+        f.write('#include "ui.h"\n\n')
+        f.write("#ifndef LV_ATTRIBUTE_MEM_ALIGN\n    #define LV_ATTRIBUTE_MEM_ALIGN\n#endif\n\n")
+        f.write("const LV_ATTRIBUTE_MEM_ALIGN uint8_t %s_data[] = {\n%s\n};\n" % (name, c_array(ref)))
+        f.write("const lv_img_dsc_t %s = {\n" % name)
+        f.write("    .header.always_zero = 0,\n")
+        f.write("    .header.w = %d,\n    .header.h = %d,\n" % (w, h))
+        f.write("    .data_size = sizeof(%s_data),\n" % name)
+        f.write("    .header.cf = %s,\n" % CF_PACKED[cf])
+        f.write("    .data = %s_data\n};\n" % name)
+
+
+def find_screens(src, names):
+    """[(screen, [image names])] for every ui_<Screen>.c, images in the
+    order of names (the asset table)."""
+    screens = []
+    for path in sorted(glob.glob(os.path.join(src, "ui_*.c"))):
+        with open(path) as f:
+            text = f.read()
+        match = SCREEN_RE.search(text)
+        if not match or os.path.basename(path) != "ui_%s.c" % match.group(1):
+            continue
+        used = set(IMG_REF_RE.findall(text))
+        screens.append((match.group(1), [n for n in names if n in used]))
+    return screens
+
+
+def write_table(path, assets, screens):
+    with open(path, "w") as f:
+        f.write("// Generated by tools/img_pack/img_pack.py, do not edit\n\n")
+        f.write('#include "ui.h"\n#include "ImagePack.h"\n\n')
+        f.write("const img_pack_asset_t img_pack_assets[] = {\n")
+        for name, raw_size in assets:
+            f.write('    { "%s", &%s, %d },\n' % (name[len("ui_img_"):], name, raw_size))
+        f.write("};\n")
+        f.write("const uint16_t img_pack_asset_count = %d;\n\n" % len(assets))
+
+        for screen, images in screens:
+            f.write("static const lv_img_dsc_t *const %s_images[] = {\n" % screen)
+            for name in images:
+                f.write("    &%s,\n" % name)
+            f.write("};\n")
+        f.write("\nconst img_pack_screen_t img_pack_screens[] = {\n")
+        for screen, images in screens:
+            f.write('    { "%s", &ui_%s, %s_images, %d },\n' % (screen, screen, screen, len(images)))
+        f.write("};\n")
+        f.write("const uint16_t img_pack_screen_count = %d;\n" % len(screens))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Pack SquareLine image arrays for ImagePack")
+    parser.add_argument("--in", dest="src", required=True, help="directory with ui_img_*.c")
+    parser.add_argument("--out", required=True, help="output directory")
+    parser.add_argument("--fs", help="write the packed images to FS/img for LittleFS")
+    parser.add_argument("--fs-letter", default="L", help="lv_fs drive letter of the LittleFS driver")
+    parser.add_argument("--check", action="store_true", help="decode every packed image and compare")
+    args = parser.parse_args()
+
+    os.makedirs(args.out, exist_ok=True)
+    for old in glob.glob(os.path.join(args.out, "ui_img_*.c")):
+        os.remove(old)
+    if args.fs:
+        fs_img = os.path.join(args.fs, "img")
+        os.makedirs(fs_img, exist_ok=True)
+        for old in glob.glob(os.path.join(fs_img, "*.akp")):
+            os.remove(old)
+
+    assets = []
+    total_raw = total_flash = 0
+    print("%-22s %9s %-8s %10s %10s %6s" % ("asset", "size", "format", "raw", "flash", "ratio"))
+    for path in sorted(glob.glob(os.path.join(args.src, "ui_img_*.c"))):
+        base = os.path.basename(path)
+        out_path = os.path.join(args.out, base)
+        image = parse_image(path)
+        if image is None:
+            # Not a plain array (e.g. built from macros): use as is
+            with open(path) as f, open(out_path, "w") as o:
+                o.write(f.read())
+            print("%-22s %9s %-8s" % (base[len("ui_img_"):-2], "", "copied"))
+            continue
+
+        name, w, h, cf, data = image
+        # A file has to hold a packed image, even one that barely shrinks
+        blob = pack(len(assets), w, h, CF_PIXEL_SIZE[cf], data, None if args.fs else MIN_SAVING)
+        if args.fs:
+            if args.check and unpack(blob) != data:
+                sys.exit("%s: packed image does not decode to the original" % name)
+            file_name = name[len("ui_img_"):] + ".akp"
+            with open(os.path.join(fs_img, file_name), "wb") as o:
+                o.write(blob)
+            write_file_ref(out_path, name, w, h, cf, len(assets), len(blob),
+                           "%s:/img/%s" % (args.fs_letter, file_name), os.path.relpath(path, args.out))
+            fmt = "fs " + ("palette" if blob[6] == ENC_PALETTE else "rle")
+            flash = len(blob)
+        elif blob is None:
+            with open(path) as f, open(out_path, "w") as o:
+                o.write(f.read())
+            fmt, flash = "raw", len(data)
+        else:
+            if args.check and unpack(blob) != data:
+                sys.exit("%s: packed image does not decode to the original" % name)
+            write_packed(out_path, name, w, h, cf, blob, os.path.relpath(path, args.out))
+            fmt = "palette" if blob[6] == ENC_PALETTE else "rle"
+            flash = len(blob)
+        assets.append((name, len(data)))
+        total_raw += len(data)
+        total_flash += flash
+        print("%-22s %9s %-8s %10d %10d %5.1f%%" % (name[len("ui_img_"):], "%dx%d" % (w, h), fmt,
+                                                   len(data), flash, 100.0 * flash / len(data)))
+
+    write_table(os.path.join(args.out, "img_pack_assets.c"), assets,
+                find_screens(args.src, [name for name, _ in assets]))
+    print("%-41s %10d %10d %5.1f%%" % ("total", total_raw, total_flash,
+                                       100.0 * total_flash / max(total_raw, 1)))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,35 @@
+"""
+PlatformIO pre-build hook for img_pack.py. Repacks the images when a
+source array or the packer is newer than the last output. Paths come from
+the environment, relative to the project:
+
+  custom_img_pack_tool  img_pack.py
+  custom_img_pack_src   directory with the ui_img_*.c arrays
+  custom_img_pack_out   generated sources, added with build_src_filter
+  custom_img_pack_fs    optional: the LittleFS data directory, for --fs
+"""
+
+import glob
+import os
+import subprocess
+
+Import("env")
+
+project = env.subst("$PROJECT_DIR")
+tool = os.path.normpath(os.path.join(project, env.GetProjectOption("custom_img_pack_tool")))
+src = os.path.normpath(os.path.join(project, env.GetProjectOption("custom_img_pack_src")))
+out = os.path.normpath(os.path.join(project, env.GetProjectOption("custom_img_pack_out")))
+fs = env.GetProjectOption("custom_img_pack_fs", "")
+
+command = [env.subst("$PYTHONEXE"), tool, "--in", src, "--out", out]
+stamp = os.path.join(out, "img_pack_assets.c")
+# The screen files are inputs too: they decide the prefetch lists
+inputs = glob.glob(os.path.join(src, "ui_*.c")) + [tool]
+if fs:
+    fs = os.path.normpath(os.path.join(project, fs))
+    command += ["--fs", fs]
+    inputs.append(os.path.join(fs, "img"))    # rebuilt when deleted
+if (not os.path.exists(stamp) or not all(os.path.exists(p) for p in inputs)
+        or max(os.path.getmtime(p) for p in inputs) > os.path.getmtime(stamp)):
+    print("Packing images from %s" % src)
+    subprocess.check_call(command)
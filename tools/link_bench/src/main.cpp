@@ -0,0 +1,102 @@
+/*********
+  EC Telemetry Link - Security cost benchmark (host)
+  Times LinkCrypto seal/open per frame with the software AES path the
+  STM32 receiver uses, and shows how much airtime the sequence number and
+  tag add at the link's spreading factors.
+*********/
+
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include <LinkCrypto.h>
+#include <LoRaAirtime.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_TSC 1
+#else
+#define HAVE_TSC 0
+#endif
+
+static const int ITERATIONS = 20000;
+static const size_t FRAME_SIZES[] = { 16, 64, 128, 230 };  // 230 = full JSON sample
+
+static uint64_t cycleCount() {
+#if HAVE_TSC
+  return __rdtsc();
+#else
+  return 0;
+#endif
+}
+
+static void benchFrameSize(size_t length) {
+  const uint8_t key[LINK_KEY_SIZE] = { LINK_KEY_BYTES };
+  uint8_t payload[LINK_SECURE_MAX_PAYLOAD];
+  uint8_t frames[2][LINK_SECURE_MAX_FRAME];
+  uint8_t plain[LINK_SECURE_MAX_PAYLOAD];
+  for (size_t i = 0; i < length; i++) payload[i] = (uint8_t)(i * 7);
+
+  LinkSealer sealer;
+  LinkOpener opener;
+  sealer.begin(key, 0);
+  opener.begin(key);
+
+  size_t frameLength = 0;
+  uint64_t sealTicks = 0;
+  uint64_t openTicks = 0;
+  auto sealTime = std::chrono::nanoseconds(0);
+  auto openTime = std::chrono::nanoseconds(0);
+
+  for (int i = 0; i < ITERATIONS; i++) {
+    uint8_t* frame = frames[i & 1];
+
+    auto t0 = std::chrono::steady_clock::now();
+    uint64_t c0 = cycleCount();
+    frameLength = sealer.seal(payload, length, frame);
+    uint64_t c1 = cycleCount();
+    auto t1 = std::chrono::steady_clock::now();
+    size_t opened = opener.open(frame, frameLength, plain);
+    uint64_t c2 = cycleCount();
+    auto t2 = std::chrono::steady_clock::now();
+
+    if (opened != length || memcmp(plain, payload, length) != 0) {
+      printf("round trip failed at frame %d\n", i);
+      return;
+    }
+    sealTicks += c1 - c0;
+    openTicks += c2 - c1;
+    sealTime += t1 - t0;
+    openTime += t2 - t1;
+  }
+
+  printf("%7zu B | seal %8.0f ns %8llu cyc | open %8.0f ns %8llu cyc\n", length,
+         (double)sealTime.count() / ITERATIONS, (unsigned long long)(sealTicks / ITERATIONS),
+         (double)openTime.count() / ITERATIONS, (unsigned long long)(openTicks / ITERATIONS));
+}
+
+static void airtimeOverhead(uint8_t spreadingFactor) {
+  LoRaRadioConfig config = { spreadingFactor, 125000, 5, 8, false, false };
+  printf("  SF%-2u |", spreadingFactor);
+  for (size_t i = 0; i < sizeof(FRAME_SIZES) / sizeof(FRAME_SIZES[0]); i++) {
+    uint32_t plainUs = loraTimeOnAirUs(config, FRAME_SIZES[i]);
+    uint32_t sealedUs = loraTimeOnAirUs(config, FRAME_SIZES[i] + LINK_SECURE_OVERHEAD);
+    printf(" %3zu B: +%6.2f ms (%4.1f%%) |", FRAME_SIZES[i], (sealedUs - plainUs) / 1000.0,
+           (sealedUs - plainUs) * 100.0 / plainUs);
+  }
+  printf("\n");
+}
+
+int main() {
+  printf("LinkCrypto: AES-128-CTR + %d-bit CMAC, %d bytes per frame (%s AES)\n",
+         LINK_TAG_SIZE * 8, LINK_SECURE_OVERHEAD, LINK_AES_HW ? "hardware" : "software");
+  printf("Per-frame cost over %d frames%s:\n", ITERATIONS, HAVE_TSC ? "" : " (no cycle counter)");
+  for (size_t i = 0; i < sizeof(FRAME_SIZES) / sizeof(FRAME_SIZES[0]); i++) {
+    benchFrameSize(FRAME_SIZES[i]);
+  }
+
+  printf("\nAirtime added by sequence number and tag (BW 125 kHz, CR 4/5):\n");
+  airtimeOverhead(7);
+  airtimeOverhead(9);
+  airtimeOverhead(12);
+  return 0;
+}
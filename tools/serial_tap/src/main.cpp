@@ -0,0 +1,250 @@
+/*
+ * AKS Data Generator - serial stream tap
+ * Reads the generator's binary stream (SERIAL_OUTPUT_BINARY) from a serial
+ * port or a raw capture file, checks every frame and writes the telemetry
+ * as an AksDataset file (one vehicle, length open ended) or CSV.
+ *
+ * Boot text and anything else between frames is skipped. Lost frames show
+ * up as sequence gaps; the device's own count of frames it had no UART
+ * room for arrives in the info frame once a second.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <termios.h>
+#include <chrono>
+#include <AksDataset.h>
+#include <AksStream.h>
+
+struct Options {
+    const char *port = NULL;      // serial device, or
+    const char *in = NULL;        // raw capture file, - for stdin
+    unsigned baud = 921600;
+    bool csv = false;
+    const char *out = "capture.bin";
+    uint32_t maxSamples = 0;      // 0 = until EOF or Ctrl-C
+    uint32_t durationS = 0;       // 0 = no limit
+};
+
+static volatile sig_atomic_t stopRequested = 0;
+
+static void onSignal(int) {
+    stopRequested = 1;
+}
+
+static void usage() {
+    fprintf(stderr,
+        "usage: serial_tap (--port DEV | --in FILE) [options]\n"
+        "  --port DEV       serial device, e.g. /dev/ttyACM0\n"
+        "  --baud B         serial speed (default 921600)\n"
+        "  --in FILE        raw stream capture instead of a port, - for stdin\n"
+        "  --format F       bin|csv (default bin)\n"
+        "  --out PATH       output file, - for stdout (default capture.bin)\n"
+        "  --samples N      stop after N telemetry samples\n"
+        "  --duration S     stop after S seconds of wall time\n");
+}
+
+static bool parseOptions(int argc, char **argv, Options &opt) {
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *value = i + 1 < argc ? argv[i + 1] : NULL;
+        if (!value) return false;
+        i++;
+        if (!strcmp(arg, "--port")) opt.port = value;
+        else if (!strcmp(arg, "--baud")) opt.baud = strtoul(value, NULL, 0);
+        else if (!strcmp(arg, "--in")) opt.in = value;
+        else if (!strcmp(arg, "--out")) opt.out = value;
+        else if (!strcmp(arg, "--samples")) opt.maxSamples = strtoul(value, NULL, 0);
+        else if (!strcmp(arg, "--duration")) opt.durationS = strtoul(value, NULL, 0);
+        else if (!strcmp(arg, "--format")) {
+            if (!strcmp(value, "csv")) opt.csv = true;
+            else if (strcmp(value, "bin")) return false;
+        }
+        else return false;
+    }
+    // Exactly one source
+    return (opt.port != NULL) != (opt.in != NULL);
+}
+
+static speed_t baudConstant(unsigned baud) {
+    static const struct { unsigned baud; speed_t speed; } SPEEDS[] = {
+        { 115200, B115200 }, { 230400, B230400 }, { 460800, B460800 },
+        { 921600, B921600 }, { 1000000, B1000000 }, { 2000000, B2000000 },
+    };
+    for (const auto &s : SPEEDS) {
+        if (s.baud == baud) return s.speed;
+    }
+    return 0;
+}
+
+// Opens the port raw (8N1, no flow control, no line editing)
+static int openPort(const char *path, unsigned baud) {
+    speed_t speed = baudConstant(baud);
+    if (!speed) {
+        fprintf(stderr, "unsupported baud rate %u\n", baud);
+        return -1;
+    }
+    int fd = open(path, O_RDONLY | O_NOCTTY);
+    if (fd < 0) {
+        perror(path);
+        return -1;
+    }
+    struct termios tio;
+    if (tcgetattr(fd, &tio) != 0) {
+        perror(path);
+        close(fd);
+        return -1;
+    }
+    cfmakeraw(&tio);
+    tio.c_cflag |= CLOCAL | CREAD;
+    tio.c_cflag &= ~CRTSCTS;
+    tio.c_cc[VMIN] = 0;
+    tio.c_cc[VTIME] = 2;          // read() returns after 0.2 s of silence
+    cfsetispeed(&tio, speed);
+    cfsetospeed(&tio, speed);
+    if (tcsetattr(fd, TCSANOW, &tio) != 0) {
+        perror(path);
+        close(fd);
+        return -1;
+    }
+    tcflush(fd, TCIFLUSH);
+    return fd;
+}
+
+static void writeCsv(FILE *file, const AKS_TelemetryData &s) {
+    fprintf(file, "0,%u,%.2f,%.2f,%.2f,%.0f,%.2f,%.2f,%u,%u\n",
+            s.timestamp_ms, s.vehicle_speed_kmh, s.battery_temp_C,
+            s.battery_voltage_V, s.remaining_energy_Wh, s.motor_temp_C,
+            s.brake_pressure_bar, s.system_status, s.fault_codes);
+}
+
+static void fillHeader(AksDatasetHeader &header, const AksStreamInfo *info) {
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, AKS_DATASET_MAGIC, 4);
+    header.version = AKS_DATASET_VERSION;
+    header.record_size = sizeof(AksDatasetRecord);
+    header.vehicles = 1;
+    header.samples_per_vehicle = 0;   // stream, read to EOF
+    if (info) {
+        header.sample_interval_ms = info->sample_interval_ms;
+        header.seed = info->seed;
+        header.simulation_mode = info->simulation_mode;
+    }
+}
+
+int main(int argc, char **argv) {
+    Options opt;
+    if (!parseOptions(argc, argv, opt)) {
+        usage();
+        return 2;
+    }
+
+    int fd;
+    if (opt.port) fd = openPort(opt.port, opt.baud);
+    else if (!strcmp(opt.in, "-")) fd = STDIN_FILENO;
+    else if ((fd = open(opt.in, O_RDONLY)) < 0) perror(opt.in);
+    if (fd < 0) return 1;
+
+    FILE *file = strcmp(opt.out, "-") == 0 ? stdout : fopen(opt.out, "wb");
+    if (!file) {
+        perror(opt.out);
+        return 1;
+    }
+    static char fileBuffer[1 << 16];
+    setvbuf(file, fileBuffer, _IOFBF, sizeof(fileBuffer));
+
+    // The header is rewritten at the end once the info frame has told us
+    // the seed and mode, if the output is seekable
+    AksDatasetHeader header;
+    if (opt.csv) {
+        fputs("vehicle,timestamp_ms,speed_kmh,battery_temp_C,battery_voltage_V,"
+              "remaining_energy_Wh,motor_temp_C,brake_pressure_bar,system_status,fault_codes\n", file);
+    } else {
+        fillHeader(header, NULL);
+        fwrite(&header, sizeof(header), 1, file);
+    }
+
+    signal(SIGINT, onSignal);
+    signal(SIGTERM, onSignal);
+
+    AksStreamDecoder decoder;
+    AksStreamInfo info = {};
+    bool haveInfo = false;
+    bool haveSeq = false;
+    uint8_t expectedSeq = 0;
+    uint64_t samples = 0;
+    uint64_t lostFrames = 0;
+    uint64_t bytesRead = 0;
+    bool writeFailed = false;
+
+    auto start = std::chrono::steady_clock::now();
+    uint8_t buffer[4096];
+    while (!stopRequested) {
+        if (opt.durationS && std::chrono::steady_clock::now() - start >= std::chrono::seconds(opt.durationS)) break;
+        ssize_t n = read(fd, buffer, sizeof(buffer));
+        if (n < 0) {
+            if (stopRequested) break;
+            perror("read");
+            break;
+        }
+        if (n == 0) {
+            if (opt.port) continue;   // read timeout, keep listening
+            break;                    // end of capture
+        }
+        bytesRead += n;
+
+        for (ssize_t i = 0; i < n; i++) {
+            if (!decoder.push(buffer[i])) continue;
+
+            if (haveSeq) lostFrames += (uint8_t)(decoder.seq() - expectedSeq);
+            expectedSeq = decoder.seq() + 1;
+            haveSeq = true;
+
+            if (decoder.type() == AKS_STREAM_INFO && decoder.payloadLength() == sizeof(info)) {
+                memcpy(&info, decoder.payload(), sizeof(info));
+                haveInfo = true;
+            } else if (decoder.type() == AKS_STREAM_TELEMETRY &&
+                       decoder.payloadLength() == sizeof(AKS_TelemetryData)) {
+                AksDatasetRecord record;
+                record.vehicle = 0;
+                memcpy(&record.sample, decoder.payload(), sizeof(record.sample));
+                if (opt.csv) {
+                    writeCsv(file, record.sample);
+                } else if (fwrite(&record, sizeof(record), 1, file) != 1) {
+                    writeFailed = true;
+                }
+                samples++;
+            }
+        }
+        if (writeFailed || (opt.maxSamples && samples >= opt.maxSamples)) break;
+    }
+
+    if (!opt.csv && haveInfo && file != stdout) {
+        fillHeader(header, &info);
+        if (fseek(file, 0, SEEK_SET) == 0) fwrite(&header, sizeof(header), 1, file);
+    }
+    if (fflush(file) != 0) writeFailed = true;
+    if (file != stdout) fclose(file);
+    if (fd != STDIN_FILENO) close(fd);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (writeFailed) {
+        fprintf(stderr, "write to %s failed\n", opt.out);
+        return 1;
+    }
+    fprintf(stderr, "%llu bytes, %u frames, %llu samples, %.1f s, %.0f samples/s\n",
+            (unsigned long long)bytesRead, decoder.frames, (unsigned long long)samples,
+            seconds, seconds > 0 ? samples / seconds : 0.0);
+    fprintf(stderr, "lost %llu frames (%u dropped on the device), %u CRC errors, %u junk runs\n",
+            (unsigned long long)lostFrames, haveInfo ? info.dropped_frames : 0,
+            decoder.crcErrors, decoder.junk);
+    if (haveInfo) {
+        fprintf(stderr, "seed 0x%08X, mode %u, %u ms per sample, time x%u\n",
+                info.seed, info.simulation_mode, info.sample_interval_ms, info.time_scale);
+    }
+    return 0;
+}
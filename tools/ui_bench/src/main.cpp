@@ -0,0 +1,414 @@
+/*
+ * AKS Screen - headless render benchmark
+ * Runs the SquareLine dashboard (AKS_SCREEN/temp_ui) on the host against a
+ * memory frame buffer (AKS_SCREEN's MemoryBackend, the display backend
+ * interface the panels use). The tick is simulated: every step advances it by one
+ * display refresh period, so animations land on the same positions in every
+ * run and snapshots can be diffed pixel for pixel.
+ *
+ * The dashboard is driven through its own event handlers (tab buttons,
+ * settings, volume) and after each step the tool reports:
+ *
+ *   render   wall time LVGL spent rendering a frame (draw plus flush into
+ *            the memory frame buffer), average and worst case
+ *   area     pixels redrawn per frame, as a share of the screen
+ *   full     one forced redraw of the whole screen
+ *   heap     LVGL heap in use and its peak (LV_MEM_SIZE is the budget)
+ *
+ * Host times do not match the ESP32-S3, but they move with it: a change
+ * that doubles the redrawn area or adds a costly style shows up here
+ * first. --budget-ms turns the worst frame into a pass/fail check.
+ * --lines 0 renders straight into the frame in LVGL direct mode, as the
+ * RGB panel profile does with the panel's PSRAM frame (DISP_BUF_PANEL).
+ *
+ * The native_packed environment draws the images packed by tools/img_pack
+ * and adds a table of flash size, decode time, cache hits and prefetches
+ * per image.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <sys/stat.h>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <lvgl.h>
+#include <ui.h>
+#include <MemoryBackend.h>
+#if AKS_IMG_PACK
+#include <ImagePack.h>
+#endif
+
+struct Options {
+    uint16_t width = 800;         // resolution the dashboard was designed for
+    uint16_t height = 480;
+    uint16_t lines = 10;          // draw buffer height, as on the device; 0 = direct mode
+    uint32_t frames = 120;        // refresh periods per step
+    const char *snapshots = NULL; // PNG output directory
+    const char *csv = NULL;       // per-frame log
+    double budgetMs = 0;          // 0 = no limit
+    uint32_t imgCacheBytes = 2 * 1024 * 1024;   // native_packed only
+};
+
+struct FrameRecord {
+    uint32_t step;
+    uint32_t frame;
+    uint32_t renderUs;
+    uint32_t pixels;
+};
+
+struct Step {
+    const char *name;
+    lv_obj_t **target;            // clicked at the start of the step, or NULL
+};
+
+// The dashboard's own navigation, in the order a rider would use it
+static const Step STEPS[] = {
+    { "home", NULL },
+    { "battery", &ui_BTN_BG2 },
+    { "map", &ui_BTN_BG3 },
+    { "driving", &ui_BTN_BG1 },
+    { "settings", &ui_BTN_Settings },
+    { "volume_off", &ui_Volume_Off },
+    { "volume_on", &ui_Volum_On },
+    { "back_home", &ui_BTN_Settings1 },
+};
+
+static MemoryBackend *panel;
+
+// Filled by the display driver callbacks for the frame in progress
+static std::chrono::steady_clock::time_point renderStart;
+static uint32_t frameRenderUs;
+static uint32_t framePixels;
+static bool frameDone;
+
+static void usage() {
+    fprintf(stderr,
+        "usage: ui_bench [options]\n"
+        "  --width W        horizontal resolution (default 800)\n"
+        "  --height H       vertical resolution (default 480)\n"
+        "  --lines N        draw buffer lines (default 10), 0 renders into the frame\n"
+        "  --frames N       refresh periods per step (default 120)\n"
+        "  --snapshots DIR  write a PNG of every step to DIR\n"
+        "  --csv PATH       per-frame render time and area\n"
+        "  --budget-ms X    fail if any frame renders slower than X ms\n"
+        "  --img-cache B    decoded image cache in bytes (native_packed, default 2 MB)\n");
+}
+
+static bool parseOptions(int argc, char **argv, Options &opt) {
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *value = i + 1 < argc ? argv[i + 1] : NULL;
+        if (!value) return false;
+        i++;
+        if (!strcmp(arg, "--width")) opt.width = strtoul(value, NULL, 0);
+        else if (!strcmp(arg, "--height")) opt.height = strtoul(value, NULL, 0);
+        else if (!strcmp(arg, "--lines")) opt.lines = strtoul(value, NULL, 0);
+        else if (!strcmp(arg, "--frames")) opt.frames = strtoul(value, NULL, 0);
+        else if (!strcmp(arg, "--snapshots")) opt.snapshots = value;
+        else if (!strcmp(arg, "--csv")) opt.csv = value;
+        else if (!strcmp(arg, "--budget-ms")) opt.budgetMs = strtod(value, NULL);
+        else if (!strcmp(arg, "--img-cache")) opt.imgCacheBytes = strtoul(value, NULL, 0);
+        else return false;
+    }
+    return opt.width > 0 && opt.height > 0 && opt.lines <= opt.height;
+}
+
+// ---------------------------------------------------------------------------
+// PNG writer: 8-bit RGB, zlib stream of stored (uncompressed) deflate blocks.
+// Larger than a compressed PNG but needs no zlib and is byte-identical for
+// identical frames.
+
+static uint32_t crcTable[256];
+
+static void crcInit() {
+    for (uint32_t n = 0; n < 256; n++) {
+        uint32_t c = n;
+        for (int k = 0; k < 8; k++) c = c & 1 ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+        crcTable[n] = c;
+    }
+}
+
+static uint32_t crc32(uint32_t crc, const uint8_t *data, size_t length) {
+    crc = ~crc;
+    while (length--) crc = crcTable[(crc ^ *data++) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
+
+static void putBe32(std::vector<uint8_t> &out, uint32_t v) {
+    out.push_back(v >> 24);
+    out.push_back(v >> 16);
+    out.push_back(v >> 8);
+    out.push_back(v);
+}
+
+static void putChunk(std::vector<uint8_t> &out, const char *type, const std::vector<uint8_t> &data) {
+    putBe32(out, data.size());
+    size_t start = out.size();
+    out.insert(out.end(), type, type + 4);
+    out.insert(out.end(), data.begin(), data.end());
+    putBe32(out, crc32(0, &out[start], out.size() - start));
+}
+
+static bool writePng(const char *path, const lv_color_t *pixels, uint16_t width, uint16_t height) {
+    // Raw scanlines: filter byte 0, then RGB
+    std::vector<uint8_t> raw;
+    raw.reserve((size_t)height * (width * 3 + 1));
+    for (uint32_t y = 0; y < height; y++) {
+        raw.push_back(0);
+        for (uint32_t x = 0; x < width; x++) {
+            uint16_t c = pixels[y * width + x].full;   // RGB565
+            raw.push_back(((c >> 11) & 0x1F) * 255 / 31);
+            raw.push_back(((c >> 5) & 0x3F) * 255 / 63);
+            raw.push_back((c & 0x1F) * 255 / 31);
+        }
+    }
+
+    std::vector<uint8_t> zlib = { 0x78, 0x01 };
+    uint32_t a = 1, b = 0;
+    for (uint8_t byte : raw) {
+        a = (a + byte) % 65521;
+        b = (b + a) % 65521;
+    }
+    for (size_t pos = 0; pos < raw.size(); ) {
+        uint16_t n = raw.size() - pos > 65535 ? 65535 : raw.size() - pos;
+        zlib.push_back(pos + n == raw.size() ? 1 : 0);   // BFINAL, BTYPE 00
+        zlib.push_back(n & 0xFF);
+        zlib.push_back(n >> 8);
+        zlib.push_back(~n & 0xFF);
+        zlib.push_back((~n >> 8) & 0xFF);
+        zlib.insert(zlib.end(), raw.begin() + pos, raw.begin() + pos + n);
+        pos += n;
+    }
+    putBe32(zlib, (b << 16) | a);
+
+    std::vector<uint8_t> ihdr;
+    putBe32(ihdr, width);
+    putBe32(ihdr, height);
+    ihdr.insert(ihdr.end(), { 8, 2, 0, 0, 0 });       // 8-bit RGB, no interlace
+
+    std::vector<uint8_t> png = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    putChunk(png, "IHDR", ihdr);
+    putChunk(png, "IDAT", zlib);
+    putChunk(png, "IEND", {});
+
+    FILE *file = fopen(path, "wb");
+    if (!file) {
+        perror(path);
+        return false;
+    }
+    bool ok = fwrite(png.data(), 1, png.size(), file) == png.size();
+    if (fclose(file) != 0) ok = false;
+    return ok;
+}
+
+// ---------------------------------------------------------------------------
+// Display driver: renders into draw buffer stripes like the device and
+// hands each flushed area to the memory backend, or renders in place
+
+static void renderStartCb(lv_disp_drv_t *) {
+    renderStart = std::chrono::steady_clock::now();
+}
+
+static void flushCb(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *color_p) {
+    uint32_t w = area->x2 - area->x1 + 1;
+    uint32_t h = area->y2 - area->y1 + 1;
+    if (drv->direct_mode) {
+        panel->flush(area->x1, area->y1, w, h, &color_p[(uint32_t)area->y1 * drv->hor_res + area->x1], drv->hor_res);
+    } else {
+        panel->flush(area->x1, area->y1, w, h, color_p, w);
+    }
+    lv_disp_flush_ready(drv);
+}
+
+// Called once per refresh that redrew something, after the last flush
+static void monitorCb(lv_disp_drv_t *, uint32_t, uint32_t px) {
+    auto elapsed = std::chrono::steady_clock::now() - renderStart;
+    frameRenderUs = std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+    framePixels = px;
+    frameDone = true;
+}
+
+// One refresh period of simulated time; true if a frame was rendered
+static bool tick() {
+    frameDone = false;
+    lv_tick_inc(LV_DISP_DEF_REFR_PERIOD);
+    lv_timer_handler();
+#if AKS_IMG_PACK
+    imgPackPrefetchPoll();     // as the firmware's loop() does between frames
+#endif
+    return frameDone;
+}
+
+#if AKS_IMG_PACK
+static void printImagePackStats(size_t cacheBytes) {
+    printf("\n%-20s %8s %8s %6s %6s %8s %10s %8s\n", "image", "raw", "flash", "hits", "misses", "prefetch",
+           "decode ms", "rows");
+    uint32_t raw = 0, flash = 0;
+    for (uint16_t i = 0; i < img_pack_asset_count; i++) {
+        const img_pack_asset_t &asset = img_pack_assets[i];
+        raw += asset.raw_size;
+        flash += asset.img->data_size;
+        if (!imgPackIsPacked(asset.img)) {
+            printf("%-20s %8u %8u   (not packed)\n", asset.name, asset.raw_size, asset.img->data_size);
+            continue;
+        }
+        const ImagePackStats *s = imgPackStats(i);
+        uint32_t decodes = s->misses + s->prefetches;
+        printf("%-20s %8u %8u %6u %6u %8u %10.3f %8u\n", asset.name, asset.raw_size, asset.img->data_size,
+               s->hits, s->misses, s->prefetches, decodes ? s->decodeUs / 1000.0 / decodes : 0.0, s->rowDecodes);
+    }
+    printf("%-20s %8u %8u\nimage cache peak %zu of %zu bytes\n", "total", raw, flash,
+           imgPackCachePeak(), cacheBytes);
+}
+#endif
+
+static uint32_t heapUsed(uint32_t *peak) {
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+    if (peak) *peak = mon.max_used;
+    return mon.total_size - mon.free_size;
+}
+
+int main(int argc, char **argv) {
+    Options opt;
+    if (!parseOptions(argc, argv, opt)) {
+        usage();
+        return 2;
+    }
+    crcInit();
+
+    if (opt.snapshots && mkdir(opt.snapshots, 0755) != 0 && errno != EEXIST) {
+        perror(opt.snapshots);
+        return 1;
+    }
+
+    FILE *csv = NULL;
+    if (opt.csv) {
+        csv = fopen(opt.csv, "w");
+        if (!csv) {
+            perror(opt.csv);
+            return 1;
+        }
+        fputs("step,frame,render_us,pixels\n", csv);
+    }
+
+    const uint16_t hor = opt.width;
+    const uint16_t ver = opt.height;
+    MemoryBackend memory(hor, ver);
+    if (!memory.begin()) {
+        fprintf(stderr, "no memory for a %ux%u frame\n", hor, ver);
+        return 1;
+    }
+    panel = &memory;
+    std::vector<lv_color_t> drawBuffer((size_t)hor * opt.lines);
+
+    lv_init();
+    static lv_disp_draw_buf_t drawBuf;
+    static lv_disp_drv_t drv;
+    lv_disp_drv_init(&drv);
+    if (opt.lines) {
+        lv_disp_draw_buf_init(&drawBuf, drawBuffer.data(), NULL, drawBuffer.size());
+    } else {
+        bool psram;
+        lv_disp_draw_buf_init(&drawBuf, memory.frameBuffer(psram), NULL, (uint32_t)hor * ver);
+        drv.direct_mode = 1;
+    }
+    drv.hor_res = hor;
+    drv.ver_res = ver;
+    drv.flush_cb = flushCb;
+    drv.render_start_cb = renderStartCb;
+    drv.monitor_cb = monitorCb;
+    drv.draw_buf = &drawBuf;
+    lv_disp_drv_register(&drv);
+
+#if AKS_IMG_PACK
+    imgPackInit(opt.imgCacheBytes);
+#endif
+    auto initStart = std::chrono::steady_clock::now();
+    ui_init();
+#if AKS_IMG_PACK
+    imgPackWatchScreens();
+#endif
+    double initMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - initStart).count();
+    uint32_t heapPeak;
+    uint32_t heapAfterInit = heapUsed(&heapPeak);
+    printf("ui_init %.2f ms, heap %u / %u bytes after init\n", initMs, heapAfterInit, (unsigned)LV_MEM_SIZE);
+    if (opt.lines) {
+        printf("%ux%u, %u-line draw buffer", hor, ver, opt.lines);
+    } else {
+        printf("%ux%u, direct mode into the frame", hor, ver);
+    }
+    printf(", %u frames per step, %u ms per frame\n\n", opt.frames, (unsigned)LV_DISP_DEF_REFR_PERIOD);
+    printf("%-11s %6s %9s %9s %8s %9s %10s\n",
+           "step", "frames", "avg ms", "max ms", "area %", "full ms", "heap peak");
+
+    const double screenPixels = (double)hor * ver;
+    double worstMs = 0;
+    const char *worstStep = "";
+    bool snapshotsOk = true;
+    std::vector<FrameRecord> records;
+
+    for (uint32_t s = 0; s < sizeof(STEPS) / sizeof(STEPS[0]); s++) {
+        const Step &step = STEPS[s];
+        if (step.target) lv_event_send(*step.target, LV_EVENT_CLICKED, NULL);
+
+        uint32_t rendered = 0;
+        uint64_t totalUs = 0;
+        uint64_t totalPx = 0;
+        uint32_t maxUs = 0;
+        for (uint32_t f = 0; f < opt.frames; f++) {
+            if (!tick()) continue;
+            rendered++;
+            totalUs += frameRenderUs;
+            totalPx += framePixels;
+            if (frameRenderUs > maxUs) maxUs = frameRenderUs;
+            records.push_back({ s, f, frameRenderUs, framePixels });
+        }
+
+        // Worst case for this state: everything redrawn
+        lv_obj_invalidate(lv_scr_act());
+        tick();
+        uint32_t fullUs = frameRenderUs;
+        heapUsed(&heapPeak);
+
+        if (opt.snapshots) {
+            std::string path = std::string(opt.snapshots) + "/" + (s < 10 ? "0" : "") +
+                               std::to_string(s) + "_" + step.name + ".png";
+            snapshotsOk &= writePng(path.c_str(), memory.pixels(), hor, ver);
+        }
+
+        double avgMs = rendered ? totalUs / 1000.0 / rendered : 0;
+        double areaPct = rendered ? 100.0 * totalPx / rendered / screenPixels : 0;
+        printf("%-11s %6u %9.3f %9.3f %8.1f %9.3f %10u\n",
+               step.name, rendered, avgMs, maxUs / 1000.0, areaPct, fullUs / 1000.0, heapPeak);
+        if (maxUs / 1000.0 > worstMs) {
+            worstMs = maxUs / 1000.0;
+            worstStep = step.name;
+        }
+    }
+
+    if (csv) {
+        for (const FrameRecord &r : records) {
+            fprintf(csv, "%s,%u,%u,%u\n", STEPS[r.step].name, r.frame, r.renderUs, r.pixels);
+        }
+        if (fclose(csv) != 0) {
+            perror(opt.csv);
+            return 1;
+        }
+    }
+
+#if AKS_IMG_PACK
+    printImagePackStats(opt.imgCacheBytes);
+#endif
+    printf("\nworst frame %.3f ms (%s), heap peak %u of %u bytes\n",
+           worstMs, worstStep, heapPeak, (unsigned)LV_MEM_SIZE);
+    if (!snapshotsOk) return 1;
+    if (opt.budgetMs > 0 && worstMs > opt.budgetMs) {
+        printf("FAIL: worst frame over the %.3f ms budget\n", opt.budgetMs);
+        return 1;
+    }
+    return 0;
+}